@@ -114,6 +114,24 @@ struct NVGpathCache {
 };
 typedef struct NVGpathCache NVGpathCache;
 
+struct NVGcachedGeometry {
+	NVGpath* paths;
+	int npaths;
+	NVGvertex* verts;
+	int nverts;
+	float bounds[4];
+};
+typedef struct NVGcachedGeometry NVGcachedGeometry;
+
+struct NVGgeometryCache {
+	NVGcachedGeometry* entries;
+	int nentries;
+	int centries;
+	int complete;
+	int current;
+	float xform[6];
+};
+
 struct NVGcontext {
 	NVGparams params;
 	float* commands;
@@ -123,6 +141,7 @@ struct NVGcontext {
 	NVGstate states[NVG_MAX_STATES];
 	int nstates;
 	NVGpathCache* cache;
+	NVGgeometryCache* geometryCache;
 	NVGclipPath* clipPaths;
 	NVGclipPath* lastClip;
 	float tessTol;
@@ -1383,11 +1402,20 @@ static float nvg__distPtSeg(float x, float y, float px, float py, float qx, floa
 	return dx*dx + dy*dy;
 }
 
+static int nvg__replayingGeometry(NVGcontext* ctx)
+{
+	return ctx->geometryCache != NULL && ctx->geometryCache->complete;
+}
+
 static void nvg__appendCommands(NVGcontext* ctx, float* vals, int nvals)
 {
 	NVGstate* state = nvg__getState(ctx);
 	int i;
 
+	// the recorded geometry is used instead of the path
+	if (nvg__replayingGeometry(ctx))
+		return;
+
 	if (ctx->ncommands+nvals > ctx->ccommands) {
 		float* commands;
 		int ccommands = ctx->ncommands+nvals + ctx->ccommands/2;
@@ -2561,23 +2589,195 @@ static const NVGpath* nvg__findClipPath(const NVGpath* paths, int npaths)
 	return (i < npaths) ? clipPath : NULL;
 }
 
+NVGgeometryCache* nvgCreateGeometryCache(void)
+{
+	NVGgeometryCache* cache = (NVGgeometryCache*)malloc(sizeof(NVGgeometryCache));
+	if (cache == NULL) return NULL;
+	memset(cache, 0, sizeof(NVGgeometryCache));
+	nvgTransformIdentity(cache->xform);
+	return cache;
+}
+
+void nvgDeleteGeometryCache(NVGgeometryCache* cache)
+{
+	int i;
+	if (cache == NULL) return;
+	for (i = 0; i < cache->nentries; i++) {
+		free(cache->entries[i].paths);
+		free(cache->entries[i].verts);
+	}
+	free(cache->entries);
+	free(cache);
+}
+
+int nvgGeometryCacheComplete(NVGgeometryCache* cache)
+{
+	return cache != NULL && cache->complete;
+}
+
+void nvgBeginGeometryCache(NVGcontext* ctx, NVGgeometryCache* cache, const float* xform)
+{
+	ctx->geometryCache = cache;
+	if (cache == NULL) return;
+	cache->current = 0;
+	memcpy(cache->xform, xform, sizeof(float)*6);
+}
+
+void nvgEndGeometryCache(NVGcontext* ctx)
+{
+	if (ctx->geometryCache != NULL)
+		ctx->geometryCache->complete = 1;
+	ctx->geometryCache = NULL;
+}
+
+// Stores the tessellated paths of the path cache as the next entry of the geometry cache.
+static void nvg__recordGeometry(NVGcontext* ctx)
+{
+	NVGgeometryCache* gcache = ctx->geometryCache;
+	NVGpathCache* cache = ctx->cache;
+	NVGcachedGeometry* entry;
+	int i, nverts = 0;
+
+	if (gcache->nentries+1 > gcache->centries) {
+		NVGcachedGeometry* entries;
+		int centries = gcache->nentries+1 + gcache->centries/2;
+		entries = (NVGcachedGeometry*)realloc(gcache->entries, sizeof(NVGcachedGeometry)*centries);
+		if (entries == NULL) return;
+		gcache->entries = entries;
+		gcache->centries = centries;
+	}
+	entry = &gcache->entries[gcache->nentries];
+	memset(entry, 0, sizeof(NVGcachedGeometry));
+	for (i = 0; i < cache->npaths; i++) {
+		const NVGpath* path = &cache->paths[i];
+		if (path->fill != NULL)
+			nverts = nvg__maxi(nverts, (int)(path->fill - cache->verts) + path->nfill);
+		if (path->stroke != NULL)
+			nverts = nvg__maxi(nverts, (int)(path->stroke - cache->verts) + path->nstroke);
+	}
+	if (cache->npaths > 0) {
+		entry->paths = (NVGpath*)malloc(sizeof(NVGpath)*cache->npaths);
+		if (entry->paths == NULL) return;
+	}
+	if (nverts > 0) {
+		entry->verts = (NVGvertex*)malloc(sizeof(NVGvertex)*nverts);
+		if (entry->verts == NULL) {
+			free(entry->paths);
+			return;
+		}
+		memcpy(entry->verts, cache->verts, sizeof(NVGvertex)*nverts);
+	}
+	// vertex pointers are stored relative to the start of the vertex array
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* path = &entry->paths[i];
+		*path = cache->paths[i];
+		if (path->fill != NULL) path->fill = entry->verts + (path->fill - cache->verts);
+		if (path->stroke != NULL) path->stroke = entry->verts + (path->stroke - cache->verts);
+	}
+	entry->npaths = cache->npaths;
+	entry->nverts = nverts;
+	memcpy(entry->bounds, cache->bounds, sizeof(float)*4);
+	gcache->nentries++;
+}
+
+// Restores the next recorded entry of the geometry cache into the path cache.
+static int nvg__restoreGeometry(NVGcontext* ctx)
+{
+	NVGgeometryCache* gcache = ctx->geometryCache;
+	NVGpathCache* cache = ctx->cache;
+	const NVGcachedGeometry* entry;
+	NVGvertex* verts;
+	int i;
+
+	if (gcache->current >= gcache->nentries) return 0;
+	entry = &gcache->entries[gcache->current++];
+	if (entry->npaths > cache->cpaths) {
+		NVGpath* paths = (NVGpath*)realloc(cache->paths, sizeof(NVGpath)*entry->npaths);
+		if (paths == NULL) return 0;
+		cache->paths = paths;
+		cache->cpaths = entry->npaths;
+	}
+	verts = nvg__allocTempVerts(ctx, entry->nverts);
+	if (verts == NULL && entry->nverts > 0) return 0;
+	if (entry->nverts > 0)
+		memcpy(verts, entry->verts, sizeof(NVGvertex)*entry->nverts);
+	for (i = 0; i < entry->npaths; i++) {
+		NVGpath* path = &cache->paths[i];
+		*path = entry->paths[i];
+		if (path->fill != NULL) path->fill = verts + (path->fill - entry->verts);
+		if (path->stroke != NULL) path->stroke = verts + (path->stroke - entry->verts);
+	}
+	cache->npaths = entry->npaths;
+	cache->npoints = 0;
+	memcpy(cache->bounds, entry->bounds, sizeof(float)*4);
+	return 1;
+}
+
+// Tessellates the current path, or restores it from the geometry cache.
+static int nvg__prepareGeometry(NVGcontext* ctx, int fill, float w, float fringe, int lineCap, int lineJoin, float miterLimit)
+{
+	if (nvg__replayingGeometry(ctx))
+		return nvg__restoreGeometry(ctx);
+	nvg__flattenPaths(ctx);
+	if (fill)
+		nvg__expandFill(ctx, fringe, lineJoin, miterLimit);
+	else
+		nvg__expandStroke(ctx, w, fringe, lineCap, lineJoin, miterLimit);
+	if (ctx->geometryCache != NULL)
+		nvg__recordGeometry(ctx);
+	return 1;
+}
+
+// Applies the geometry transform to the tessellated paths, the paint and the scissor.
+static void nvg__transformGeometry(NVGcontext* ctx, NVGpaint* paint, NVGscissor* scissor)
+{
+	NVGpathCache* cache = ctx->cache;
+	const float* t = ctx->geometryCache->xform;
+	float x[4], y[4];
+	int i, j;
+
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* path = &cache->paths[i];
+		for (j = 0; j < path->nfill; j++)
+			nvgTransformPoint(&path->fill[j].x, &path->fill[j].y, t, path->fill[j].x, path->fill[j].y);
+		for (j = 0; j < path->nstroke; j++)
+			nvgTransformPoint(&path->stroke[j].x, &path->stroke[j].y, t, path->stroke[j].x, path->stroke[j].y);
+	}
+	nvgTransformPoint(&x[0], &y[0], t, cache->bounds[0], cache->bounds[1]);
+	nvgTransformPoint(&x[1], &y[1], t, cache->bounds[2], cache->bounds[1]);
+	nvgTransformPoint(&x[2], &y[2], t, cache->bounds[0], cache->bounds[3]);
+	nvgTransformPoint(&x[3], &y[3], t, cache->bounds[2], cache->bounds[3]);
+	cache->bounds[0] = cache->bounds[2] = x[0];
+	cache->bounds[1] = cache->bounds[3] = y[0];
+	for (i = 1; i < 4; i++) {
+		cache->bounds[0] = nvg__minf(cache->bounds[0], x[i]);
+		cache->bounds[1] = nvg__minf(cache->bounds[1], y[i]);
+		cache->bounds[2] = nvg__maxf(cache->bounds[2], x[i]);
+		cache->bounds[3] = nvg__maxf(cache->bounds[3], y[i]);
+	}
+	nvgTransformMultiply(paint->xform, t);
+	if (scissor->extent[0] >= 0.0f)
+		nvgTransformMultiply(scissor->xform, t);
+}
+
 void nvgFill(NVGcontext* ctx)
 {
 	NVGstate* state = nvg__getState(ctx);
 	const NVGpath* path;
 	NVGpaint fillPaint = state->fill;
+	NVGscissor scissor = state->scissor;
 	int i;
 
-	nvg__flattenPaths(ctx);
-	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
-		nvg__expandFill(ctx, ctx->fringeWidth, NVG_MITER, 2.4f);
-	else
-		nvg__expandFill(ctx, 0.0f, NVG_MITER, 2.4f);
+	if (!nvg__prepareGeometry(ctx, 1, 0.0f, ctx->params.edgeAntiAlias && state->shapeAntiAlias ? ctx->fringeWidth : 0.0f, NVG_BUTT, NVG_MITER, 2.4f))
+		return;
 
 	// Apply global alpha
 	fillPaint.innerColor.a *= state->alpha;
 	fillPaint.outerColor.a *= state->alpha;
 
+	if (ctx->geometryCache != NULL)
+		nvg__transformGeometry(ctx, &fillPaint, &scissor);
+
 	const NVGpath* clipPath = nvg__findClipPath(ctx->cache->paths, ctx->cache->npaths);
 	if (clipPath != NULL) {
 		const NVGpath* clip;
@@ -2586,7 +2786,7 @@ void nvgFill(NVGcontext* ctx)
 	} else {
 		i = 0;
 	}
-	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
+	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, state->compositeOperation, &scissor, ctx->fringeWidth,
 						   ctx->cache->bounds, clipPath, i, ctx->cache->paths, ctx->cache->npaths);
 
 	// Count triangles
@@ -2604,6 +2804,7 @@ void nvgStroke(NVGcontext* ctx)
 	float scale = nvg__getAverageScale(state->xform);
 	float strokeWidth = nvg__clampf(state->strokeWidth * scale, 0.0f, 200.0f);
 	NVGpaint strokePaint = state->stroke;
+	NVGscissor scissor = state->scissor;
 	const NVGpath* path;
 	int i;
 
@@ -2621,12 +2822,9 @@ void nvgStroke(NVGcontext* ctx)
 	strokePaint.innerColor.a *= state->alpha;
 	strokePaint.outerColor.a *= state->alpha;
 
-	nvg__flattenPaths(ctx);
-
-	if (ctx->params.edgeAntiAlias && state->shapeAntiAlias)
-		nvg__expandStroke(ctx, strokeWidth*0.5f, ctx->fringeWidth, state->lineCap, state->lineJoin, state->miterLimit);
-	else
-		nvg__expandStroke(ctx, strokeWidth*0.5f, 0.0f, state->lineCap, state->lineJoin, state->miterLimit);
+	if (!nvg__prepareGeometry(ctx, 0, strokeWidth*0.5f, ctx->params.edgeAntiAlias && state->shapeAntiAlias ? ctx->fringeWidth : 0.0f,
+							  state->lineCap, state->lineJoin, state->miterLimit))
+		return;
 
 	const NVGpath* clipPath = nvg__findClipPath(ctx->cache->paths, ctx->cache->npaths);
 	if (clipPath != NULL) {
@@ -2645,8 +2843,10 @@ void nvgStroke(NVGcontext* ctx)
 		ctx->cache->bounds[2]+=strokeWidth/2.0;
 		ctx->cache->bounds[3]+=strokeWidth/2.0;
 	}
+	if (ctx->geometryCache != NULL)
+		nvg__transformGeometry(ctx, &strokePaint, &scissor);
 
-	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
+	ctx->params.renderStroke(ctx->params.userPtr, &strokePaint, state->compositeOperation, &scissor, ctx->fringeWidth,
 							 strokeWidth, ctx->cache->bounds, clipPath, i, ctx->cache->paths, ctx->cache->npaths);
 
 	// Count triangles
@@ -487,6 +487,34 @@ void nvgEndClip(NVGcontext* ctx);
 // this is reset on every nvgBeginFrame()
 void nvgDeactivateClipping(NVGcontext* ctx);
 
+//
+// Geometry caching
+// Tessellating paths into triangles is done on the CPU for every nvgFill() and nvgStroke() call.
+// A geometry cache records the tessellated paths of a sequence of nvgFill() and nvgStroke() calls,
+// so the same sequence can be rendered again without flattening and expanding the paths.
+// The geometry is recorded in the space of the current transform and is transformed by the
+// geometry transform before it is rendered. Paints and scissors are transformed the same way.
+
+typedef struct NVGgeometryCache NVGgeometryCache;
+
+// Creates an empty geometry cache.
+NVGgeometryCache* nvgCreateGeometryCache(void);
+
+// Deletes a geometry cache.
+void nvgDeleteGeometryCache(NVGgeometryCache* cache);
+
+// Returns 1 if the cache contains the geometry of a complete sequence of nvgFill() and nvgStroke() calls.
+int nvgGeometryCacheComplete(NVGgeometryCache* cache);
+
+// Uses the cache for the following nvgFill() and nvgStroke() calls, xform is the geometry transform.
+// If the cache is complete, the path commands are ignored and the recorded geometry is rendered instead,
+// so the caller has to issue the same sequence of calls that was recorded.
+// Otherwise the tessellated paths are recorded.
+void nvgBeginGeometryCache(NVGcontext* ctx, NVGgeometryCache* cache, const float* xform);
+
+// Stops using the geometry cache, a cache that was recorded is complete afterwards.
+void nvgEndGeometryCache(NVGcontext* ctx);
+
 //
 // Scissoring
 //
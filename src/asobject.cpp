@@ -276,7 +276,7 @@ void ASObject::nextValue(asAtom& ret,uint32_t index)
 	getValueAt(ret,index-1);
 }
 
-void ASObject::AVM1enumerate(std::stack<asAtom>& stack)
+void ASObject::AVM1enumerate(AVM1Stack& stack)
 {
 	// add prototype vars first
 	ASObject* pr = this->getprop_prototype();
@@ -2052,11 +2052,17 @@ bool variables_map::cloneInstance(variables_map &map)
 	if (!cloneable)
 		return false;
 	map.Variables = Variables;
+	// the clone has the same slot layout, so the slot vector is allocated with its final size
+	map.slots_vars.assign(slotcount,nullptr);
+	map.slotcount = slotcount;
 	auto it = map.Variables.begin();
 	while (it !=map.Variables.end())
 	{
+		// the declared traits are not part of the insertion list of the clone
+		it->second.prevVar=nullptr;
+		it->second.nextVar=nullptr;
 		if (it->second.slotid)
-			map.initSlot(it->second.slotid,&(it->second));
+			map.slots_vars[it->second.slotid-1]=&(it->second);
 		it++;
 	}
 	return true;
@@ -2349,13 +2355,13 @@ void ASObject::removeStoredMember()
 	decRef();
 }
 
-bool ASObject::handleGarbageCollection()
+bool ASObject::handleGarbageCollection(garbagecollectorstate& gcstate)
 {
 	if (getConstant() || getCached() || this->getInDestruction())
 		return false;
 	if (storedmembercount && this->canHaveCyclicMemberReference() && ((uint32_t)this->getRefCount() == storedmembercount+1))
 	{
-		garbagecollectorstate gcstate(this);
+		gcstate.reset(this);
 		this->countCylicMemberReferences(gcstate);
 		markedforgarbagecollection=false;
 		if (gcstate.stopped)
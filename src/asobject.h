@@ -591,6 +591,48 @@ public:
 #define ASATOM_REMOVESTOREDMEMBER(a) if (asAtomHandler::isAccessibleObject(a)) { asAtomHandler::getObjectNoCheck(a)->removeStoredMember();}
 #define ASATOM_PREPARESHUTDOWN(a) if (asAtomHandler::isAccessibleObject(a)) { asAtomHandler::getObjectNoCheck(a)->prepareShutdown();}
 
+// contiguous storage for the operand stacks of AVM1 executions, owned by the worker and reused by all executions
+struct AVM1StackArena
+{
+	std::vector<asAtom> values;
+	uint32_t used=0;
+};
+// operand stack of a single AVM1 execution
+// it occupies the arena above the stacks of all currently running (outer) executions and releases its part on destruction
+class AVM1Stack
+{
+private:
+	AVM1StackArena& arena;
+	uint32_t base;
+	uint32_t top;
+public:
+	AVM1Stack(AVM1StackArena& a):arena(a),base(a.used),top(a.used) {}
+	~AVM1Stack()
+	{
+		arena.used=base;
+	}
+	FORCE_INLINE void push(const asAtom& a)
+	{
+		if (top == arena.values.size())
+			arena.values.resize(top < 64 ? 64 : top*2);
+		arena.values[top++]=a;
+		arena.used=top;
+	}
+	FORCE_INLINE asAtom pop()
+	{
+		assert(top > base);
+		arena.used=--top;
+		return arena.values[top];
+	}
+	FORCE_INLINE asAtom& peek()
+	{
+		assert(top > base);
+		return arena.values[top-1];
+	}
+	FORCE_INLINE bool empty() const { return top==base; }
+	FORCE_INLINE size_t size() const { return top-base; }
+};
+
 struct variable
 {
 	asAtom var;
@@ -647,7 +689,8 @@ struct cyclicmembercount
 // struct used to keep track of entries when executing garbage collection
 struct garbagecollectorstate
 {
-	std::map<ASObject*,cyclicmembercount> checkedobjects;
+	// this is kept by the worker and reused for every start object, so the buckets only have to be allocated once
+	std::unordered_map<ASObject*,cyclicmembercount> checkedobjects;
 	ASObject* startobj;
 	bool stopped; // indicates that an object has a member and should be ignored, so we can stop gc for the startobject immediately
 	bool incCount(ASObject* o, bool hasMember);
@@ -655,9 +698,18 @@ struct garbagecollectorstate
 	bool isIgnored(ASObject* o);
 	bool hasMember(ASObject* o);
 	void setAncestor(ASObject* o);
-	garbagecollectorstate(ASObject* _startobj):startobj(_startobj),stopped(false)
+	garbagecollectorstate(ASObject* _startobj=nullptr):startobj(_startobj),stopped(false)
 	{
 	}
+	void reset(ASObject* _startobj)
+	{
+		checkedobjects.clear();
+		// don't keep the buckets of a huge object graph around, as clear() has to touch all of them
+		if (checkedobjects.bucket_count() > 1024)
+			checkedobjects.rehash(0);
+		startobj=_startobj;
+		stopped=false;
+	}
 };
 
 struct varName
@@ -691,6 +743,8 @@ public:
 	mapType Variables;
 	typedef std::unordered_multimap<uint32_t,variable>::iterator var_iterator;
 	typedef std::unordered_multimap<uint32_t,variable>::const_iterator const_var_iterator;
+	// index of the slot traits into Variables, the values of declared traits are stored in the map nodes
+	// for sealed classes as well (there is no separate value array), so a slot access still goes through the node
 	std::vector<variable*> slots_vars;
 	uint32_t slotcount;
 	variable* firstVar;
@@ -885,6 +939,13 @@ public:
 	 */
 	FORCE_INLINE void setSlotNoCoerce(unsigned int n, asAtom o);
 
+	// allocates the slot index for a known number of slots, so it doesn't have to grow while the declared traits are added
+	// this only sizes slots_vars, the variables themselves are still allocated as nodes of Variables
+	FORCE_INLINE void reserveSlots(unsigned int n)
+	{
+		if (n>slots_vars.capacity())
+			slots_vars.reserve(n);
+	}
 	FORCE_INLINE void initSlot(unsigned int n, variable *v)
 	{
 		if (n>slots_vars.capacity())
@@ -1097,7 +1158,9 @@ public:
 	bool removefromGarbageCollection();
 	void addToGarbageCollection();
 	void removeStoredMember();
-	bool handleGarbageCollection();
+	// checks if this object is only kept alive by cyclic references and deletes it if so
+	// the member graph reachable from this object is walked completely, this can't be interrupted
+	bool handleGarbageCollection(garbagecollectorstate& gcstate);
 	virtual bool countCylicMemberReferences(garbagecollectorstate& gcstate);
 	FORCE_INLINE bool canHaveCyclicMemberReference()
 	{
@@ -1287,7 +1350,7 @@ public:
 	void initSlot(unsigned int n, variable *v);
 	
 	void initAdditionalSlots(std::vector<multiname *> &additionalslots);
-	virtual void AVM1enumerate(std::stack<asAtom>& stack);
+	virtual void AVM1enumerate(AVM1Stack& stack);
 	unsigned int numVariables() const;
 	inline uint32_t getNameAt(int i, bool& nameIsInteger)
 	{
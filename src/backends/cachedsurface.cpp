@@ -128,6 +128,7 @@ void nanoVGDeleteImage(int image)
 
 int setNanoVGImage(NVGcontext* nvgctxt,const FILLSTYLE* style)
 {
+	style->decodeBitmap();
 	if (!style->bitmap)
 		return -1;
 	if (style->bitmap->nanoVGImageHandle == -1)
@@ -295,6 +296,56 @@ void nanoVGFillStyle(NVGcontext* nvgctxt, const FILLSTYLE& style, ColorTransform
 	}
 }
 
+// number of scale buckets per doubling of the scale, the tessellation of a bucket is used for scales that differ by at most 9%
+#define TESSELLATION_BUCKETS_PER_OCTAVE 4
+// maximum number of scale buckets cached for one shape
+#define TESSELLATION_MAX_BUCKETS 8
+
+// returns the scale bucket of an axis scale, or INT32_MAX if the scale can't be bucketed
+int32_t tessellationBucket(float scale)
+{
+	if (!std::isfinite(scale) || scale <= 0)
+		return INT32_MAX;
+	int32_t bucket = std::round(std::log2(scale)*TESSELLATION_BUCKETS_PER_OCTAVE);
+	if (bucket < INT16_MIN || bucket > INT16_MAX)
+		return INT32_MAX;
+	return bucket;
+}
+
+/*
+ * returns the geometry cache for the scale buckets of the x and y axis of xform
+ * the axes are bucketed separately, so non-uniformly scaled shapes are tessellated with enough detail along both axes
+ * xform is replaced by the scale of the buckets, and geometryxform is set to the transformation from the bucket space to xform
+ */
+NVGgeometryCache* nanoVGGeometryCache(tessellationCache* tessellation, float* xform, float* geometryxform)
+{
+	if (!tessellation)
+		return nullptr;
+	int32_t bucketx = tessellationBucket(hypotf(xform[0],xform[1]));
+	int32_t buckety = tessellationBucket(hypotf(xform[2],xform[3]));
+	if (bucketx == INT32_MAX || buckety == INT32_MAX)
+		return nullptr;
+	float bucketscalex = std::exp2(float(bucketx)/TESSELLATION_BUCKETS_PER_OCTAVE);
+	float bucketscaley = std::exp2(float(buckety)/TESSELLATION_BUCKETS_PER_OCTAVE);
+	int32_t bucket = int32_t((uint32_t(bucketx)<<16) | (uint32_t(buckety)&0xffff));
+	auto it = tessellation->buckets.find(bucket);
+	if (it == tessellation->buckets.end())
+	{
+		if (tessellation->buckets.size() >= TESSELLATION_MAX_BUCKETS)
+			tessellation->clear();
+		NVGgeometryCache* cache = nvgCreateGeometryCache();
+		if (!cache)
+			return nullptr;
+		it = tessellation->buckets.insert(make_pair(bucket,cache)).first;
+	}
+	float s[6];
+	nvgTransformScale(s,1.0/bucketscalex,1.0/bucketscaley);
+	memcpy(geometryxform,xform,sizeof(float)*6);
+	nvgTransformPremultiply(geometryxform,s);
+	nvgTransformScale(xform,bucketscalex,bucketscaley);
+	return it->second;
+}
+
 void CachedSurface::Render(SystemState* sys,RenderContext& ctxt, const MATRIX* startmatrix, RenderDisplayObjectToBitmapContainer* container)
 {
 	if (!state)
@@ -321,6 +372,7 @@ void CachedSurface::Render(SystemState* sys,RenderContext& ctxt, const MATRIX* s
 							  || (state->needsLayer && sys->getRenderThread()->filterframebufferstack.empty());
 	if (needscachedtexture && (state->needsFilterRefresh || cachedFilterTextureID != UINT32_MAX))
 	{
+		ctxt.flushTextureBatch();
 		if (!isInitialized)
 		{
 			ctxt.transformStack().pop();
@@ -379,6 +431,7 @@ void CachedSurface::Render(SystemState* sys,RenderContext& ctxt, const MATRIX* s
 					engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
 					engineData->exec_glBlendFunc(BLEND_ONE,BLEND_ONE_MINUS_SRC_ALPHA);
 					engineData->exec_glUseProgram(((RenderThread&)ctxt).gpu_program);
+					sys->getRenderThread()->restoreScissor();
 				}
 				engineData->exec_glEnable_GL_STENCIL_TEST();
 				engineData->exec_glStencilMask(0x7f);
@@ -426,7 +479,7 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 	if (state->scrollRect.Xmin || state->scrollRect.Xmax || state->scrollRect.Ymin || state->scrollRect.Ymax)
 	{
 		MATRIX m = ctxt.transformStack().transform().matrix;
-		sys->getEngineData()->exec_glScissor(m.getTranslateX()+state->scrollRect.Xmin*m.getScaleX()
+		sys->getRenderThread()->setScissor(m.getTranslateX()+state->scrollRect.Xmin*m.getScaleX()
 											 ,sys->getRenderThread()->windowHeight-m.getTranslateY()-state->scrollRect.Ymax*m.getScaleY()
 											 ,(state->scrollRect.Xmax-state->scrollRect.Xmin)*m.getScaleX()
 											 ,(state->scrollRect.Ymax-state->scrollRect.Ymin)*m.getScaleY());
@@ -439,6 +492,7 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 		{
 			if (state->alpha == 0)
 				return;
+			ctxt.flushTextureBatch();
 			ColorTransformBase ct = ctxt.transformStack().transform().colorTransform;
 			nvgResetTransform(nvgctxt);
 			nvgBeginFrame(nvgctxt, sys->getRenderThread()->currentframebufferWidth, sys->getRenderThread()->currentframebufferHeight, 1.0);
@@ -485,6 +539,15 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 			nvgScale(nvgctxt,state->scaling,state->scaling);
 			float basetransform[6];
 			nvgCurrentTransform(nvgctxt,basetransform);
+			// the tessellation of immutable tokens is done once per scale bucket and transformed to the current matrix on the gpu side
+			float geometrytransform[6];
+			NVGgeometryCache* geometrycache = ctxt.isDrawingMask() ? nullptr : nanoVGGeometryCache(state->tokens.tessellation.getPtr(),basetransform,geometrytransform);
+			if (geometrycache)
+			{
+				nvgResetTransform(nvgctxt);
+				nvgTransform(nvgctxt,basetransform[0],basetransform[1],basetransform[2],basetransform[3],basetransform[4],basetransform[5]);
+				nvgBeginGeometryCache(nvgctxt,geometrycache,geometrytransform);
+			}
 			NVGcolor startcolor = nvgRGBA(0,0,0,0);
 			nvgBeginPath(nvgctxt);
 			if (ctxt.isDrawingMask())
@@ -763,6 +826,8 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 				if (infill)
 					nvgFill(nvgctxt);
 			}
+			if (geometrycache)
+				nvgEndGeometryCache(nvgctxt);
 			nvgClosePath(nvgctxt);
 			if (!ctxt.isDrawingMask())
 				nvgEndFrame(nvgctxt);
@@ -770,6 +835,7 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 			sys->getEngineData()->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
 			sys->getEngineData()->exec_glBlendFunc(BLEND_ONE,BLEND_ONE_MINUS_SRC_ALPHA);
 			sys->getEngineData()->exec_glUseProgram(((RenderThread&)ctxt).gpu_program);
+			sys->getRenderThread()->restoreScissor();
 			((GLRenderContext&)ctxt).lsglLoadIdentity();
 			((GLRenderContext&)ctxt).setMatrixUniform(GLRenderContext::LSGL_MODELVIEW);
 		}
@@ -818,28 +884,30 @@ void CachedSurface::renderImpl(SystemState* sys,RenderContext& ctxt)
 		ctxt.deactivateMask();
 		ctxt.popMask();
 	});
-	sys->getEngineData()->exec_glDisable_GL_SCISSOR_TEST();
+	sys->getRenderThread()->disableScissor();
 }
 void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t w, uint32_t h, const MATRIX& m)
 {
 	// rendering of filters currently works as follows:
-	// - generate fbo
-	// - generate texture with computed width/height of this DisplayObject as window size and set it as color attachment for fbo
+	// - get fbo from the filter pool of the RenderThread
+	// - get texture with computed width/height of this DisplayObject as window size from the pool and set it as color attachment for fbo
 	// - render DisplayObject to texture
 	// - set texture as "g_tex_filter1" in fragment shader
-	// - generate two more textures with computed width/height of this DisplayObject as window size
+	// - get two more textures with computed width/height of this DisplayObject as window size from the pool
 	// - for every filter
 	//   - for every step (blur, dropshadow...)
 	//     - set uniforms for step
+	//     - upload the bitmap of the step (if any) and bind it to "g_tex_filter_map"
 	//     - set one of the two textures as color attachment for fbo (use first generated texture in first step)
 	//     - render to texture 
 	//     - swap textures
 	//   - render resulting texture to "g_tex_filter2"
-	// - remember resulting texture in cachedSurface.cachedFilterTextureID
+	// - remember resulting texture in cachedSurface.cachedFilterTextureID, all other objects are returned to the pool
 	
 	if (w == 0 || h == 0)
 		return;
 
+	ctxt.flushTextureBatch();
 	ctxt.createTransformStack();
 	ctxt.transformStack().push(Transform2D(m,ColorTransformBase(),AS_BLENDMODE::BLENDMODE_NORMAL));
 
@@ -849,20 +917,13 @@ void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t
 	cachedFilterTextureID = UINT32_MAX;
 	
 	// render filter source to texture
-	uint32_t filterTextureIDoriginal;
-	engineData->exec_glGenTextures(1, &filterTextureIDoriginal);
-	uint32_t filterframebuffer = engineData->exec_glGenFramebuffer();
+	RenderThread* rt = sys->getRenderThread();
+	uint32_t filterframebuffer;
+	uint32_t filterrenderbuffer;
+	rt->acquireFilterFramebuffer(w,h,filterframebuffer,filterrenderbuffer);
 	engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
-	engineData->exec_glBindTexture_GL_TEXTURE_2D(filterTextureIDoriginal);
-	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(filterframebuffer);
-	uint32_t filterrenderbuffer = engineData->exec_glGenRenderbuffer();
-	engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(filterrenderbuffer);
-	engineData->exec_glRenderbufferStorage_GL_RENDERBUFFER_GL_STENCIL_INDEX8(w, h);
-	engineData->exec_glFramebufferRenderbuffer_GL_FRAMEBUFFER_GL_STENCIL_ATTACHMENT(filterrenderbuffer);
-	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
-	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_NEAREST();
+	uint32_t filterTextureIDoriginal = rt->acquireFilterTexture(w,h);
 	engineData->exec_glFramebufferTexture2D_GL_FRAMEBUFFER(filterTextureIDoriginal);
-	engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, w, h, 0, nullptr,true);
 	uint32_t parentframebufferWidth = sys->getRenderThread()->currentframebufferWidth;
 	uint32_t parentframebufferHeight = sys->getRenderThread()->currentframebufferHeight;
 	
@@ -883,6 +944,7 @@ void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t
 	fe.filterbordery=(-state->bounds.min.y+state->maxfilterborder)*scale.y;
 	sys->getRenderThread()->filterframebufferstack.push_back(fe);
 	renderImpl(sys,ctxt);
+	ctxt.flushTextureBatch();
 	// bind rendered filter source to g_tex_filter1
 	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(filterframebuffer);
 	engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(filterrenderbuffer);
@@ -891,24 +953,16 @@ void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t
 	
 	// create filter output texture, and bind it to g_tex_filter2
 	engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_FILTER_DST);
-	uint32_t filterDstTexture;
-	engineData->exec_glGenTextures(1, &filterDstTexture);
-	engineData->exec_glBindTexture_GL_TEXTURE_2D(filterDstTexture);
-	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
-	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_NEAREST();
+	uint32_t filterDstTexture = rt->acquireFilterTexture(w,h);
 	engineData->exec_glFramebufferTexture2D_GL_FRAMEBUFFER(filterDstTexture);
-	engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, w, h, 0, nullptr,true);
+	engineData->exec_glClearColor(0,0,0,0);
+	engineData->exec_glClear(CLEARMASK(CLEARMASK::COLOR));
 	
 	// apply all filter steps
 	engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
-	uint32_t filterTextureID1;
-	uint32_t filterTextureID2;
-	engineData->exec_glGenTextures(1, &filterTextureID1);
-	engineData->exec_glBindTexture_GL_TEXTURE_2D(filterTextureID1);
-	engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, w, h, 0, nullptr,true);
-	engineData->exec_glGenTextures(1, &filterTextureID2);
-	engineData->exec_glBindTexture_GL_TEXTURE_2D(filterTextureID2);
-	engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, w, h, 0, nullptr,true);
+	uint32_t filterTextureID1 = rt->acquireFilterTexture(w,h);
+	uint32_t filterTextureID2 = rt->acquireFilterTexture(w,h);
+	uint32_t filterMapTexture = UINT32_MAX;
 	sys->getRenderThread()->setViewPort(w,h,true);
 	uint32_t texture1 = filterTextureIDoriginal;
 	uint32_t texture2 = filterTextureID2;
@@ -925,6 +979,25 @@ void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t
 		}
 		else
 		{
+			if (!(*it).bitmapdata.empty())
+			{
+				// additional bitmap used by the filter step (the map of a DisplacementMapFilter)
+				engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_FILTER_MAP);
+				if (filterMapTexture == UINT32_MAX)
+					engineData->exec_glGenTextures(1, &filterMapTexture);
+				engineData->exec_glBindTexture_GL_TEXTURE_2D(filterMapTexture);
+				engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
+				engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_NEAREST();
+				engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_INT_8_8_8_8_HOST(0, (*it).bitmapwidth, (*it).bitmapheight, 0, (*it).bitmapdata.data());
+				engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
+				// the filter step needs the transformation from DisplayObject to filter texture coordinates
+				(*it).filterdata[FILTERDATA_MAXSIZE-8]=m.xx;
+				(*it).filterdata[FILTERDATA_MAXSIZE-7]=m.yx;
+				(*it).filterdata[FILTERDATA_MAXSIZE-6]=m.xy;
+				(*it).filterdata[FILTERDATA_MAXSIZE-5]=m.yy;
+				(*it).filterdata[FILTERDATA_MAXSIZE-4]=m.x0;
+				(*it).filterdata[FILTERDATA_MAXSIZE-3]=m.y0;
+			}
 			engineData->exec_glFramebufferTexture2D_GL_FRAMEBUFFER(texture2);
 			engineData->exec_glClearColor(0,0,0,0);
 			engineData->exec_glClear(CLEARMASK(CLEARMASK::COLOR|CLEARMASK::DEPTH|CLEARMASK::STENCIL));
@@ -951,15 +1024,16 @@ void CachedSurface::renderFilters(SystemState* sys,RenderContext& ctxt, uint32_t
 		engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(feparent.filterrenderbuffer);
 		sys->getRenderThread()->setViewPort(parentframebufferWidth,parentframebufferHeight,true);
 	}
-	engineData->exec_glDeleteFramebuffers(1,&filterframebuffer);
-	engineData->exec_glDeleteRenderbuffers(1,&filterrenderbuffer);
+	rt->releaseFilterFramebuffer(filterframebuffer,filterrenderbuffer,w,h);
 	cachedFilterTextureID=texture1;
-	engineData->exec_glDeleteTextures(1,&texture2);
-	engineData->exec_glDeleteTextures(1,&filterDstTexture);
+	rt->releaseFilterTexture(texture2,w,h);
+	rt->releaseFilterTexture(filterDstTexture,w,h);
 	if (state->filters.empty())
-		engineData->exec_glDeleteTextures(1,&filterTextureID1);
+		rt->releaseFilterTexture(filterTextureID1,w,h);
 	else
-		engineData->exec_glDeleteTextures(1,&filterTextureIDoriginal);
+		rt->releaseFilterTexture(filterTextureIDoriginal,w,h);
+	if (filterMapTexture != UINT32_MAX)
+		engineData->exec_glDeleteTextures(1,&filterMapTexture);
 	ctxt.transformStack().pop();
 	ctxt.removeTransformStack();
 	state->needsFilterRefresh=false;
@@ -1000,6 +1074,68 @@ RectF CachedSurface::boundsRectWithRenderTransform(const MATRIX& matrix, const M
 	return bounds;
 }
 
+static void addDamageRect(RectF& damage, bool& hasDamage, const RectF& r)
+{
+	if (r.min.x >= r.max.x || r.min.y >= r.max.y)
+		return;
+	damage = hasDamage ? damage._union(r) : r;
+	hasDamage = true;
+}
+void CachedSurface::collectDamage(const MATRIX& parentmatrix, const MATRIX* startmatrix, const MATRIX& initialMatrix, RectF& damage, bool& hasDamage, bool& fullRedraw)
+{
+	if (!state)
+		return;
+	// compute the transformation the same way as Render() does
+	MATRIX m = startmatrix ? *startmatrix : state->matrix;
+	m.translate(-state->scrollRect.Xmin,-state->scrollRect.Ymin);
+	m = parentmatrix.multiplyMatrix(m);
+	bool needscachedtexture = state->cacheAsBitmap
+							  || !state->filters.empty()
+							  || state->needsLayer
+							  || state->blendmode == BLENDMODE_LAYER
+							  || DisplayObject::isShaderBlendMode(state->blendmode);
+	// rendering the cached texture again switches to its own framebuffer, which doesn't work with the damage scissor
+	if (needscachedtexture && (state->needsFilterRefresh || m != state->cachedMatrix))
+		fullRedraw = true;
+
+	RectF bounds = state->bounds * m;
+	if (!state->filters.empty())
+	{
+		number_t filterborder = state->maxfilterborder;
+		bounds.min.x -= filterborder*initialMatrix.getScaleX();
+		bounds.max.x += filterborder*initialMatrix.getScaleX();
+		bounds.min.y -= filterborder*initialMatrix.getScaleY();
+		bounds.max.y += filterborder*initialMatrix.getScaleY();
+	}
+	bool hasBounds = bounds.min.x < bounds.max.x && bounds.min.y < bounds.max.y;
+	for (auto child : state->childrenlist)
+	{
+		// children are always visited, so their rendered bounds are up to date
+		child->collectDamage(m,nullptr,initialMatrix,damage,hasDamage,fullRedraw);
+		if (child->state && child->hasRenderedBounds)
+		{
+			bounds = hasBounds ? bounds._union(child->renderedBounds) : child->renderedBounds;
+			hasBounds = true;
+		}
+	}
+	if (!hasBounds)
+		bounds = RectF();
+	bool moved = !hasRenderedBounds || renderedBounds.min != bounds.min || renderedBounds.max != bounds.max;
+	if (damaged || moved)
+	{
+		// the old area has to be cleared and the new area has to be drawn
+		if (hasRenderedBounds)
+			addDamageRect(damage,hasDamage,renderedBounds);
+		addDamageRect(damage,hasDamage,bounds);
+	}
+	renderedBounds = bounds;
+	hasRenderedBounds = hasBounds;
+	damaged = false;
+}
+
+CachedSurface::CachedSurface():state(nullptr),tex(nullptr),isChunkOwner(true),isValid(false),isInitialized(false),wasUpdated(false),damaged(true),hasRenderedBounds(false),cachedFilterTextureID(UINT32_MAX)
+{
+}
 CachedSurface::~CachedSurface()
 {
 	if (isChunkOwner)
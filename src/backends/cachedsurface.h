@@ -21,6 +21,7 @@
 #define BACKENDS_CACHEDSURFACE_H 1
 
 #include "forwards/scripting/flash/display/DisplayObject.h"
+#include "forwards/scripting/flash/filters/flashfilters.h"
 #include "compat.h"
 #include <vector>
 #include "smartrefs.h"
@@ -40,6 +41,10 @@ struct FilterData
 {
 	float gradientcolors[256*4];
 	float filterdata[FILTERDATA_MAXSIZE];
+	// BGRA pixels of an additional bitmap used by the filter (the map of a DisplacementMapFilter)
+	std::vector<uint8_t> bitmapdata;
+	uint32_t bitmapwidth=0;
+	uint32_t bitmapheight=0;
 };
 
 class SurfaceState
@@ -87,6 +92,22 @@ public:
 #endif
 };
 
+// rasterized content of a surface, used instead of a texture by the HeadlessRenderer
+struct SoftwareRaster
+{
+	SoftwareRaster():width(0),height(0),xOffset(0),yOffset(0),xContentScale(1),yContentScale(1)
+	{
+	}
+	// premultiplied ARGB pixels as produced by IDrawable::getPixelBuffer
+	std::vector<uint8_t> pixels;
+	uint32_t width;
+	uint32_t height;
+	number_t xOffset;
+	number_t yOffset;
+	number_t xContentScale;
+	number_t yContentScale;
+};
+
 class CachedSurface: public RefCountable
 {
 private:
@@ -94,15 +115,14 @@ private:
 	void renderImpl(SystemState* sys,RenderContext& ctxt);
 	void defaultRender(RenderContext& ctxt);
 public:
-	CachedSurface():state(nullptr),tex(nullptr),isChunkOwner(true),isValid(false),isInitialized(false),wasUpdated(false),cachedFilterTextureID(UINT32_MAX)
-	{
-	}
+	CachedSurface();
 	~CachedSurface();
 	void SetState(SurfaceState* newstate)
 	{
 		if (state && state != newstate)
 			delete state;
 		state = newstate;
+		damaged = true;
 	}
 	SurfaceState* getState() const
 	{
@@ -111,12 +131,25 @@ public:
 	void Render(SystemState* sys, RenderContext& ctxt, const MATRIX* startmatrix=nullptr, RenderDisplayObjectToBitmapContainer* container=nullptr);
 	RectF boundsRectWithRenderTransform(const MATRIX& matrix, const MATRIX& initialMatrix);
 	void renderFilters(SystemState* sys, RenderContext& ctxt, uint32_t w, uint32_t h, const MATRIX& m);
+	/*
+	 * adds the stage area that has to be redrawn for this surface and its children to damage
+	 * fullRedraw is set if the changes can't be rendered with a partial redraw
+	 */
+	void collectDamage(const MATRIX& parentmatrix, const MATRIX* startmatrix, const MATRIX& initialMatrix, RectF& damage, bool& hasDamage, bool& fullRedraw);
 	TextureChunk* tex;
 	bool isChunkOwner;
 	bool isValid;
 	bool isInitialized;
 	bool wasUpdated;
+	// the state or the texture content has changed since the last damage collection
+	bool damaged;
+	// bounds of this surface and its children in stage coordinates during the last damage collection
+	bool hasRenderedBounds;
+	RectF renderedBounds;
 	uint32_t cachedFilterTextureID;
+	SoftwareRaster softwareRaster;
+	// filters of the owning DisplayObject at the time of the last refresh, only used by the HeadlessRenderer
+	std::vector<_R<BitmapFilter>> softwareFilters;
 };
 
 }
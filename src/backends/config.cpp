@@ -84,7 +84,7 @@ Config::Config():
 	systemConfigDirectories(g_get_system_config_dirs()),userConfigDirectory(g_get_user_config_dir()),
 	//DEFAULT SETTINGS
 	defaultCacheDirectory((string) g_get_user_cache_dir() + G_DIR_SEPARATOR_S + "lightspark"),
-	cacheDirectory(defaultCacheDirectory),cachePrefix("cache"),userDataDirectory((string)g_get_user_data_dir() + G_DIR_SEPARATOR_S + "lightspark"),
+	cacheDirectory(defaultCacheDirectory),cachePrefix("cache"),swfCacheEnabled(false),userDataDirectory((string)g_get_user_data_dir() + G_DIR_SEPARATOR_S + "lightspark"),
 	renderingEnabled(true)
 {
 #ifdef _WIN32
@@ -211,6 +211,9 @@ void Config::handleEntry()
 	//Cache prefix
 	else if(group == "cache" && key == "prefix")
 		cachePrefix = value;
+	//Cache decompressed swf files
+	else if(group == "cache" && key == "swf")
+		swfCacheEnabled = atoi(value.c_str());
 	else
 		LOG(LOG_ERROR,"Invalid entry encountered in configuration file" << ": '" << group << "/" << key << "'='" << value << "'");
 }
\ No newline at end of file
@@ -44,6 +44,8 @@ namespace lightspark
 		std::string cacheDirectory;
 		//Specifies what prefix the cache files should have, default="cache"
 		std::string cachePrefix;
+		//Specifies if decompressed swf files are cached, default=false
+		bool swfCacheEnabled;
 		//Specifies the filename including full path of the gnash executable
 		std::string gnashPath;
 		//Specifies the directory where the app can store files
@@ -60,6 +62,7 @@ namespace lightspark
 
 		const std::string& getCacheDirectory() const { return cacheDirectory; }
 		const std::string& getCachePrefix() const { return cachePrefix; }
+		bool isSWFCacheEnabled() const { return swfCacheEnabled; }
 		const std::string& getDataDirectory() const { return dataDirectory; }
 		const std::string& getUserDataDirectory() const { return userDataDirectory; }
 		
@@ -25,6 +25,7 @@
 #include "backends/geometry.h"
 #include "compat.h"
 #include "scripting/flash/display/BitmapData.h"
+#include "3rdparty/nanovg/src/nanovg.h"
 
 using namespace std;
 using namespace lightspark;
@@ -635,10 +636,23 @@ void ShapesBuilder::outputMorphTokens(std::list<MORPHFILLSTYLE>& styles, std::li
 	}
 }
 
+tessellationCache::~tessellationCache()
+{
+	clear();
+}
+
+void tessellationCache::clear()
+{
+	for (auto it = buckets.begin(); it != buckets.end(); it++)
+		nvgDeleteGeometryCache(it->second);
+	buckets.clear();
+}
+
 void tokensVector::clear()
 {
 	filltokens.reset();
 	stroketokens.reset();
+	tessellation.reset();
 	boundsRect = RECT(INT32_MAX,INT32_MIN,INT32_MAX,INT32_MIN);
 }
 
@@ -648,6 +662,7 @@ void tokensVector::destruct()
 		next->destruct();
 	filltokens.reset();
 	stroketokens.reset();
+	tessellation.reset();
 }
 
 tokenListRef::~tokenListRef()
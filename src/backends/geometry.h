@@ -26,6 +26,7 @@
 #include <map>
 
 typedef std::vector<uint64_t> TokenList;
+struct NVGgeometryCache;
 
 namespace lightspark
 {
@@ -154,7 +155,9 @@ class tokenListRef : public RefCountable
 	linestylecache* lineStyles;
 public:
 	TokenList tokens;
-	tokenListRef():fillStyles(nullptr),lineStyles(nullptr)
+	// set for tokens that never change after they are created (e.g. the tokens of a DefineShapeTag), so they can be identified by their address
+	bool immutable;
+	tokenListRef():fillStyles(nullptr),lineStyles(nullptr),immutable(false)
 	{
 	}
 	~tokenListRef();
@@ -163,10 +166,25 @@ public:
 	void clone(tokenListRef* source);
 };
 
+/*
+ * Tessellated geometry of tokens that never change (e.g. the tokens of a DefineShapeTag), used by the nanoVG renderer
+ * The geometry is cached per scale bucket and only accessed in the render thread
+ */
+class tessellationCache : public RefCountable
+{
+public:
+	// the key contains the scale bucket of the x axis in the upper 16 bits and the one of the y axis in the lower 16 bits
+	std::map<int32_t,NVGgeometryCache*> buckets;
+	~tessellationCache();
+	void clear();
+};
+
 struct tokensVector
 {
 	_NR<tokenListRef> filltokens;
 	_NR<tokenListRef> stroketokens;
+	// only set if the tokens are immutable
+	_NR<tessellationCache> tessellation;
 	tokensVector* next;
 	MATRIX startMatrix;
 	RECT boundsRect;
@@ -18,6 +18,7 @@
 **************************************************************************/
 
 #include <cassert>
+#include <tuple>
 
 #include "swf.h"
 #include "abc.h"
@@ -57,12 +58,11 @@ TextureChunk::TextureChunk(uint32_t w, uint32_t h)
 		chunks=nullptr;
 		return;
 	}
-	const uint32_t blocksW=(width+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL;
-	const uint32_t blocksH=(height+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL;
-	chunks=new uint32_t[blocksW*blocksH];
+	allocatedChunks=getNumberOfChunks();
+	chunks=new uint32_t[allocatedChunks];
 }
 
-TextureChunk::TextureChunk(const TextureChunk& r):chunks(nullptr),texId(0),width(r.width),height(r.height)
+TextureChunk::TextureChunk(const TextureChunk& r):chunks(nullptr),allocatedChunks(0),texId(0),width(r.width),height(r.height)
 {
 	*this = r;
 	return;
@@ -78,16 +78,18 @@ TextureChunk& TextureChunk::operator=(const TextureChunk& r)
 	}
 	width=r.width;
 	height=r.height;
-	uint32_t blocksW=(width+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL;
-	uint32_t blocksH=(height+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL;
 	texId=r.texId;
 	if(r.chunks)
 	{
-		chunks=new uint32_t[blocksW*blocksH];
-		memcpy(chunks, r.chunks, blocksW*blocksH*4);
+		allocatedChunks=r.allocatedChunks;
+		chunks=new uint32_t[allocatedChunks];
+		memcpy(chunks, r.chunks, allocatedChunks*4);
 	}
 	else
+	{
+		allocatedChunks=0;
 		chunks=nullptr;
+	}
 	xContentScale = r.xContentScale;
 	yContentScale = r.yContentScale;
 	xOffset = r.xOffset;
@@ -110,12 +112,14 @@ void TextureChunk::makeEmpty()
 	if (chunks)
 		delete[] chunks;
 	chunks=nullptr;
+	allocatedChunks=0;
 }
 
 void TextureChunk::setChunks(uint8_t* buf)
 {
 	assert(chunks == nullptr);
 	chunks=(uint32_t*)buf;
+	allocatedChunks=getNumberOfChunks();
 }
 
 bool TextureChunk::resizeIfLargeEnough(uint32_t w, uint32_t h)
@@ -126,6 +130,7 @@ bool TextureChunk::resizeIfLargeEnough(uint32_t w, uint32_t h)
 		getSys()->getRenderThread()->releaseTexture(*this);
 		delete[] chunks;
 		chunks=nullptr;
+		allocatedChunks=0;
 		width=w;
 		height=h;
 		return true;
@@ -243,6 +248,7 @@ cairo_pattern_t* CairoTokenRenderer::FILLSTYLEToCairo(const FILLSTYLE& style, do
 		case REPEATING_BITMAP:
 		case CLIPPED_BITMAP:
 		{
+			style.decodeBitmap();
 			_NR<BitmapContainer> bm(style.bitmap);
 			if(bm.isNull())
 				return nullptr;
@@ -683,6 +689,43 @@ uint8_t* CairoRenderer::getPixelBuffer(bool *isBufferOwner, uint32_t* bufsize)
 	return ret;
 }
 
+bool CairoTokenRenderer::getRasterCacheKey(RasterCacheKey& key) const
+{
+	if ((filltokens && !filltokens->immutable) || (stroketokens && !stroketokens->immutable))
+		return false;
+	key.filltokens = filltokens;
+	key.stroketokens = stroketokens;
+	key.width = width;
+	key.height = height;
+	key.xscale = getState()->xscale;
+	key.yscale = getState()->yscale;
+	key.scaling = getState()->scaling;
+	key.xstart = xstart;
+	key.ystart = ystart;
+	key.isMask = getState()->isMask;
+	key.smoothing = getState()->smoothing;
+	return true;
+}
+
+void CairoRenderer::renderTile(uint8_t* buf, int32_t x, int32_t y, int32_t w, int32_t h)
+{
+	int32_t cairoWidthStride=cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+	assert(cairoWidthStride==width*4);
+	// the tile surface shares the memory of the whole buffer, starting at the first pixel of the region
+	cairo_surface_t* cairoSurface=cairo_image_surface_create_for_data(buf+y*cairoWidthStride+x*4, CAIRO_FORMAT_ARGB32, w, h, cairoWidthStride);
+	cairo_t* cr=cairo_create(cairoSurface);
+	cairo_surface_destroy(cairoSurface); /* cr has an reference to it */
+
+	cairo_translate(cr, -x, -y);
+	cairo_scale(cr, getState()->xscale, getState()->yscale);
+	cairoClean(cr);
+	cairo_set_antialias(cr,getState()->smoothing ? CAIRO_ANTIALIAS_DEFAULT : CAIRO_ANTIALIAS_NONE);
+
+	executeDraw(cr);
+
+	cairo_destroy(cr);
+}
+
 bool CairoRenderer::isCachedSurfaceUsable(const DisplayObject* o) const
 {
 	const TextureChunk* tex = o->cachedSurface->tex;
@@ -1019,7 +1062,12 @@ std::vector<LineData> CairoPangoRenderer::getLineData(const TextData& _textData)
 	return data;
 }
 
-AsyncDrawJob::AsyncDrawJob(IDrawable* d, _R<DisplayObject> o):drawable(d),owner(o),surfaceBytes(nullptr),uploadNeeded(false),isBufferOwner(true)
+// drawables smaller than this number of pixels are never split into tiles
+#define TILED_RENDERING_MIN_PIXELS (512*512)
+// minimum height of a tile
+#define TILED_RENDERING_MIN_HEIGHT 64
+
+AsyncDrawJob::AsyncDrawJob(IDrawable* d, _R<DisplayObject> o, bool tiled):drawable(d),owner(o),surfaceBytes(nullptr),uploadNeeded(false),isBufferOwner(true),allowTiling(tiled),hasCacheKey(false),tileAborted(false),pendingTiles(1)
 {
 	owner->cachedSurface->wasUpdated=false;
 }
@@ -1032,9 +1080,54 @@ AsyncDrawJob::~AsyncDrawJob()
 		delete[] surfaceBytes;
 }
 
+uint32_t AsyncDrawJob::getTileCount() const
+{
+	if (!allowTiling || !drawable->supportsTiledRendering() || owner->getSystemState()->runSingleThreaded)
+		return 1;
+	int32_t w=drawable->getWidth();
+	int32_t h=drawable->getHeight();
+	if (w<=0 || h<=0 || w*h < TILED_RENDERING_MIN_PIXELS)
+		return 1;
+	uint32_t count = min(uint32_t(h/TILED_RENDERING_MIN_HEIGHT),uint32_t(SDL_GetCPUCount()));
+	return max(count,1U);
+}
+
 void AsyncDrawJob::execute()
 {
-	if(!threadAborting)
+	if(threadAborting)
+		return;
+	if (Config::getConfig()->isRenderingEnabled() && drawable->getRasterCacheKey(cacheKey))
+	{
+		surfaceBytes=owner->getSystemState()->getRasterCache()->lookup(cacheKey);
+		if (surfaceBytes)
+		{
+			isBufferOwner=true;
+			uploadNeeded=!threadAborting;
+			return;
+		}
+		hasCacheKey=true;
+	}
+	uint32_t tilecount = Config::getConfig()->isRenderingEnabled() ? getTileCount() : 1;
+	if (tilecount > 1)
+	{
+		// the raster is split into horizontal bands, all but the first one are rendered by additional jobs
+		int32_t w=drawable->getWidth();
+		int32_t h=drawable->getHeight();
+		int32_t tileheight=(h+tilecount-1)/tilecount;
+		tilecount=(h+tileheight-1)/tileheight;
+		surfaceBytes=new uint8_t[w*h*4];
+		isBufferOwner=true;
+		pendingTiles+=tilecount-1;
+		for (uint32_t i = 1; i < tilecount; i++)
+		{
+			int32_t y=i*tileheight;
+			AsyncDrawTileJob* j = new AsyncDrawTileJob(this,y,min(tileheight,h-y));
+			j->priority=priority;
+			owner->getSystemState()->addJob(j);
+		}
+		drawable->renderTile(surfaceBytes,0,0,w,tileheight);
+	}
+	else
 		surfaceBytes=drawable->getPixelBuffer(&isBufferOwner);
 	if(!threadAborting && surfaceBytes)
 		uploadNeeded=true;
@@ -1047,17 +1140,48 @@ void AsyncDrawJob::threadAbort()
 
 void AsyncDrawJob::jobFence()
 {
+	tileFenced();
+}
+
+void AsyncDrawJob::tileFenced()
+{
+	// the job is finished when the last of its tiles is fenced
+	if (ATOMIC_DECREMENT(pendingTiles) > 0)
+		return;
 	//If the data must be uploaded (there were no errors) the Job add itself to the upload queue.
 	//Otherwise it destroys itself
-	if(uploadNeeded)
+	if(uploadNeeded && !ACQUIRE_READ(tileAborted))
 	{
 		uploadNeeded=false;
+		if (hasCacheKey)
+			owner->getSystemState()->getRasterCache()->insert(cacheKey,surfaceBytes);
 		owner->getSystemState()->getRenderThread()->addUploadJob(this);
 	}
 	else
 		delete this;
 }
 
+AsyncDrawTileJob::AsyncDrawTileJob(AsyncDrawJob* p, int32_t _y, int32_t _h):parent(p),y(_y),height(_h),done(false)
+{
+}
+
+void AsyncDrawTileJob::execute()
+{
+	// the parent job has been replaced by a newer one, so there is no need to finish the raster
+	if (threadAborting || parent->threadAborting)
+		return;
+	parent->drawable->renderTile(parent->surfaceBytes,0,y,parent->drawable->getWidth(),height);
+	done=true;
+}
+
+void AsyncDrawTileJob::jobFence()
+{
+	if (!done)
+		RELEASE_WRITE(parent->tileAborted,true);
+	parent->tileFenced();
+	delete this;
+}
+
 uint8_t* AsyncDrawJob::upload(bool refresh)
 {
 	assert(surfaceBytes);
@@ -1085,6 +1209,8 @@ TextureChunk& AsyncDrawJob::getTexture()
 	}
 	if(!surface->tex->resizeIfLargeEnough(width, height))
 		*surface->tex=owner->getSystemState()->getRenderThread()->allocateTexture(width, height,false);
+	// the texture content will change, so the surface has to be redrawn
+	surface->damaged=true;
 	if (!surface->wasUpdated) // surface may have already been changed by DisplayObject::updateCachedSurface() before it was uploaded
 	{
 		surface->SetState(drawable->getState());
@@ -1119,6 +1245,89 @@ void AsyncDrawJob::contentOffset(number_t& x, number_t& y) const
 	y = drawable->getState()->yOffset;
 }
 
+bool RasterCacheKey::operator<(const RasterCacheKey& r) const
+{
+	return std::make_tuple(filltokens.getPtr(),stroketokens.getPtr(),width,height,xscale,yscale,scaling,xstart,ystart,isMask,smoothing)
+		< std::make_tuple(r.filltokens.getPtr(),r.stroketokens.getPtr(),r.width,r.height,r.xscale,r.yscale,r.scaling,r.xstart,r.ystart,r.isMask,r.smoothing);
+}
+
+RasterCache::RasterCache(uint64_t budget):memoryUsed(0),memoryBudget(budget),hits(0),misses(0)
+{
+}
+
+RasterCache::~RasterCache()
+{
+	for (auto it = entries.begin(); it != entries.end(); it++)
+		delete[] it->second.pixels;
+}
+
+uint8_t* RasterCache::lookup(const RasterCacheKey& key)
+{
+	Locker l(mutex);
+	auto it = entries.find(key);
+	if (it == entries.end())
+	{
+		misses++;
+		return nullptr;
+	}
+	hits++;
+	lru.splice(lru.begin(),lru,it->second.lruPosition);
+	uint8_t* ret = new uint8_t[it->second.size];
+	memcpy(ret,it->second.pixels,it->second.size);
+	return ret;
+}
+
+void RasterCache::insert(const RasterCacheKey& key, const uint8_t* pixels)
+{
+	uint32_t size = key.width*key.height*4;
+	if (!pixels || size == 0 || size > memoryBudget)
+		return;
+	Locker l(mutex);
+	if (entries.find(key) != entries.end())
+		return;
+	while (memoryUsed+size > memoryBudget && !lru.empty())
+	{
+		auto it = entries.find(lru.back());
+		memoryUsed -= it->second.size;
+		delete[] it->second.pixels;
+		entries.erase(it);
+		lru.pop_back();
+	}
+	Entry e;
+	e.pixels = new uint8_t[size];
+	memcpy(e.pixels,pixels,size);
+	e.size = size;
+	lru.push_front(key);
+	e.lruPosition = lru.begin();
+	entries.insert(make_pair(key,e));
+	memoryUsed += size;
+}
+
+void RasterCache::getStatistics(uint32_t& _hits, uint32_t& _misses, uint64_t& memory)
+{
+	Locker l(mutex);
+	_hits = hits;
+	_misses = misses;
+	memory = memoryUsed;
+}
+
+bool RasterCache::isCacheable(const tokensVector& tokens)
+{
+	if (tokens.next || tokens.isGlyph)
+		return false;
+	return (!tokens.filltokens || tokens.filltokens->immutable) && (!tokens.stroketokens || tokens.stroketokens->immutable)
+			&& (tokens.filltokens || tokens.stroketokens);
+}
+
+number_t RasterCache::quantizeScale(number_t scale)
+{
+	if (scale == 0 || !std::isfinite(scale))
+		return scale;
+	// small tolerance so exact bucket scales are not moved to the next bucket by rounding errors
+	number_t s = exp2(ceil(log2(fabs(scale))*RASTERCACHE_BUCKETS_PER_OCTAVE-1e-6)/RASTERCACHE_BUCKETS_PER_OCTAVE);
+	return scale < 0 ? -s : s;
+}
+
 IDrawable::IDrawable(float w, float h, float x, float y, float xs, float ys, float xcs, float ycs, bool _ismask, bool _cacheAsBitmap, float _scaling, float a, const ColorTransformBase& _colortransform, SMOOTH_MODE _smoothing, AS_BLENDMODE _blendmode, const MATRIX& _m)
 	:width(w),height(h), xContentScale(xcs), yContentScale(ycs)
 {
@@ -37,6 +37,9 @@
 #include <pango/pango.h>
 #include "backends/geometry.h"
 #include "memory_support.h"
+#include "threading.h"
+#include <list>
+#include <map>
 
 namespace lightspark
 {
@@ -113,6 +116,8 @@ private:
 	 * not used.
 	 */
 	uint32_t* chunks = nullptr;
+	// number of blocks allocated for chunks, the size may shrink below it in resizeIfLargeEnough
+	uint32_t allocatedChunks = 0;
 	uint32_t texId = 0;
 	TextureChunk(uint32_t w, uint32_t h);
 public:
@@ -249,6 +254,63 @@ struct RenderDisplayObjectToBitmapContainer
 	std::list<RefreshableSurface> surfacesToRefresh;
 };
 
+// identifies the raster of immutable tokens
+struct RasterCacheKey
+{
+	_NR<tokenListRef> filltokens;
+	_NR<tokenListRef> stroketokens;
+	int32_t width;
+	int32_t height;
+	float xscale;
+	float yscale;
+	float scaling;
+	number_t xstart;
+	number_t ystart;
+	bool isMask;
+	SMOOTH_MODE smoothing;
+	bool operator<(const RasterCacheKey& r) const;
+};
+
+// default memory budget of the RasterCache
+#define RASTERCACHE_MEMORY_BUDGET (64*1024*1024)
+// number of scale buckets per doubling of the scale
+#define RASTERCACHE_BUCKETS_PER_OCTAVE 8
+
+/*
+ * Caches the rasters of immutable tokens, so instances of the same shape rendered at the same quantized scale
+ * are only rasterized once. The least recently used rasters are evicted when the memory budget is exceeded.
+ * It is accessed from the ThreadPool and the render thread
+ */
+class RasterCache
+{
+private:
+	struct Entry
+	{
+		uint8_t* pixels;
+		uint32_t size;
+		std::list<RasterCacheKey>::iterator lruPosition;
+	};
+	Mutex mutex;
+	std::map<RasterCacheKey,Entry> entries;
+	// most recently used keys first
+	std::list<RasterCacheKey> lru;
+	uint64_t memoryUsed;
+	uint64_t memoryBudget;
+	uint32_t hits;
+	uint32_t misses;
+public:
+	RasterCache(uint64_t budget);
+	~RasterCache();
+	// returns a copy of the cached raster that is owned by the caller, or nullptr if there is no raster for the key
+	uint8_t* lookup(const RasterCacheKey& key);
+	// stores a copy of the raster, which has the size given in the key
+	void insert(const RasterCacheKey& key, const uint8_t* pixels);
+	void getStatistics(uint32_t& _hits, uint32_t& _misses, uint64_t& memory);
+	static bool isCacheable(const tokensVector& tokens);
+	// returns the smallest scale bucket that is not smaller than the scale
+	static number_t quantizeScale(number_t scale);
+};
+
 class IDrawable
 {
 protected:
@@ -278,6 +340,19 @@ public:
 	 * masks
 	 */
 	virtual uint8_t* getPixelBuffer(bool* isBufferOwner=nullptr, uint32_t* bufsize=nullptr)=0;
+	/*
+	 * Drawables returning true here can be rasterized in several regions concurrently by calling renderTile()
+	 */
+	virtual bool supportsTiledRendering() const { return false; }
+	/*
+	 * Renders the region (x,y,w,h) of the raster into buf, which holds width*height ARGB32 pixels
+	 * This may be called from several threads at once for distinct regions of the same buffer
+	 */
+	virtual void renderTile(uint8_t* buf, int32_t x, int32_t y, int32_t w, int32_t h) {}
+	/*
+	 * Drawables whose raster only depends on immutable data fill the key for the RasterCache and return true
+	 */
+	virtual bool getRasterCacheKey(RasterCacheKey& key) const { return false; }
 	virtual bool isCachedSurfaceUsable(const DisplayObject*) const {return true;}
 	int32_t getWidth() const { return width; }
 	int32_t getHeight() const { return height; }
@@ -286,8 +361,12 @@ public:
 	SurfaceState* getState() const { return state; }
 };
 
+// priorities of the draw jobs added to the ThreadPool in a frame
+enum DRAWJOB_PRIORITY { DRAWJOB_PRIORITY_OFFSCREEN=0, DRAWJOB_PRIORITY_MASK, DRAWJOB_PRIORITY_VISIBLE };
+
 class AsyncDrawJob: public IThreadJob, public ITextureUploadable
 {
+friend class AsyncDrawTileJob;
 private:
 	IDrawable* drawable;
 	/**
@@ -298,14 +377,26 @@ private:
 	uint8_t* surfaceBytes;
 	bool uploadNeeded;
 	bool isBufferOwner;
+	bool allowTiling;
+	// set if the raster has to be stored in the RasterCache when it is complete
+	bool hasCacheKey;
+	RasterCacheKey cacheKey;
+	// set if a tile was not rendered, so the buffer is incomplete
+	ACQUIRE_RELEASE_FLAG(tileAborted);
+	// number of tiles (including the one rendered by this job) that have not been fenced yet
+	ATOMIC_INT32(pendingTiles);
+	uint32_t getTileCount() const;
+	void tileFenced();
 public:
 	/*
 	 * @param o The DisplayObject that is being rendered. It is a reference to
 	 * make sure the object survives until the end of the rendering
 	 * @param d IDrawable to be rendered asynchronously. The pointer is now
 	 * owned by this instance
+	 * @param tiled If true, large drawables are split into tiles that are rendered in parallel in the ThreadPool.
+	 * Only jobs executed by the ThreadPool may be tiled, as execute() returns before all tiles are rendered
 	 */
-	AsyncDrawJob(IDrawable* d, _R<DisplayObject> o);
+	AsyncDrawJob(IDrawable* d, _R<DisplayObject> o, bool tiled=false);
 	~AsyncDrawJob();
 	//IThreadJob interface
 	void execute() override;
@@ -315,12 +406,31 @@ public:
 	uint8_t* upload(bool refresh) override;
 	void sizeNeeded(uint32_t& w, uint32_t& h) const override;
 	TextureChunk& getTexture() override;
+	bool reportsDamage() const override { return true; }
 	void uploadFence() override;
 	void contentScale(number_t& x, number_t& y) const override;
 	void contentOffset(number_t& x, number_t& y) const override;
 	DisplayObject* getOwner() { return owner.getPtr(); }
 };
 
+/*
+ * Renders a horizontal band of the raster of an AsyncDrawJob
+ * The parent job is uploaded when all its tiles are fenced
+ */
+class AsyncDrawTileJob: public IThreadJob
+{
+private:
+	AsyncDrawJob* parent;
+	int32_t y;
+	int32_t height;
+	bool done;
+public:
+	AsyncDrawTileJob(AsyncDrawJob* p, int32_t _y, int32_t _h);
+	//IThreadJob interface
+	void execute() override;
+	void jobFence() override;
+};
+
 /**
 	The base class for render jobs based on cairo
 	Stores an internal copy of the data to be rendered
@@ -343,6 +453,7 @@ public:
 				  , AS_BLENDMODE _blendmode);
 	//IDrawable interface
 	uint8_t* getPixelBuffer(bool* isBufferOwner=nullptr, uint32_t* bufsize=nullptr) override;
+	void renderTile(uint8_t* buf, int32_t x, int32_t y, int32_t w, int32_t h) override;
 	bool isCachedSurfaceUsable(const DisplayObject*) const override;
 	/*
 	 * Converts data (which is in RGB format) to the format internally used by cairo.
@@ -405,6 +516,9 @@ CairoTokenRenderer(_NR<tokenListRef> _filltokens,_NR<tokenListRef> _stroketokens
 	   @param y The Y in local coordinates
 	*/
 	static bool hitTest(NullableRef<tokenListRef> tokens, float scaleFactor, const Vector2f& point);
+	// the tokens are only read while drawing, so tiles can be rendered concurrently
+	bool supportsTiledRendering() const override { return true; }
+	bool getRasterCacheKey(RasterCacheKey& key) const override;
 };
 
 struct FormatText
@@ -0,0 +1,333 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "backends/headlessrendering.h"
+#include "backends/cachedsurface.h"
+#include "backends/rendering_context.h"
+#include "scripting/flash/display/DisplayObject.h"
+#include "scripting/flash/display/RootMovieClip.h"
+#include "scripting/flash/display/Stage.h"
+#include "scripting/flash/display/BitmapContainer.h"
+#include "scripting/flash/filters/flashfilters.h"
+#include "scripting/toplevel/Array.h"
+#include "swf.h"
+#include "logger.h"
+#include <glib.h>
+
+using namespace lightspark;
+using namespace std;
+
+HeadlessRenderer::HeadlessRenderer(SystemState* s, const tiny_string& dir, uint32_t limit, bool fastforward, uint32_t w, uint32_t h)
+	:m_sys(s),outputDirectory(dir),frameLimit(limit),frameCount(0),fastForward(fastforward),width(w),height(h)
+{
+	stageSurface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+	float scalex;
+	float scaley;
+	int offx;
+	int offy;
+	m_sys->stageCoordinateMapping(width, height, offx, offy, scalex, scaley);
+	initialMatrix.scale(scalex, scaley);
+	initialMatrix.translate(offx, offy);
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+	cairo_surface_destroy(stageSurface);
+}
+
+void HeadlessRenderer::refreshSurface(IDrawable* d, _NR<DisplayObject> o)
+{
+	CachedSurface* surface = o->getCachedSurface().getPtr();
+	bool needsRaster = o->getNeedsTextureRecalculation() || !isRasterUsable(surface, d);
+	o->updateCachedSurface(d);
+	if (needsRaster)
+		rasterize(surface, d);
+	o->resetNeedsTextureRecalculation();
+
+	// filters are applied during compositing, so we keep the filter objects instead of the FilterData used by the shaders
+	surface->softwareFilters.clear();
+	if (o->hasFilters())
+	{
+		for (uint32_t i = 0; i < o->filters->size(); i++)
+		{
+			asAtom f = asAtomHandler::invalidAtom;
+			o->filters->at_nocheck(f,i);
+			if (asAtomHandler::is<BitmapFilter>(f))
+			{
+				BitmapFilter* filter = asAtomHandler::as<BitmapFilter>(f);
+				filter->incRef();
+				surface->softwareFilters.push_back(_MR(filter));
+			}
+		}
+	}
+	delete d;
+}
+
+bool HeadlessRenderer::isRasterUsable(const CachedSurface* surface, const IDrawable* d) const
+{
+	const SoftwareRaster& r = surface->softwareRaster;
+	if (r.pixels.empty())
+		return false;
+	// same regen threshold as CairoRenderer::isCachedSurfaceUsable
+	return abs(d->getState()->xscale / r.xContentScale) < 2
+		&& abs(d->getState()->yscale / r.yContentScale) < 2;
+}
+
+void HeadlessRenderer::rasterize(CachedSurface* surface, IDrawable* d)
+{
+	SoftwareRaster& r = surface->softwareRaster;
+	bool isBufferOwner = true;
+	uint32_t bufsize = 0;
+	uint8_t* buf = d->getPixelBuffer(&isBufferOwner,&bufsize);
+	if (!buf || d->getWidth() <= 0 || d->getHeight() <= 0)
+	{
+		r.pixels.clear();
+		r.width = 0;
+		r.height = 0;
+		if (buf && isBufferOwner)
+			delete[] buf;
+		return;
+	}
+	r.width = d->getWidth();
+	r.height = d->getHeight();
+	uint32_t size = r.width*r.height*4;
+	r.pixels.assign(buf, buf+min(size,bufsize));
+	r.pixels.resize(size);
+	if (isBufferOwner)
+		delete[] buf;
+	r.xOffset = d->getState()->xOffset;
+	r.yOffset = d->getState()->yOffset;
+	r.xContentScale = d->getXContentScale();
+	r.yContentScale = d->getYContentScale();
+}
+
+void HeadlessRenderer::renderFrame()
+{
+	if (m_sys->isShuttingDown() || (frameLimit && frameCount >= frameLimit))
+		return;
+	cairo_t* cr = cairo_create(stageSurface);
+	RGB bg = m_sys->mainClip->getBackground();
+	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_rgb(cr, bg.Red/255.0, bg.Green/255.0, bg.Blue/255.0);
+	cairo_paint(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+	renderSurface(cr, m_sys->stage->getCachedSurface().getPtr(), MATRIX(), &initialMatrix, ColorTransformBase(), false);
+	cairo_destroy(cr);
+	writeFrame();
+	frameCount++;
+	if (frameLimit && frameCount >= frameLimit)
+	{
+		LOG(LOG_INFO,"headless rendering: " << frameCount << " frames written, shutting down");
+		m_sys->setShutdownFlag();
+	}
+	else if (fastForward)
+		m_sys->addWait(0,m_sys);
+}
+
+void HeadlessRenderer::writeFrame()
+{
+	char filename[32];
+	snprintf(filename,32,"frame%06u.png",frameCount);
+	tiny_string path = outputDirectory;
+	path += G_DIR_SEPARATOR_S;
+	path += filename;
+	cairo_surface_flush(stageSurface);
+	cairo_status_t res = cairo_surface_write_to_png(stageSurface, path.raw_buf());
+	if (res != CAIRO_STATUS_SUCCESS)
+		LOG(LOG_ERROR,"headless rendering: writing " << path << " failed: " << cairo_status_to_string(res));
+}
+
+void HeadlessRenderer::renderSurface(cairo_t* cr, CachedSurface* surface, const MATRIX& parentmatrix, const MATRIX* startmatrix,
+									 const ColorTransformBase& parentct, bool drawingMask)
+{
+	SurfaceState* state = surface->getState();
+	if (!state)
+		return;
+	if (!state->mask.isNull() && !state->mask->getState())
+		return;
+	if((!state->isMask && !state->clipdepth && !state->visible) || state->alpha==0.0)
+		return;
+	// compute the transformation the same way as CachedSurface::Render() does
+	MATRIX m = startmatrix ? *startmatrix : state->matrix;
+	m.translate(-state->scrollRect.Xmin,-state->scrollRect.Ymin);
+	m = parentmatrix.multiplyMatrix(m);
+	ColorTransformBase ct = parentct;
+	ct = ct.multiplyTransform(state->colortransform);
+
+	// masks, filters and blend modes of containers are applied to the composited content of the surface and its children
+	cairo_surface_t* masksurface = nullptr;
+	if (!drawingMask && !state->mask.isNull())
+		masksurface = renderMask(state->mask.getPtr(), parentmatrix);
+	bool hasFilters = !drawingMask && !surface->softwareFilters.empty();
+	bool needsGroup = !drawingMask
+					  && (masksurface || hasFilters
+						  || (state->blendmode != BLENDMODE_NORMAL && !state->childrenlist.empty()));
+
+	cairo_save(cr);
+	if (state->scrollRect.Xmin || state->scrollRect.Xmax || state->scrollRect.Ymin || state->scrollRect.Ymax)
+	{
+		cairo_set_matrix(cr, &m);
+		cairo_rectangle(cr, state->scrollRect.Xmin, state->scrollRect.Ymin,
+						state->scrollRect.Xmax-state->scrollRect.Xmin, state->scrollRect.Ymax-state->scrollRect.Ymin);
+		cairo_identity_matrix(cr);
+		cairo_clip(cr);
+	}
+	if (hasFilters)
+	{
+		// limit the size of the group to the area covered by the filtered content
+		RectF bounds = surface->boundsRectWithRenderTransform(m, initialMatrix);
+		cairo_rectangle(cr, floor(bounds.min.x), floor(bounds.min.y), ceil(bounds.max.x)-floor(bounds.min.x), ceil(bounds.max.y)-floor(bounds.min.y));
+		cairo_clip(cr);
+	}
+	if (needsGroup)
+		cairo_push_group(cr);
+	renderContent(cr, surface, m, ct, needsGroup ? BLENDMODE_NORMAL : state->blendmode, drawingMask);
+	if (needsGroup)
+	{
+		cairo_pattern_t* group = cairo_pop_group(cr);
+		if (hasFilters)
+			applyFilters(group, surface);
+		CairoRenderContext::setupRenderState(cr, state->blendmode, false, state->smoothing);
+		cairo_set_source(cr, group);
+		if (masksurface)
+			cairo_mask_surface(cr, masksurface, 0, 0);
+		else
+			cairo_paint(cr);
+		cairo_pattern_destroy(group);
+	}
+	cairo_restore(cr);
+	if (masksurface)
+		cairo_surface_destroy(masksurface);
+}
+
+void HeadlessRenderer::renderContent(cairo_t* cr, CachedSurface* surface, const MATRIX& m, const ColorTransformBase& ct, AS_BLENDMODE blendmode, bool drawingMask)
+{
+	SurfaceState* state = surface->getState();
+	renderRaster(cr, surface, m, ct, blendmode, drawingMask);
+
+	// draw the display list, the handling of clip depths follows CachedSurface::renderImpl()
+	int clipDepth = 0;
+	vector<pair<int, cairo_surface_t*>> clipDepthStack;
+	for (auto it = state->childrenlist.begin(); it != state->childrenlist.end(); ++it)
+	{
+		CachedSurface* child = (*it).getPtr();
+		SurfaceState* childstate = child->getState();
+		if (!childstate)
+			continue;
+		int depth = childstate->depth;
+		// Pop off masks (if any).
+		while (!clipDepthStack.empty() && clipDepth > 0 && depth > clipDepth)
+		{
+			cairo_pop_group_to_source(cr);
+			cairo_mask_surface(cr, clipDepthStack.back().second, 0, 0);
+			cairo_surface_destroy(clipDepthStack.back().second);
+			clipDepth = clipDepthStack.back().first;
+			clipDepthStack.pop_back();
+		}
+
+		if (childstate->clipdepth > 0 && childstate->allowAsMask)
+		{
+			// Push, and render this mask.
+			cairo_surface_t* clipmask = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+			cairo_t* maskcr = cairo_create(clipmask);
+			renderSurface(maskcr, child, m, nullptr, ColorTransformBase(), true);
+			cairo_destroy(maskcr);
+			clipDepthStack.push_back(make_pair(clipDepth, clipmask));
+			clipDepth = childstate->clipdepth;
+			cairo_push_group(cr);
+		}
+		else if ((childstate->visible && !childstate->clipdepth && !childstate->isMask) || drawingMask)
+			renderSurface(cr, child, m, nullptr, ct, drawingMask);
+	}
+
+	// Pop remaining masks (if any).
+	while (!clipDepthStack.empty())
+	{
+		cairo_pop_group_to_source(cr);
+		cairo_mask_surface(cr, clipDepthStack.back().second, 0, 0);
+		cairo_surface_destroy(clipDepthStack.back().second);
+		clipDepthStack.pop_back();
+	}
+}
+
+void HeadlessRenderer::renderRaster(cairo_t* cr, CachedSurface* surface, const MATRIX& m, const ColorTransformBase& ct, AS_BLENDMODE blendmode, bool drawingMask)
+{
+	SoftwareRaster& r = surface->softwareRaster;
+	if (!surface->isValid || !surface->isInitialized || r.pixels.empty())
+		return;
+	if (r.xContentScale == 0 || r.yContentScale == 0)
+		return;
+	SurfaceState* state = surface->getState();
+	uint8_t* data = r.pixels.data();
+	vector<uint8_t> transformed;
+	if (!drawingMask && !ct.isIdentity())
+	{
+		transformed = r.pixels;
+		ct.applyTransformation(transformed.data(), transformed.size());
+		data = transformed.data();
+	}
+	cairo_surface_t* source = cairo_image_surface_create_for_data(data, CAIRO_FORMAT_ARGB32, r.width, r.height,
+																  cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, r.width));
+	// place the raster the same way as GLRenderContext::renderTextured() places the texture
+	MATRIX rastermatrix(1.0/r.xContentScale, 1.0/r.yContentScale, 0, 0, r.xOffset/r.xContentScale, r.yOffset/r.yContentScale);
+	rastermatrix = m.multiplyMatrix(rastermatrix);
+
+	cairo_save(cr);
+	CairoRenderContext::setupRenderState(cr, drawingMask ? BLENDMODE_NORMAL : blendmode, drawingMask, state->smoothing);
+	cairo_set_matrix(cr, &rastermatrix);
+	cairo_set_source_surface(cr, source, 0, 0);
+	cairo_pattern_set_filter(cairo_get_source(cr), state->smoothing == SMOOTH_MODE::SMOOTH_NONE ? CAIRO_FILTER_NEAREST : CAIRO_FILTER_BILINEAR);
+	cairo_rectangle(cr, 0, 0, r.width, r.height);
+	cairo_clip(cr);
+	if (drawingMask || state->alpha >= 1.0)
+		cairo_paint(cr);
+	else
+		cairo_paint_with_alpha(cr, state->alpha);
+	cairo_restore(cr);
+	cairo_surface_destroy(source);
+}
+
+cairo_surface_t* HeadlessRenderer::renderMask(CachedSurface* mask, const MATRIX& parentmatrix)
+{
+	cairo_surface_t* masksurface = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+	cairo_t* maskcr = cairo_create(masksurface);
+	renderSurface(maskcr, mask, parentmatrix, nullptr, ColorTransformBase(), true);
+	cairo_destroy(maskcr);
+	return masksurface;
+}
+
+void HeadlessRenderer::applyFilters(cairo_pattern_t* group, CachedSurface* surface)
+{
+	cairo_surface_t* target = nullptr;
+	if (cairo_pattern_get_surface(group, &target) != CAIRO_STATUS_SUCCESS
+		|| cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE)
+		return;
+	cairo_surface_flush(target);
+	int w = cairo_image_surface_get_width(target);
+	int h = cairo_image_surface_get_height(target);
+	if (w <= 0 || h <= 0)
+		return;
+	uint8_t* data = cairo_image_surface_get_data(target);
+	_R<BitmapContainer> bc = _MR(new BitmapContainer(nullptr));
+	bc->fromRawData(data, w, h);
+	for (auto it = surface->softwareFilters.begin(); it != surface->softwareFilters.end(); ++it)
+		(*it)->applyFilter(bc.getPtr(), nullptr, RECT(0,w,0,h), 0, 0, initialMatrix.getScaleX(), initialMatrix.getScaleY());
+	memcpy(data, bc->getData(), w*h*4);
+	cairo_surface_mark_dirty(target);
+}
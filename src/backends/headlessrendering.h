@@ -0,0 +1,81 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef BACKENDS_HEADLESSRENDERING_H
+#define BACKENDS_HEADLESSRENDERING_H 1
+
+#include "forwards/swf.h"
+#include "forwards/scripting/flash/display/DisplayObject.h"
+#include "forwards/backends/cachedsurface.h"
+#include "forwards/backends/graphics.h"
+#include "smartrefs.h"
+#include "swftypes.h"
+#include "tiny_string.h"
+#include <cairo.h>
+
+namespace lightspark
+{
+
+/*
+ * Renders the stage on the cpu with cairo, without the need for an OpenGL context.
+ * It is used instead of the RenderThread when rendering is disabled and every frame is written as a png file.
+ * All methods are called from the vm thread.
+ */
+class HeadlessRenderer
+{
+private:
+	SystemState* m_sys;
+	tiny_string outputDirectory;
+	// number of frames to write before shutting down, 0 means no limit
+	uint32_t frameLimit;
+	uint32_t frameCount;
+	// start the next frame as soon as this one is written, so rendering is not limited to real time
+	bool fastForward;
+	uint32_t width;
+	uint32_t height;
+	cairo_surface_t* stageSurface;
+	MATRIX initialMatrix;
+	void rasterize(CachedSurface* surface, IDrawable* d);
+	bool isRasterUsable(const CachedSurface* surface, const IDrawable* d) const;
+	/*
+	 * renders the surface and its children to cr, the matrix of cr is always the identity
+	 * parentmatrix and parentct are the accumulated transformations of the parents
+	 */
+	void renderSurface(cairo_t* cr, CachedSurface* surface, const MATRIX& parentmatrix, const MATRIX* startmatrix,
+					   const ColorTransformBase& parentct, bool drawingMask);
+	void renderContent(cairo_t* cr, CachedSurface* surface, const MATRIX& m, const ColorTransformBase& ct, AS_BLENDMODE blendmode, bool drawingMask);
+	void renderRaster(cairo_t* cr, CachedSurface* surface, const MATRIX& m, const ColorTransformBase& ct, AS_BLENDMODE blendmode, bool drawingMask);
+	// returns a new alpha surface of the size of the stage containing the rendered mask
+	cairo_surface_t* renderMask(CachedSurface* mask, const MATRIX& parentmatrix);
+	void applyFilters(cairo_pattern_t* group, CachedSurface* surface);
+	void writeFrame();
+public:
+	HeadlessRenderer(SystemState* s, const tiny_string& dir, uint32_t limit, bool fastforward, uint32_t w, uint32_t h);
+	~HeadlessRenderer();
+	/*
+	 * updates the CachedSurface of the DisplayObject, the drawable is rasterized immediately if needed
+	 * this replaces the AsyncDrawJob and RenderThread::addRefreshableSurface when rendering headless
+	 */
+	void refreshSurface(IDrawable* d, _NR<DisplayObject> o);
+	// composites the stage and writes it to the output directory, schedules the next frame when fast forwarding
+	void renderFrame();
+};
+
+}
+#endif /* BACKENDS_HEADLESSRENDERING_H */
@@ -560,6 +560,10 @@ bool InputThread::handleKeyboardShortcuts(const LSKeyEvent& event)
 			handled = true;
 			m_sys->showProfilingData=!m_sys->showProfilingData;
 			break;
+		case AS3KEYCODE_R:
+			handled = true;
+			m_sys->showDamagedRegions=!m_sys->showDamagedRegions;
+			break;
 		case AS3KEYCODE_M:
 			handled = true;
 			m_sys->audioManager->toggleMuteAll();
@@ -63,10 +63,12 @@ void RenderThread::wait()
 
 RenderThread::RenderThread(SystemState* s):GLRenderContext(),
 	m_sys(s),status(CREATED),
-	prevUploadJob(nullptr),
+	prevUploadJob(nullptr),currentPixelUploadBuffer(0),pixelUploadOffset(0),usePixelUploadBuffers(false),
 	renderNeeded(false),uploadNeeded(false),resizeNeeded(false),newTextureNeeded(false),canrender(false),
 	event(0),newWidth(0),newHeight(0),scaleX(1),scaleY(1),
-	offsetX(0),offsetY(0),tempBufferAcquired(false),frameCount(0),secsCount(0),initialized(0),refreshNeeded(false),renderToBitmapContainerNeeded(false),
+	offsetX(0),offsetY(0),tempBufferAcquired(false),frameCount(0),secsCount(0),
+	stageFramebuffer(UINT32_MAX),stageRenderbuffer(UINT32_MAX),stageTextureID(UINT32_MAX),stageTextureWidth(0),stageTextureHeight(0),fullRedrawNeeded(true),
+	initialized(0),refreshNeeded(false),renderToBitmapContainerNeeded(false),filterPoolFrame(0),filterPoolBytes(0),
 	screenshotneeded(false),inSettings(false),
 	cairoTextureContextSettings(nullptr),cairoTextureContext(nullptr)
 {
@@ -118,6 +120,9 @@ void RenderThread::finalizeUpload()
 	u->contentScale(tex.xContentScale, tex.yContentScale);
 	u->contentOffset(tex.xOffset, tex.yOffset);
 	loadChunkBGRA(tex, w, h, u->upload(false));
+	// we don't know where the texture is rendered, so the whole stage has to be redrawn
+	if (!u->reportsDamage())
+		fullRedrawNeeded=true;
 	u->uploadFence();
 	prevUploadJob=nullptr;
 }
@@ -150,6 +155,7 @@ void RenderThread::init()
 	engineData->InitOpenGL();
 	commonGLInit();
 	commonGLResize();
+	initPixelUploadBuffers();
 	
 }
 
@@ -329,6 +335,7 @@ bool RenderThread::doRender(ThreadProfile* profile,Chronometer* chronometer)
 			
 			// render DisplayObject to texture
 			it->cachedsurface->Render(m_sys,*this,&it->initialMatrix,&(*it));
+			flushTextureBatch();
 			
 			// read rendered texture back into bitmapcontainer (no need for locking the bitmapcontainer as the worker thread is waiting until rendering is done)
 			// TODO should only be done "on demand" if pixels in bitmapcontainer are accessed later
@@ -578,8 +585,137 @@ void RenderThread::setModelView(const MATRIX& matrix)
 	setMatrixUniform(LSGL_MODELVIEW);
 }
 
+void RenderThread::acquireFilterFramebuffer(uint32_t w, uint32_t h, uint32_t& framebuffer, uint32_t& renderbuffer)
+{
+	for (auto it = filterFramebufferPool.begin(); it != filterFramebufferPool.end(); it++)
+	{
+		if (it->width == w && it->height == h)
+		{
+			framebuffer = it->id;
+			renderbuffer = it->renderbuffer;
+			filterPoolBytes -= uint64_t(w)*h;
+			filterFramebufferPool.erase(it);
+			engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(framebuffer);
+			engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(renderbuffer);
+			return;
+		}
+	}
+	framebuffer = engineData->exec_glGenFramebuffer();
+	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(framebuffer);
+	renderbuffer = engineData->exec_glGenRenderbuffer();
+	engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(renderbuffer);
+	engineData->exec_glRenderbufferStorage_GL_RENDERBUFFER_GL_STENCIL_INDEX8(w, h);
+	engineData->exec_glFramebufferRenderbuffer_GL_FRAMEBUFFER_GL_STENCIL_ATTACHMENT(renderbuffer);
+}
+
+void RenderThread::releaseFilterFramebuffer(uint32_t framebuffer, uint32_t renderbuffer, uint32_t w, uint32_t h)
+{
+	FilterPoolEntry e;
+	e.id = framebuffer;
+	e.renderbuffer = renderbuffer;
+	e.width = w;
+	e.height = h;
+	e.lastUsed = filterPoolFrame;
+	filterFramebufferPool.push_back(e);
+	// the renderbuffer only contains the 8 bit stencil
+	filterPoolBytes += uint64_t(w)*h;
+	trimFilterPoolSize();
+}
+
+uint32_t RenderThread::acquireFilterTexture(uint32_t w, uint32_t h)
+{
+	uint32_t id;
+	for (auto it = filterTexturePool.begin(); it != filterTexturePool.end(); it++)
+	{
+		if (it->width == w && it->height == h)
+		{
+			id = it->id;
+			filterPoolBytes -= uint64_t(w)*h*4;
+			filterTexturePool.erase(it);
+			engineData->exec_glBindTexture_GL_TEXTURE_2D(id);
+			return id;
+		}
+	}
+	engineData->exec_glGenTextures(1, &id);
+	engineData->exec_glBindTexture_GL_TEXTURE_2D(id);
+	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
+	engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_NEAREST();
+	engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, w, h, 0, nullptr,true);
+	return id;
+}
+
+void RenderThread::releaseFilterTexture(uint32_t id, uint32_t w, uint32_t h)
+{
+	FilterPoolEntry e;
+	e.id = id;
+	e.renderbuffer = UINT32_MAX;
+	e.width = w;
+	e.height = h;
+	e.lastUsed = filterPoolFrame;
+	filterTexturePool.push_back(e);
+	filterPoolBytes += uint64_t(w)*h*4;
+	trimFilterPoolSize();
+}
+
+void RenderThread::trimFilterPool(bool all)
+{
+	auto it = filterFramebufferPool.begin();
+	while (it != filterFramebufferPool.end())
+	{
+		if (all || filterPoolFrame-it->lastUsed > FILTERPOOL_MAXAGE)
+		{
+			engineData->exec_glDeleteFramebuffers(1,&it->id);
+			engineData->exec_glDeleteRenderbuffers(1,&it->renderbuffer);
+			filterPoolBytes -= uint64_t(it->width)*it->height;
+			it = filterFramebufferPool.erase(it);
+		}
+		else
+			it++;
+	}
+	it = filterTexturePool.begin();
+	while (it != filterTexturePool.end())
+	{
+		if (all || filterPoolFrame-it->lastUsed > FILTERPOOL_MAXAGE)
+		{
+			engineData->exec_glDeleteTextures(1,&it->id);
+			filterPoolBytes -= uint64_t(it->width)*it->height*4;
+			it = filterTexturePool.erase(it);
+		}
+		else
+			it++;
+	}
+}
+
+void RenderThread::trimFilterPoolSize()
+{
+	// entries are added at the end of the pools, so the first entries are the ones unused for the longest time
+	while (filterPoolBytes > FILTERPOOL_MAXBYTES)
+	{
+		bool framebufferIsOlder = !filterFramebufferPool.empty()
+				&& (filterTexturePool.empty() || filterFramebufferPool.front().lastUsed <= filterTexturePool.front().lastUsed);
+		if (framebufferIsOlder)
+		{
+			FilterPoolEntry& e = filterFramebufferPool.front();
+			engineData->exec_glDeleteFramebuffers(1,&e.id);
+			engineData->exec_glDeleteRenderbuffers(1,&e.renderbuffer);
+			filterPoolBytes -= uint64_t(e.width)*e.height;
+			filterFramebufferPool.erase(filterFramebufferPool.begin());
+		}
+		else if (!filterTexturePool.empty())
+		{
+			FilterPoolEntry& e = filterTexturePool.front();
+			engineData->exec_glDeleteTextures(1,&e.id);
+			filterPoolBytes -= uint64_t(e.width)*e.height*4;
+			filterTexturePool.erase(filterTexturePool.begin());
+		}
+		else
+			break;
+	}
+}
+
 void RenderThread::renderTextureToFrameBuffer(uint32_t filterTextureID, uint32_t w, uint32_t h, float* filterdata, float* gradientcolors, bool isFirstFilter, bool flippedvertical, bool clearstate, bool renderstage3d)
 {
+	flushTextureBatch();
 	if (filterdata)
 	{
 		// last values of filterdata are always width and height
@@ -695,6 +831,7 @@ void RenderThread::signalSurfaceRefresh()
 void RenderThread::deinit()
 {
 	engineData->exec_glDisable_GL_TEXTURE_2D();
+	deinitPixelUploadBuffers();
 	commonGLDeinit();
 	engineData->DeinitOpenGL();
 }
@@ -764,6 +901,8 @@ void RenderThread::commonGLDeinit()
 {
 	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(0);
 	engineData->exec_glFrontFace(false);
+	deleteStageFramebuffer();
+	trimFilterPool(true);
 	for(uint32_t i=0;i<largeTextures.size();i++)
 	{
 		engineData->exec_glDeleteTextures(1,&largeTextures[i].id);
@@ -812,6 +951,9 @@ void RenderThread::commonGLInit()
 	tex=engineData->exec_glGetUniformLocation(gpu_program,"g_tex_filter2");
 	if(tex!=-1)
 		engineData->exec_glUniform1i(tex,SAMPLEPOSITION::SAMPLEPOS_FILTER_DST);
+	tex=engineData->exec_glGetUniformLocation(gpu_program,"g_tex_filter_map");
+	if(tex!=-1)
+		engineData->exec_glUniform1i(tex,SAMPLEPOSITION::SAMPLEPOS_FILTER_MAP);
 	
 	//The uniform that enables YUV->RGB transform on the texels (needed for video)
 	yuvUniform =engineData->exec_glGetUniformLocation(gpu_program,"yuv");
@@ -1030,6 +1172,20 @@ void RenderThread::plotProfilingData()
 	list<ThreadProfile*>::iterator it=m_sys->profilingData.begin();
 	for(;it!=m_sys->profilingData.end();++it)
 		(*it)->plot(1000000/m_sys->mainClip->applicationDomain->getFrameRate(),cr);
+
+	uint32_t cachehits, cachemisses;
+	uint64_t cachememory;
+	m_sys->getRasterCache()->getStatistics(cachehits,cachemisses,cachememory);
+	char cacheBuf[80];
+	snprintf(cacheBuf,80,"Raster cache: %u hits %u misses %u KiB",cachehits,cachemisses,uint32_t(cachememory/1024));
+	cairo_set_source_rgb(cr, 1, 1, 1);
+	renderText(cr, cacheBuf, 0, windowHeight-12);
+
+	uint32_t atlastextures, atlasusedblocks, atlastotalblocks, atlasfragmentation;
+	getTextureAtlasStatistics(atlastextures,atlasusedblocks,atlastotalblocks,atlasfragmentation);
+	char atlasBuf[80];
+	snprintf(atlasBuf,80,"Texture atlas: %u textures %u/%u blocks used %u%% fragmented",atlastextures,atlasusedblocks,atlastotalblocks,atlasfragmentation);
+	renderText(cr, atlasBuf, 0, windowHeight-24);
 	engineData->exec_glUniform1f(directUniform, 0);
 	engineData->exec_glUniform4f(colortransMultiplyUniform, 1.0,1.0,1.0,1.0);
 	engineData->exec_glUniform4f(colortransAddUniform, 0.0,0.0,0.0,0.0);
@@ -1224,6 +1380,133 @@ void RenderThread::removeDebugRect()
 		debugRects.pop_back();
 }
 
+void RenderThread::setupStageFramebuffer()
+{
+	if (stageFramebuffer == UINT32_MAX || stageTextureWidth != windowWidth || stageTextureHeight != windowHeight)
+	{
+		deleteStageFramebuffer();
+		engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
+		engineData->exec_glGenTextures(1, &stageTextureID);
+		stageFramebuffer = engineData->exec_glGenFramebuffer();
+		engineData->exec_glBindTexture_GL_TEXTURE_2D(stageTextureID);
+		engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(stageFramebuffer);
+		stageRenderbuffer = engineData->exec_glGenRenderbuffer();
+		engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(stageRenderbuffer);
+		if (engineData->supportPackedDepthStencil)
+		{
+			engineData->exec_glRenderbufferStorage_GL_RENDERBUFFER_GL_DEPTH_STENCIL(windowWidth,windowHeight);
+			engineData->exec_glFramebufferRenderbuffer_GL_FRAMEBUFFER_GL_DEPTH_STENCIL_ATTACHMENT(stageRenderbuffer);
+		}
+		else
+		{
+			engineData->exec_glRenderbufferStorage_GL_RENDERBUFFER_GL_STENCIL_INDEX8(windowWidth,windowHeight);
+			engineData->exec_glFramebufferRenderbuffer_GL_FRAMEBUFFER_GL_STENCIL_ATTACHMENT(stageRenderbuffer);
+		}
+		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
+		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_NEAREST();
+		engineData->exec_glFramebufferTexture2D_GL_FRAMEBUFFER(stageTextureID);
+		engineData->exec_glTexImage2D_GL_TEXTURE_2D_GL_UNSIGNED_BYTE(0, windowWidth, windowHeight, 0, nullptr,true);
+		stageTextureWidth=windowWidth;
+		stageTextureHeight=windowHeight;
+		fullRedrawNeeded=true;
+	}
+	else
+	{
+		engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(stageFramebuffer);
+		engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(stageRenderbuffer);
+	}
+	// filters return to this framebuffer after rendering
+	baseFramebuffer=stageFramebuffer;
+	baseRenderbuffer=stageRenderbuffer;
+}
+
+void RenderThread::deleteStageFramebuffer()
+{
+	if (stageFramebuffer == UINT32_MAX)
+		return;
+	engineData->exec_glDeleteFramebuffers(1,&stageFramebuffer);
+	engineData->exec_glDeleteRenderbuffers(1,&stageRenderbuffer);
+	engineData->exec_glDeleteTextures(1,&stageTextureID);
+	stageFramebuffer=UINT32_MAX;
+	stageRenderbuffer=UINT32_MAX;
+	stageTextureID=UINT32_MAX;
+}
+
+//Border around the damaged region in pixels, to cover antialiasing and texture filtering
+#define DAMAGE_BORDER 2
+bool RenderThread::setupDamagedRegion(const MATRIX& initialMatrix, const RGB& bg, RectF& damage)
+{
+	bool hasDamage=false;
+	bool fullRedraw=fullRedrawNeeded || bg.toUInt() != stageBackground.toUInt();
+	m_sys->stage->getCachedSurface()->collectDamage(MATRIX(),&initialMatrix,initialMatrix,damage,hasDamage,fullRedraw);
+	stageBackground=bg;
+	fullRedrawNeeded=false;
+	if (!fullRedraw && !hasDamage)
+		return false;
+	//Convert to window coordinates
+	int32_t x1=0;
+	int32_t y1=0;
+	int32_t x2=windowWidth;
+	int32_t y2=windowHeight;
+	if (!fullRedraw)
+	{
+		x1=max(int32_t(floor(damage.min.x))+offsetX-DAMAGE_BORDER,0);
+		y1=max(int32_t(floor(damage.min.y))+offsetY-DAMAGE_BORDER,0);
+		x2=min(int32_t(ceil(damage.max.x))+offsetX+DAMAGE_BORDER,int32_t(windowWidth));
+		y2=min(int32_t(ceil(damage.max.y))+offsetY+DAMAGE_BORDER,int32_t(windowHeight));
+		if (x2 <= x1 || y2 <= y1)
+			return false;
+	}
+	damage=RectF { Vector2f(x1,y1), Vector2f(x2,y2) };
+	//The scissor box has its origin at the bottom of the window
+	setDamageScissor(x1,windowHeight-y2,x2-x1,y2-y1);
+	return true;
+}
+
+void RenderThread::renderStageTexture()
+{
+	baseFramebuffer=0;
+	baseRenderbuffer=0;
+	resetCurrentFrameBuffer();
+	engineData->exec_glClear(CLEARMASK(CLEARMASK::COLOR|CLEARMASK::DEPTH|CLEARMASK::STENCIL));
+	setupRenderingState(1.0,ColorTransformBase(),SMOOTH_MODE::SMOOTH_ANTIALIAS,BLENDMODE_NORMAL);
+	//The texture has the same orientation as the window, so it is rendered without flipping
+	lsglLoadIdentity();
+	lsglOrtho(0,windowWidth,0,windowHeight,-100,0);
+	setMatrixUniform(LSGL_PROJECTION);
+	lsglLoadIdentity();
+	setMatrixUniform(LSGL_MODELVIEW);
+	renderTextureToFrameBuffer(stageTextureID,windowWidth,windowHeight,nullptr,nullptr,false,false);
+	resetViewPort();
+}
+
+void RenderThread::drawDamagedRegion(const RectF& damage)
+{
+	lsglLoadIdentity();
+	lsglScalef(1.0f,1.0f,1);
+	lsglTranslatef(-offsetX,-offsetY,0);
+	setMatrixUniform(LSGL_MODELVIEW);
+
+	cairo_t *cr = getCairoContext(windowWidth, windowHeight);
+
+	cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+	cairo_set_source_rgba(cr, 1, 0, 0, 0.8);
+	cairo_set_line_width(cr, 2);
+	cairo_rectangle(cr, damage.min.x+1, damage.min.y+1, damage.max.x-damage.min.x-2, damage.max.y-damage.min.y-2);
+	cairo_stroke(cr);
+
+	engineData->exec_glUniform1f(directUniform, 0);
+	engineData->exec_glUniform1f(alphaUniform, 1);
+	engineData->exec_glUniform4f(colortransMultiplyUniform, 1.0,1.0,1.0,1.0);
+	engineData->exec_glUniform4f(colortransAddUniform, 0.0,0.0,0.0,0.0);
+	mapCairoTexture(windowWidth, windowHeight);
+
+	cairo_save(cr);
+	cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+	cairo_paint(cr);
+	cairo_restore(cr);
+}
+
 void RenderThread::coreRendering()
 {
 	Locker l(mutexRendering);
@@ -1233,20 +1516,44 @@ void RenderThread::coreRendering()
 	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(0);
 	engineData->exec_glFrontFace(false);
 	engineData->exec_glDrawBuffer_GL_BACK();
-	if (!m_sys->stage->renderStage3D()) // no need to clear the backbuffer when using Stage3D
-	{
-		//Clear the back buffer
-		RGB bg=m_sys->mainClip->getBackground();
-		engineData->exec_glClearColor(bg.Red/255.0F,bg.Green/255.0F,bg.Blue/255.0F,1);
-		engineData->exec_glClear(CLEARMASK(CLEARMASK::COLOR|CLEARMASK::DEPTH|CLEARMASK::STENCIL));
-	}
+	RGB bg=m_sys->mainClip->getBackground();
+	engineData->exec_glClearColor(bg.Red/255.0F,bg.Green/255.0F,bg.Blue/255.0F,1);
 	engineData->exec_glUseProgram(gpu_program);
-	lsglLoadIdentity();
-	setMatrixUniform(LSGL_MODELVIEW);
 	Vector2f scale = getScale();
 	MATRIX initialMatrix;
 	initialMatrix.scale(scale.x, scale.y);
-	m_sys->stage->render(*this,&initialMatrix);
+	if (m_sys->stage->renderStage3D())
+	{
+		// stage3d content is rendered directly to the back buffer, so the whole stage is rendered every frame
+		// no need to clear the backbuffer when using Stage3D
+		fullRedrawNeeded=true;
+		lsglLoadIdentity();
+		setMatrixUniform(LSGL_MODELVIEW);
+		m_sys->stage->render(*this,&initialMatrix);
+		flushTextureBatch();
+	}
+	else
+	{
+		// the stage is kept in its own framebuffer, so only the regions that have changed since the last frame are rendered
+		setupStageFramebuffer();
+		RectF damage;
+		bool hasDamage=setupDamagedRegion(initialMatrix,bg,damage);
+		if (hasDamage)
+		{
+			//Clear the damaged region
+			engineData->exec_glClear(CLEARMASK(CLEARMASK::COLOR|CLEARMASK::DEPTH|CLEARMASK::STENCIL));
+			lsglLoadIdentity();
+			setMatrixUniform(LSGL_MODELVIEW);
+			m_sys->stage->render(*this,&initialMatrix);
+			clearDamageScissor();
+		}
+		renderStageTexture();
+		if (hasDamage && m_sys->showDamagedRegions)
+			drawDamagedRegion(damage);
+	}
+	LOG(LOG_TRACE,"textured quads rendered:"<<batchQuadCount<<" draw calls:"<<batchDrawCount);
+	batchQuadCount=0;
+	batchDrawCount=0;
 
 	for (auto it : debugRects)
 		drawDebugRect(it.pos.x, it.pos.y, it.size.x, it.size.y, it.matrix, it.onlyTranslate);
@@ -1261,6 +1568,8 @@ void RenderThread::coreRendering()
 		engineData->exec_glDeleteTextures(1,&id);
 		texturesToDelete.pop_front();
 	}
+	filterPoolFrame++;
+	trimFilterPool();
 	handleGLErrors();
 	canrender=false;
 }
@@ -1379,9 +1688,8 @@ void RenderThread::tickFence()
 
 void RenderThread::releaseTexture(const TextureChunk& chunk)
 {
-	uint32_t blocksW=(chunk.width+CHUNKSIZE-1)/CHUNKSIZE;
-	uint32_t blocksH=(chunk.height+CHUNKSIZE-1)/CHUNKSIZE;
-	uint32_t numberOfBlocks=blocksW*blocksH;
+	// the chunk may have been shrunk by resizeIfLargeEnough, so release all the blocks it was allocated with
+	uint32_t numberOfBlocks=chunk.allocatedChunks;
 	Locker l(mutexLargeTexture);
 	LargeTexture& tex=largeTextures[chunk.texId];
 	for(uint32_t i=0;i<numberOfBlocks;i++)
@@ -1390,6 +1698,8 @@ void RenderThread::releaseTexture(const TextureChunk& chunk)
 		assert(tex.bitmap[bitOffset/8]&(1<<(bitOffset%8)));
 		tex.bitmap[bitOffset/8]^=(1<<(bitOffset%8));
 	}
+	assert(tex.usedBlocks>=numberOfBlocks);
+	tex.usedBlocks-=numberOfBlocks;
 }
 
 uint32_t RenderThread::allocateNewGLTexture() const
@@ -1414,6 +1724,8 @@ uint32_t RenderThread::allocateNewGLTexture() const
 
 RenderThread::LargeTexture& RenderThread::allocateNewTexture(bool direct)
 {
+	if (!largeTextures.empty())
+		logTextureAtlasStatistics();
 	if (!direct)
 	{
 		//Signal that a new texture is needed
@@ -1431,37 +1743,40 @@ RenderThread::LargeTexture& RenderThread::allocateNewTexture(bool direct)
 
 bool RenderThread::allocateChunkOnTextureCompact(LargeTexture& tex, TextureChunk& ret, uint32_t blocksW, uint32_t blocksH)
 {
-	//Find a contiguos set of blocks
-	uint32_t start;
+	//Find a contiguos rectangle of blocks
 	uint32_t blockPerSide=largeTextureSize/CHUNKSIZE;
 	uint32_t bitmapSize=blockPerSide*blockPerSide;
-	for(start=0;start<bitmapSize;start++)
+	if(blocksW>blockPerSide || blocksH>blockPerSide || tex.usedBlocks+blocksW*blocksH>bitmapSize)
+		return false;
+	// for every column this counts the consecutive rows up to the current one that have
+	// at least blocksW free blocks starting at that column, so the bitmap is scanned only once
+	std::vector<uint32_t> freeRows(blockPerSide,0);
+	uint32_t start=UINT32_MAX;
+	for(uint32_t y=0;y<blockPerSide && start==UINT32_MAX;y++)
 	{
-		bool badRect=false;
-		//TODO: correct rect lookup
-		for(uint32_t i=0;i<blocksH;i++)
+		uint32_t freeRun=0;
+		for(uint32_t x=blockPerSide;x>0;x--)
+		{
+			uint32_t bitOffset=y*blockPerSide+x-1;
+			if(tex.bitmap[bitOffset/8]&(1<<(bitOffset%8)))
+				freeRun=0;
+			else
+				freeRun++;
+			if(freeRun>=blocksW)
+				freeRows[x-1]++;
+			else
+				freeRows[x-1]=0;
+		}
+		for(uint32_t x=0;x+blocksW<=blockPerSide;x++)
 		{
-			for(uint32_t j=0;j<blocksW;j++)
+			if(freeRows[x]>=blocksH)
 			{
-				uint32_t bitOffset=start+i*blockPerSide+j;
-				if(bitOffset>=bitmapSize)
-				{
-					badRect=true;
-					break;
-				}
-				if(tex.bitmap[bitOffset/8]&(1<<(bitOffset%8)))
-				{
-					badRect=true;
-					break;
-				}
-			}
-			if(badRect)
+				start=(y+1-blocksH)*blockPerSide+x;
 				break;
+			}
 		}
-		if(!badRect)
-			break;
 	}
-	if(start==bitmapSize)
+	if(start==UINT32_MAX)
 		return false;
 	//Now set all those blocks are used
 	for(uint32_t i=0;i<blocksH;i++)
@@ -1473,6 +1788,7 @@ bool RenderThread::allocateChunkOnTextureCompact(LargeTexture& tex, TextureChunk
 			ret.chunks[i*blocksW+j]=bitOffset;
 		}
 	}
+	tex.usedBlocks+=blocksW*blocksH;
 	return true;
 }
 
@@ -1482,37 +1798,96 @@ bool RenderThread::allocateChunkOnTextureSparse(LargeTexture& tex, TextureChunk&
 	uint32_t found=0;
 	uint32_t blockPerSide=largeTextureSize/CHUNKSIZE;
 	uint32_t bitmapSize=blockPerSide*blockPerSide;
+	uint32_t numberOfBlocks=blocksW*blocksH;
+	// the free blocks are counted, so full textures are skipped without scanning them
+	if(tex.usedBlocks+numberOfBlocks>bitmapSize)
+		return false;
 	//TODO: use the already allocated array
-	uint32_t* tmp=new uint32_t[blocksW*blocksH];
+	uint32_t* tmp=new uint32_t[numberOfBlocks];
 	for(uint32_t i=0;i<bitmapSize;i++)
 	{
+		if(i%8==0 && tex.bitmap[i/8]==0xff)
+		{
+			// skip fully used bytes
+			i+=7;
+			continue;
+		}
 		if((tex.bitmap[i/8]&(1<<(i%8)))==0)
 		{
 			tex.bitmap[i/8]|=1<<(i%8);
 			tmp[found]=i;
 			found++;
-			if(found==(blocksW*blocksH))
+			if(found==numberOfBlocks)
 				break;
 		}
 	}
-	if(found<blocksW*blocksH)
+	assert(found==numberOfBlocks);
+	tex.usedBlocks+=numberOfBlocks;
+	delete[] ret.chunks;
+	ret.chunks=tmp;
+	return true;
+}
+
+void RenderThread::getLargeTextureFreeRuns(const LargeTexture& tex, uint32_t& freeRuns, uint32_t& largestRun) const
+{
+	uint32_t blockPerSide=largeTextureSize/CHUNKSIZE;
+	largestRun=0;
+	freeRuns=0;
+	for(uint32_t y=0;y<blockPerSide;y++)
 	{
-		//This is considered the unfrequent case
-		for(uint32_t i=0;i<found;i++)
+		uint32_t run=0;
+		for(uint32_t x=0;x<=blockPerSide;x++)
 		{
-			uint32_t bitOffset=tmp[i];
-			assert(tex.bitmap[bitOffset/8]&(1<<(bitOffset%8)));
-			tex.bitmap[bitOffset/8]^=(1<<(bitOffset%8));
+			uint32_t bitOffset=y*blockPerSide+x;
+			if(x<blockPerSide && (tex.bitmap[bitOffset/8]&(1<<(bitOffset%8)))==0)
+				run++;
+			else if(run)
+			{
+				freeRuns++;
+				largestRun=max(largestRun,run);
+				run=0;
+			}
 		}
-		delete[] tmp;
-		return false;
 	}
-	else
+}
+
+void RenderThread::logTextureAtlasStatistics() const
+{
+	uint32_t blockPerSide=largeTextureSize/CHUNKSIZE;
+	uint32_t bitmapSize=blockPerSide*blockPerSide;
+	for(uint32_t i=0;i<largeTextures.size();i++)
 	{
-		delete[] ret.chunks;
-		ret.chunks=tmp;
-		return true;
+		const LargeTexture& tex=largeTextures[i];
+		// the fragmentation is the part of the free blocks that are not in the largest horizontal run of free blocks
+		uint32_t largestRun;
+		uint32_t freeRuns;
+		getLargeTextureFreeRuns(tex,freeRuns,largestRun);
+		uint32_t freeBlocks=bitmapSize-tex.usedBlocks;
+		LOG(LOG_INFO,"large texture "<<i<<": "<<tex.usedBlocks<<"/"<<bitmapSize<<" blocks used, "<<freeRuns<<" free runs, fragmentation "
+			<<(freeBlocks ? 100*(freeBlocks-largestRun)/freeBlocks : 0)<<"%");
+	}
+}
+
+void RenderThread::getTextureAtlasStatistics(uint32_t& textures, uint32_t& usedBlocks, uint32_t& totalBlocks, uint32_t& fragmentation)
+{
+	Locker l(mutexLargeTexture);
+	uint32_t blockPerSide=largeTextureSize/CHUNKSIZE;
+	uint32_t bitmapSize=blockPerSide*blockPerSide;
+	uint32_t freeBlocks=0;
+	uint32_t fragmentedBlocks=0;
+	textures=largeTextures.size();
+	usedBlocks=0;
+	totalBlocks=textures*bitmapSize;
+	for(uint32_t i=0;i<largeTextures.size();i++)
+	{
+		uint32_t largestRun;
+		uint32_t freeRuns;
+		getLargeTextureFreeRuns(largeTextures[i],freeRuns,largestRun);
+		usedBlocks+=largeTextures[i].usedBlocks;
+		freeBlocks+=bitmapSize-largeTextures[i].usedBlocks;
+		fragmentedBlocks+=bitmapSize-largeTextures[i].usedBlocks-largestRun;
 	}
+	fragmentation=freeBlocks ? 100*fragmentedBlocks/freeBlocks : 0;
 }
 
 TextureChunk RenderThread::allocateTexture(uint32_t w, uint32_t h, bool compact, bool direct)
@@ -1562,6 +1937,100 @@ TextureChunk RenderThread::allocateTexture(uint32_t w, uint32_t h, bool compact,
 	return ret;
 }
 
+void RenderThread::initPixelUploadBuffers()
+{
+	usePixelUploadBuffers=engineData->supportPixelBufferObjects;
+	if (!usePixelUploadBuffers)
+		return;
+	for(uint32_t i=0;i<PIXELUPLOADBUFFER_COUNT;i++)
+	{
+		PixelUploadBuffer& buf=pixelUploadBuffers[i];
+		engineData->exec_glGenBuffers(1,&buf.id);
+		engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(buf.id);
+		buf.mapped=nullptr;
+		buf.fence=nullptr;
+		if (engineData->supportPersistentMapping)
+		{
+			engineData->exec_glBufferStorage_GL_PIXEL_UNPACK_BUFFER_GL_MAP_PERSISTENT_BIT(PIXELUPLOADBUFFER_SIZE);
+			buf.mapped=engineData->exec_glMapBufferRange_GL_PIXEL_UNPACK_BUFFER(0,PIXELUPLOADBUFFER_SIZE,true);
+		}
+		else
+			engineData->exec_glBufferData_GL_PIXEL_UNPACK_BUFFER_GL_STREAM_DRAW(PIXELUPLOADBUFFER_SIZE,nullptr);
+	}
+	engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(0);
+	currentPixelUploadBuffer=0;
+	pixelUploadOffset=0;
+	LOG(LOG_INFO,"using pixel buffer objects for texture uploads"<<(engineData->supportPersistentMapping ? " (persistently mapped)" : ""));
+}
+
+void RenderThread::deinitPixelUploadBuffers()
+{
+	if (!usePixelUploadBuffers)
+		return;
+	for(uint32_t i=0;i<PIXELUPLOADBUFFER_COUNT;i++)
+	{
+		PixelUploadBuffer& buf=pixelUploadBuffers[i];
+		if (buf.fence)
+			engineData->exec_glDeleteSync(buf.fence);
+		if (buf.mapped)
+		{
+			engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(buf.id);
+			engineData->exec_glUnmapBuffer_GL_PIXEL_UNPACK_BUFFER();
+		}
+		engineData->exec_glDeleteBuffers(1,&buf.id);
+	}
+	engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(0);
+	usePixelUploadBuffers=false;
+}
+
+uint8_t* RenderThread::mapPixelUploadBuffer(uint32_t size, uint32_t& offset)
+{
+	if (pixelUploadOffset+size > PIXELUPLOADBUFFER_SIZE)
+	{
+		// the current buffer is full, fence it and continue with the next one in the ring
+		pixelUploadBuffers[currentPixelUploadBuffer].fence=engineData->exec_glFenceSync();
+		currentPixelUploadBuffer=(currentPixelUploadBuffer+1)%PIXELUPLOADBUFFER_COUNT;
+		pixelUploadOffset=0;
+		PixelUploadBuffer& next=pixelUploadBuffers[currentPixelUploadBuffer];
+		engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(next.id);
+		// only blocks if the gpu is still copying from this buffer
+		if (next.fence)
+		{
+			engineData->exec_glClientWaitSync(next.fence);
+			engineData->exec_glDeleteSync(next.fence);
+			next.fence=nullptr;
+		}
+	}
+	offset=pixelUploadOffset;
+	// keep the uploads aligned to cache lines
+	pixelUploadOffset+=(size+63)&~63U;
+	PixelUploadBuffer& buf=pixelUploadBuffers[currentPixelUploadBuffer];
+	if (buf.mapped)
+		return buf.mapped+offset;
+	return engineData->exec_glMapBufferRange_GL_PIXEL_UNPACK_BUFFER(offset,size,false);
+}
+
+void RenderThread::unmapPixelUploadBuffer()
+{
+	if (!pixelUploadBuffers[currentPixelUploadBuffer].mapped)
+		engineData->exec_glUnmapBuffer_GL_PIXEL_UNPACK_BUFFER();
+}
+
+// copies one chunk from data to dst, adding a border of 1 pixel clamped to the edge
+// the destination is only written sequentially, as it may be write combined memory of a mapped buffer
+static void copyChunkClamped(uint8_t* dst, const uint8_t* data, uint32_t w, uint32_t curX, uint32_t curY, uint32_t sizeX, uint32_t sizeY)
+{
+	for (uint32_t j = 0; j < sizeY; j++)
+	{
+		const uint32_t srcY = curY+min(max(int(j)-1,0),int(sizeY-3));
+		const uint8_t* src = data+4*w*srcY+4*curX;
+		uint8_t* row = dst+4*j*sizeX;
+		memcpy(row, src, 4);
+		memcpy(row+4, src, (sizeX-2)*4);
+		memcpy(row+(sizeX-1)*4, src+(sizeX-3)*4, 4);
+	}
+}
+
 void RenderThread::loadChunkBGRA(const TextureChunk& chunk, uint32_t w, uint32_t h, uint8_t* data)
 {
 	//Fast bailout if the TextureChunk is not valid
@@ -1569,6 +2038,8 @@ void RenderThread::loadChunkBGRA(const TextureChunk& chunk, uint32_t w, uint32_t
 		return;
 	engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
 	engineData->exec_glBindTexture_GL_TEXTURE_2D(largeTextures[chunk.texId].id);
+	if (usePixelUploadBuffers)
+		engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(pixelUploadBuffers[currentPixelUploadBuffer].id);
 	//TODO: Detect continuos
 	//The size is ok if doesn't grow over the allocated size
 	//this allows some alignment freedom
@@ -1580,37 +2051,36 @@ void RenderThread::loadChunkBGRA(const TextureChunk& chunk, uint32_t w, uint32_t
 	{
 		uint32_t curX=(i%blocksW)*CHUNKSIZE_REAL;
 		uint32_t curY=(i/blocksW)*CHUNKSIZE_REAL;
-		if (curX > w || curY > h)
+		if (curX >= w || curY >= h)
 			break;
 		uint32_t sizeX=min(int(w-curX),CHUNKSIZE_REAL)+2;
 		uint32_t sizeY=min(int(h-curY),CHUNKSIZE_REAL)+2;
 		const uint32_t blockX=((chunk.chunks[i]%blocksPerSide)*CHUNKSIZE);
 		const uint32_t blockY=((chunk.chunks[i]/blocksPerSide)*CHUNKSIZE);
 
-		// copy chunk data
-		for(uint32_t j=1;j<sizeY-1;j++) {
-			memcpy(data_clamp+4*j*sizeX+4, data+4*w*((j-1)+curY)+4*curX, (sizeX-2)*4);
-		}
-		for (uint32_t j = 0; j < sizeY; j++)
+		if (usePixelUploadBuffers)
 		{
-			// clamp left border to edge
-			data_clamp[j*sizeX*4  ] = data_clamp[j*sizeX*4+4  ];
-			data_clamp[j*sizeX*4+1] = data_clamp[j*sizeX*4+4+1];
-			data_clamp[j*sizeX*4+2] = data_clamp[j*sizeX*4+4+2];
-			data_clamp[j*sizeX*4+3] = data_clamp[j*sizeX*4+4+3];
-	
-			// clamp right border to edge
-			data_clamp[j*sizeX*4 + (sizeX-1)*4  ] = data_clamp[j*sizeX*4 + (sizeX-2)*4  ];
-			data_clamp[j*sizeX*4 + (sizeX-1)*4+1] = data_clamp[j*sizeX*4 + (sizeX-2)*4+1];
-			data_clamp[j*sizeX*4 + (sizeX-1)*4+2] = data_clamp[j*sizeX*4 + (sizeX-2)*4+2];
-			data_clamp[j*sizeX*4 + (sizeX-1)*4+3] = data_clamp[j*sizeX*4 + (sizeX-2)*4+3];
+			// the texture is filled from the bound pixel buffer, so pixels is an offset into the buffer
+			uint32_t offset;
+			uint8_t* dst=mapPixelUploadBuffer(sizeX*sizeY*4,offset);
+			if (dst)
+			{
+				copyChunkClamped(dst, data, w, curX, curY, sizeX, sizeY);
+				unmapPixelUploadBuffer();
+				engineData->exec_glTexSubImage2D_GL_TEXTURE_2D(0, blockX, blockY, sizeX, sizeY, (const void*)uintptr_t(offset));
+				continue;
+			}
+			// mapping failed, fall back to uploading from client memory
+			LOG(LOG_ERROR,"mapping pixel buffer failed, disabling pixel buffer uploads");
+			engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(0);
+			deinitPixelUploadBuffers();
 		}
-		// clamp top border to edge
-		memcpy(data_clamp, data_clamp+4*sizeX, sizeX*4);
-		// clamp bottom border to edge
-		memcpy(data_clamp+(sizeY-1)*sizeX*4, data_clamp+(sizeY-2)*sizeX*4, sizeX*4);
+		copyChunkClamped(data_clamp, data, w, curX, curY, sizeX, sizeY);
 		engineData->exec_glTexSubImage2D_GL_TEXTURE_2D(0, blockX, blockY, sizeX, sizeY, data_clamp);
 	}
+	// other texture uploads use client memory, so the pixel buffer must not stay bound
+	if (usePixelUploadBuffers)
+		engineData->exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(0);
 }
 void RenderThread::renderDisplayObjectToBimapContainer(_NR<DisplayObject> o, const MATRIX &initialMatrix, bool smoothing, AS_BLENDMODE blendMode, ColorTransformBase *ct, _NR<BitmapContainer> bm)
 {
@@ -34,6 +34,13 @@ namespace lightspark
 {
 class ThreadProfile;
 
+#define FILTERPOOL_MAXAGE 60
+// maximum size of the unused textures and renderbuffers kept in the filter pool
+#define FILTERPOOL_MAXBYTES (64*1024*1024)
+
+#define PIXELUPLOADBUFFER_COUNT 4
+#define PIXELUPLOADBUFFER_SIZE (4*1024*1024)
+
 class DLL_PUBLIC RenderThread: public ITickJob, public GLRenderContext
 {
 friend class DisplayObject;
@@ -50,10 +57,34 @@ private:
 	void commonGLResize();
 	void commonGLDeinit();
 	ITextureUploadable* prevUploadJob;
+	/*
+	 * ring of pixel unpack buffers used by loadChunkBGRA, so that the texture uploads are
+	 * copied asynchronously by the driver instead of stalling the render loop
+	 */
+	struct PixelUploadBuffer
+	{
+		uint32_t id;
+		uint8_t* mapped; // only set if the buffer is mapped persistently
+		void* fence; // signaled when the gpu has consumed all uploads from this buffer
+	};
+	PixelUploadBuffer pixelUploadBuffers[PIXELUPLOADBUFFER_COUNT];
+	uint32_t currentPixelUploadBuffer;
+	uint32_t pixelUploadOffset;
+	bool usePixelUploadBuffers;
+	void initPixelUploadBuffers();
+	void deinitPixelUploadBuffers();
+	// returns writable memory for size bytes, offset is set to the position inside the currently bound buffer
+	uint8_t* mapPixelUploadBuffer(uint32_t size, uint32_t& offset);
+	void unmapPixelUploadBuffer();
 	uint32_t allocateNewGLTexture() const;
 	LargeTexture& allocateNewTexture(bool direct);
 	bool allocateChunkOnTextureCompact(LargeTexture& tex, TextureChunk& ret, uint32_t blocksW, uint32_t blocksH);
 	bool allocateChunkOnTextureSparse(LargeTexture& tex, TextureChunk& ret, uint32_t blocksW, uint32_t blocksH);
+	// counts the horizontal runs of free blocks of a large texture and the length of the largest one
+	void getLargeTextureFreeRuns(const LargeTexture& tex, uint32_t& freeRuns, uint32_t& largestRun) const;
+	void logTextureAtlasStatistics() const;
+	// occupancy of all large textures, fragmentation is the percentage of free blocks outside the largest free run of each texture
+	void getTextureAtlasStatistics(uint32_t& textures, uint32_t& usedBlocks, uint32_t& totalBlocks, uint32_t& fragmentation);
 	//Possible events to be handled
 	//TODO: pad to avoid false sharing on the cache lines
 	volatile bool renderNeeded;
@@ -93,6 +124,25 @@ private:
 	*/
 	void coreRendering();
 	void plotProfilingData();
+	/* Partial redraws */
+	// the stage is rendered to this framebuffer, so its content survives swapping the buffers
+	uint32_t stageFramebuffer;
+	uint32_t stageRenderbuffer;
+	uint32_t stageTextureID;
+	uint32_t stageTextureWidth;
+	uint32_t stageTextureHeight;
+	// the whole stage has to be rendered in the next frame
+	bool fullRedrawNeeded;
+	RGB stageBackground;
+	void setupStageFramebuffer();
+	void deleteStageFramebuffer();
+	/*
+		Computes the damaged region of the stage and restricts rendering to it
+		returns false if nothing has to be rendered
+	*/
+	bool setupDamagedRegion(const MATRIX& initialMatrix, const RGB& bg, RectF& damage);
+	void renderStageTexture();
+	void drawDamagedRegion(const RectF& damage);
 	Semaphore initialized;
 	volatile bool refreshNeeded;
 	Mutex mutexRefreshSurfaces;
@@ -104,6 +154,27 @@ private:
 
 	std::list<uint32_t> texturesToDelete;
 
+	/*
+	 * framebuffers and textures used for rendering filters are kept in a pool
+	 * so that filter passes don't allocate new gl objects every frame
+	 * entries not used for FILTERPOOL_MAXAGE frames are deleted, and the oldest entries are deleted
+	 * as long as the pool holds more than FILTERPOOL_MAXBYTES
+	 */
+	struct FilterPoolEntry
+	{
+		uint32_t id;
+		uint32_t renderbuffer; // only used for framebuffers
+		uint32_t width;
+		uint32_t height;
+		uint32_t lastUsed;
+	};
+	std::vector<FilterPoolEntry> filterFramebufferPool;
+	std::vector<FilterPoolEntry> filterTexturePool;
+	uint32_t filterPoolFrame;
+	uint64_t filterPoolBytes;
+	void trimFilterPool(bool all=false);
+	void trimFilterPoolSize();
+
 	struct DebugRect
 	{
 		DisplayObject* obj;
@@ -198,6 +269,12 @@ public:
 	void resetViewPort();
 	void setModelView(const MATRIX& matrix);
 	void renderTextureToFrameBuffer(uint32_t filterTextureID, uint32_t w, uint32_t h, float* filterdata, float* gradientcolors, bool isFirstFilter, bool flippedvertical, bool clearstate=true, bool renderstage3d=false);
+	// framebuffer with stencil renderbuffer of size w*h from the filter pool
+	void acquireFilterFramebuffer(uint32_t w, uint32_t h, uint32_t& framebuffer, uint32_t& renderbuffer);
+	void releaseFilterFramebuffer(uint32_t framebuffer, uint32_t renderbuffer, uint32_t w, uint32_t h);
+	// rgba texture of size w*h from the filter pool, the content is undefined
+	uint32_t acquireFilterTexture(uint32_t w, uint32_t h);
+	void releaseFilterTexture(uint32_t id, uint32_t w, uint32_t h);
 	cairo_t *cairoTextureContextSettings;
 	cairo_surface_t *cairoTextureSurfaceSettings;
 	uint8_t *cairoTextureDataSettings;
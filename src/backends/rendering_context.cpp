@@ -146,6 +146,7 @@ CachedSurface* GLRenderContext::getCachedSurface(const DisplayObject* d) const
 
 void GLRenderContext::pushMask()
 {
+	flushTextureBatch();
 	RenderContext::pushMask();
 	if (engineData->nvgcontext != nullptr)
 		nvgPushClip(engineData->nvgcontext);
@@ -158,6 +159,7 @@ void GLRenderContext::pushMask()
 
 void GLRenderContext::popMask()
 {
+	flushTextureBatch();
 	RenderContext::popMask();
 	if (engineData->nvgcontext != nullptr)
 		nvgPopClip(engineData->nvgcontext);
@@ -170,21 +172,81 @@ void GLRenderContext::popMask()
 
 void GLRenderContext::deactivateMask()
 {
+	flushTextureBatch();
 	RenderContext::deactivateMask();
 }
 
 void GLRenderContext::activateMask()
 {
+	flushTextureBatch();
 	RenderContext::activateMask();
 }
 
 void GLRenderContext::resetCurrentFrameBuffer()
 {
+	flushTextureBatch();
 	engineData->exec_glBindFramebuffer_GL_FRAMEBUFFER(baseFramebuffer);
 	engineData->exec_glBindRenderbuffer_GL_RENDERBUFFER(baseRenderbuffer);
 }
+void GLRenderContext::setScissor(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	flushTextureBatch();
+	if (damageScissorEnabled)
+	{
+		// never draw outside of the damaged region
+		int32_t x2=min(x+width,damageScissor.x+damageScissor.width);
+		int32_t y2=min(y+height,damageScissor.y+damageScissor.height);
+		x=max(x,damageScissor.x);
+		y=max(y,damageScissor.y);
+		width=max(x2-x,0);
+		height=max(y2-y,0);
+	}
+	currentScissor.x=x;
+	currentScissor.y=y;
+	currentScissor.width=width;
+	currentScissor.height=height;
+	engineData->exec_glScissor(x,y,width,height);
+	scissorEnabled=true;
+}
+void GLRenderContext::disableScissor()
+{
+	// quads collected while the scissor test was enabled have to be clipped
+	if (scissorEnabled)
+		flushTextureBatch();
+	if (damageScissorEnabled)
+		engineData->exec_glScissor(damageScissor.x,damageScissor.y,damageScissor.width,damageScissor.height);
+	else
+		engineData->exec_glDisable_GL_SCISSOR_TEST();
+	scissorEnabled=false;
+}
+void GLRenderContext::restoreScissor()
+{
+	if (scissorEnabled)
+		engineData->exec_glScissor(currentScissor.x,currentScissor.y,currentScissor.width,currentScissor.height);
+	else if (damageScissorEnabled)
+		engineData->exec_glScissor(damageScissor.x,damageScissor.y,damageScissor.width,damageScissor.height);
+}
+void GLRenderContext::setDamageScissor(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	flushTextureBatch();
+	damageScissor.x=x;
+	damageScissor.y=y;
+	damageScissor.width=width;
+	damageScissor.height=height;
+	damageScissorEnabled=true;
+	scissorEnabled=false;
+	engineData->exec_glScissor(x,y,width,height);
+}
+void GLRenderContext::clearDamageScissor()
+{
+	flushTextureBatch();
+	damageScissorEnabled=false;
+	scissorEnabled=false;
+	engineData->exec_glDisable_GL_SCISSOR_TEST();
+}
 void GLRenderContext::setupRenderingState(float alpha, const ColorTransformBase& colortransform,SMOOTH_MODE smooth,AS_BLENDMODE blendmode)
 {
+	flushTextureBatch();
 	engineData->exec_glUniform1f(blendModeUniform, blendmode);
 	switch (blendmode)
 	{
@@ -225,26 +287,80 @@ void GLRenderContext::setupRenderingState(float alpha, const ColorTransformBase&
 	// set mask drawing indicator
 	engineData->exec_glUniform1f(maskUniform, isDrawingMask() ? 1 : 0);
 }
+bool GLRenderContext::isBatchCompatible(TextureBatchState& s) const
+{
+	return s.textureID==batchState.textureID &&
+			s.alpha==batchState.alpha &&
+			s.colortransform==batchState.colortransform &&
+			s.colorMode==batchState.colorMode &&
+			s.directMode==batchState.directMode &&
+			s.directColor.toUInt()==batchState.directColor.toUInt() &&
+			s.smooth==batchState.smooth &&
+			s.blendmode==batchState.blendmode &&
+			s.drawingMask==batchState.drawingMask;
+}
+void GLRenderContext::flushTextureBatch()
+{
+	if (batchVertexCoords.empty())
+		return;
+	// the vertices are already transformed, so the modelview matrix is the identity
+	engineData->exec_glUniformMatrix4fv(modelviewMatrixUniform, 1, false, lsIdentityMatrix);
+	// the bound texture may have been changed by uploads since the batch was started
+	engineData->exec_glActiveTexture_GL_TEXTURE0(SAMPLEPOSITION::SAMPLEPOS_STANDARD);
+	engineData->exec_glBindTexture_GL_TEXTURE_2D(batchState.textureID);
+	engineData->exec_glVertexAttribPointer(VERTEX_ATTRIB, 0, batchVertexCoords.data(),FLOAT_2);
+	engineData->exec_glVertexAttribPointer(TEXCOORD_ATTRIB, 0, batchTextureCoords.data(),FLOAT_2);
+	engineData->exec_glEnableVertexAttribArray(VERTEX_ATTRIB);
+	engineData->exec_glEnableVertexAttribArray(TEXCOORD_ATTRIB);
+	engineData->exec_glDrawArrays_GL_TRIANGLES( 0, batchVertexCoords.size()/2);
+	engineData->exec_glDisableVertexAttribArray(VERTEX_ATTRIB);
+	engineData->exec_glDisableVertexAttribArray(TEXCOORD_ATTRIB);
+	if (batchState.smooth != SMOOTH_MODE::SMOOTH_NONE)
+	{
+		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_LINEAR();
+		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_LINEAR();
+	}
+	batchDrawCount++;
+	batchVertexCoords.clear();
+	batchTextureCoords.clear();
+}
 void GLRenderContext::renderTextured(const TextureChunk& chunk, float alpha, COLOR_MODE colorMode,
 									 const ColorTransformBase& colortransform,
 									 bool isMask, float directMode, RGB directColor, SMOOTH_MODE smooth, const MATRIX& matrix, const RECT& scalingGrid,
 									 AS_BLENDMODE blendmode)
 {
-	setupRenderingState(alpha,colortransform,smooth,blendmode);
-	float empty=0;
-	engineData->exec_glUniform1fv(filterdataUniform, 1, &empty);
-	engineData->exec_glUniform1f(yuvUniform, colorMode==COLOR_MODE::YUV_MODE?1.0:0.0);
-	
-	// set mode for direct coloring:
-	// 0.0:no coloring
-	// 1.0 coloring for profiling/error message (?)
-	// 2.0:set color for every non transparent pixel (used for text rendering)
-	// 3.0 set color for every pixel (renders a filled rectangle)
-	engineData->exec_glUniform1f(directUniform, directMode);
-	engineData->exec_glUniform1f(renderStage3DUniform, 0.0);
-	engineData->exec_glUniform4f(directColorUniform,float(directColor.Red)/255.0,float(directColor.Green)/255.0,float(directColor.Blue)/255.0,1.0);
-
-	engineData->exec_glBindTexture_GL_TEXTURE_2D(largeTextures[chunk.texId].id);
+	// quads using the same texture and rendering state are collected and drawn with a single draw call
+	TextureBatchState newState;
+	newState.textureID=largeTextures[chunk.texId].id;
+	newState.alpha=alpha;
+	newState.colortransform=colortransform;
+	newState.colorMode=colorMode;
+	newState.directMode=directMode;
+	newState.directColor=directColor;
+	newState.smooth=smooth;
+	newState.blendmode=blendmode;
+	newState.drawingMask=isDrawingMask();
+	if (!batchVertexCoords.empty() && !isBatchCompatible(newState))
+		flushTextureBatch();
+	if (batchVertexCoords.empty())
+	{
+		setupRenderingState(alpha,colortransform,smooth,blendmode);
+		float empty=0;
+		engineData->exec_glUniform1fv(filterdataUniform, 1, &empty);
+		engineData->exec_glUniform1f(yuvUniform, colorMode==COLOR_MODE::YUV_MODE?1.0:0.0);
+
+		// set mode for direct coloring:
+		// 0.0:no coloring
+		// 1.0 coloring for profiling/error message (?)
+		// 2.0:set color for every non transparent pixel (used for text rendering)
+		// 3.0 set color for every pixel (renders a filled rectangle)
+		engineData->exec_glUniform1f(directUniform, directMode);
+		engineData->exec_glUniform1f(renderStage3DUniform, 0.0);
+		engineData->exec_glUniform4f(directColorUniform,float(directColor.Red)/255.0,float(directColor.Green)/255.0,float(directColor.Blue)/255.0,1.0);
+
+		engineData->exec_glBindTexture_GL_TEXTURE_2D(newState.textureID);
+		batchState=newState;
+	}
 	assert(chunk.getNumberOfChunks()==((chunk.width+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL)*((chunk.height+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL));
 	
 	if ((scalingGrid.Xmin!= 0 || scalingGrid.Xmax != 0 || scalingGrid.Ymin !=0 || scalingGrid.Ymax != 0)
@@ -322,21 +438,9 @@ void GLRenderContext::renderTextured(const TextureChunk& chunk, float alpha, COL
 	}
 	else
 		renderpart(matrix,chunk,0,0,chunk.width,chunk.height,chunk.xOffset/chunk.xContentScale,chunk.yOffset/chunk.yContentScale);
-
-	if (smooth != SMOOTH_MODE::SMOOTH_NONE)
-	{
-		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_LINEAR();
-		engineData->exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_LINEAR();
-	}
 }
 void GLRenderContext::renderpart(const MATRIX& matrix, const TextureChunk& chunk, float cropleft, float croptop, float cropwidth, float cropheight,float tx,float ty)
 {
-	//Set matrix
-	float fmatrix[16];
-	matrix.get4DMatrix(fmatrix);
-	lsglLoadMatrixf(fmatrix);
-	setMatrixUniform(LSGL_MODELVIEW);
-	
 	uint32_t firstchunkhorizontal = floor(float(cropleft)/float(CHUNKSIZE_REAL));
 	uint32_t firstchunkvertical = floor(float(croptop)/float(CHUNKSIZE_REAL));
 	uint32_t lastchunkhorizontal = (cropleft+cropwidth+CHUNKSIZE_REAL-1)/CHUNKSIZE_REAL;
@@ -346,9 +450,12 @@ void GLRenderContext::renderpart(const MATRIX& matrix, const TextureChunk& chunk
 	int realchunkcount = (lastchunkhorizontal-firstchunkhorizontal)*(lastchunkvertical-firstchunkvertical);
 	//The 4 corners of each texture are specified as the vertices of 2 triangles,
 	//so there are 6 vertices per quad, two of them duplicated (the diagonal)
-	//Allocate the data on the stack to reduce heap fragmentation
-	float *vertex_coords = g_newa(float,realchunkcount*12);
-	float *texture_coords = g_newa(float,realchunkcount*12);
+	//The vertices are appended to the current batch
+	size_t batchStart=batchVertexCoords.size();
+	batchVertexCoords.resize(batchStart+realchunkcount*12);
+	batchTextureCoords.resize(batchStart+realchunkcount*12);
+	float *vertex_coords = batchVertexCoords.data()+batchStart;
+	float *texture_coords = batchTextureCoords.data()+batchStart;
 	
 	const uint32_t blocksPerSide=largeTextureSize/CHUNKSIZE;
 	float realchunkwidth = cropwidth;
@@ -446,13 +553,17 @@ void GLRenderContext::renderpart(const MATRIX& matrix, const TextureChunk& chunk
 		startVtop = 0;
 		startY = endY;
 	}
-	engineData->exec_glVertexAttribPointer(VERTEX_ATTRIB, 0, vertex_coords,FLOAT_2);
-	engineData->exec_glVertexAttribPointer(TEXCOORD_ATTRIB, 0, texture_coords,FLOAT_2);
-	engineData->exec_glEnableVertexAttribArray(VERTEX_ATTRIB);
-	engineData->exec_glEnableVertexAttribArray(TEXCOORD_ATTRIB);
-	engineData->exec_glDrawArrays_GL_TRIANGLES( 0, chunkrendercount*6);
-	engineData->exec_glDisableVertexAttribArray(VERTEX_ATTRIB);
-	engineData->exec_glDisableVertexAttribArray(TEXCOORD_ATTRIB);
+	//Transform the vertices on the CPU, so quads with different matrices can share a draw call
+	for(uint32_t i=0;i<chunkrendercount*12;i+=2)
+	{
+		number_t x,y;
+		matrix.multiply2D(vertex_coords[i],vertex_coords[i+1],x,y);
+		vertex_coords[i]=x;
+		vertex_coords[i+1]=y;
+	}
+	batchVertexCoords.resize(batchStart+chunkrendercount*12);
+	batchTextureCoords.resize(batchStart+chunkrendercount*12);
+	batchQuadCount+=chunkrendercount;
 }
 
 int GLRenderContext::errorCount = 0;
@@ -477,8 +588,10 @@ bool GLRenderContext::handleGLErrors() const
 	return errorCount;
 }
 
-void GLRenderContext::setMatrixUniform(LSGL_MATRIX m) const
+void GLRenderContext::setMatrixUniform(LSGL_MATRIX m)
 {
+	// a new matrix means something else is drawn, so the pending quads have to be drawn first
+	flushTextureBatch();
 	int uni = (m == LSGL_MODELVIEW) ? modelviewMatrixUniform:projectionMatrixUniform;
 
 	engineData->exec_glUniformMatrix4fv(uni, 1, false, lsMVPMatrix);
@@ -583,6 +696,9 @@ void CairoRenderContext::setupRenderState(cairo_t* cr,AS_BLENDMODE blendmode,boo
 		case BLENDMODE_ERASE:
 			cairo_set_operator(cr,CAIRO_OPERATOR_DEST_OUT);
 			break;
+		case BLENDMODE_ALPHA:
+			cairo_set_operator(cr,CAIRO_OPERATOR_DEST_IN);
+			break;
 		default:
 			LOG(LOG_NOT_IMPLEMENTED,"cairo renderTextured of blend mode "<<(int)blendmode);
 			break;
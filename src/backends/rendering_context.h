@@ -115,6 +115,10 @@ public:
 			const ColorTransformBase& colortransform,
 			bool isMask, float directMode, RGB directColor,SMOOTH_MODE smooth, const MATRIX& matrix,
 			const RECT& scalingGrid, AS_BLENDMODE blendmode)=0;
+	/**
+		Submit all quads collected by renderTextured that are not yet drawn
+	*/
+	virtual void flushTextureBatch() {}
 	/**
 	 * Get the right CachedSurface from an object
 	 */
@@ -177,11 +181,49 @@ protected:
 	public:
 		uint32_t id;
 		uint8_t* bitmap;
-		LargeTexture(uint8_t* b):id(-1),bitmap(b){}
+		// number of blocks marked as used in bitmap
+		uint32_t usedBlocks;
+		LargeTexture(uint8_t* b):id(-1),bitmap(b),usedBlocks(0){}
 		~LargeTexture(){/*delete[] bitmap;*/}
 	};
 	std::vector<LargeTexture> largeTextures;
 
+	/* Batching of textured quads */
+	// all quads in a batch share the same texture and uniforms, the vertices are already transformed
+	struct TextureBatchState
+	{
+		uint32_t textureID;
+		float alpha;
+		ColorTransformBase colortransform;
+		COLOR_MODE colorMode;
+		float directMode;
+		RGB directColor;
+		SMOOTH_MODE smooth;
+		AS_BLENDMODE blendmode;
+		bool drawingMask;
+	};
+	TextureBatchState batchState;
+	std::vector<float> batchVertexCoords;
+	std::vector<float> batchTextureCoords;
+	uint32_t batchQuadCount;
+	uint32_t batchDrawCount;
+
+	/* Scissoring */
+	struct ScissorRect
+	{
+		int32_t x;
+		int32_t y;
+		int32_t width;
+		int32_t height;
+	};
+	// the scissor set by setScissor, always inside the damage scissor
+	ScissorRect currentScissor;
+	bool scissorEnabled;
+	// the damaged region of the stage during partial redraws
+	ScissorRect damageScissor;
+	bool damageScissorEnabled;
+	bool isBatchCompatible(TextureBatchState& s) const;
+
 	~GLRenderContext(){}
 	void renderpart(const MATRIX& matrix, const TextureChunk& chunk, float cropleft, float croptop, float cropwidth, float cropheight, float tx, float ty);
 public:
@@ -189,8 +231,8 @@ public:
 	/*
 	 * Uploads the current matrix as the specified type.
 	 */
-	void setMatrixUniform(LSGL_MATRIX m) const;
-	GLRenderContext() : RenderContext(),maskCount(0),engineData(nullptr), largeTextureSize(0)
+	void setMatrixUniform(LSGL_MATRIX m);
+	GLRenderContext() : RenderContext(),maskCount(0),engineData(nullptr), largeTextureSize(0), batchQuadCount(0), batchDrawCount(0), scissorEnabled(false), damageScissorEnabled(false)
 	{
 	}
 	void SetEngineData(EngineData* data) { engineData = data;}
@@ -200,6 +242,7 @@ public:
 			const ColorTransformBase& colortransform,
 			bool isMask, float directMode, RGB directColor, SMOOTH_MODE smooth, const MATRIX& matrix,
 			const RECT& scalingGrid, AS_BLENDMODE blendmode) override;
+	void flushTextureBatch() override;
 	/**
 	 * Get the right CachedSurface from an object
 	 * In the OpenGL case we just get the CachedSurface inside the object itself
@@ -213,6 +256,12 @@ public:
 	
 	bool getFlipVertical() const { return flipvertical; }
 	void resetCurrentFrameBuffer();
+	void setScissor(int32_t x, int32_t y, int32_t width, int32_t height);
+	void disableScissor();
+	// re-enable the current scissor after external code (like nanovg) has disabled the scissor test
+	void restoreScissor();
+	void setDamageScissor(int32_t x, int32_t y, int32_t width, int32_t height);
+	void clearDamageScissor();
 	void setupRenderingState(float alpha, const ColorTransformBase& colortransform, SMOOTH_MODE smooth, AS_BLENDMODE blendmode);
 	// this is used to keep track of the fbos when rendering filters and some of the ancestors of the filtered object also have filters
 	std::vector<filterstackentry> filterframebufferstack;
@@ -230,11 +279,11 @@ private:
 	uint32_t height;
 	std::list<std::pair<cairo_surface_t*,MATRIX>> masksurfaces;
 	static cairo_surface_t* getCairoSurfaceForData(uint8_t* buf, uint32_t width, uint32_t height, uint32_t stride);
-	/*
-	 * An invalid surface to be returned for objects with no content
-	 */
-	void setupRenderState(cairo_t* cr, AS_BLENDMODE blendmode, bool isMask, SMOOTH_MODE smooth);
 public:
+	/**
+	 * Set the cairo operator and antialiasing matching the given blend mode and smoothing
+	 */
+	static void setupRenderState(cairo_t* cr, AS_BLENDMODE blendmode, bool isMask, SMOOTH_MODE smooth);
 	CairoRenderContext(uint8_t* buf, uint32_t _width, uint32_t _height, bool smoothing);
 	virtual ~CairoRenderContext();
 
@@ -19,6 +19,11 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 #include <glib.h>
 #include "backends/streamcache.h"
 #include "backends/config.h"
@@ -78,22 +83,27 @@ void StreamCache::append(const unsigned char* buffer, size_t length)
 		return;
 
 	handleAppend(buffer, length);
+	commitAppend(length);
+}
 
-	{
-		stateMutex.lock();
-		receivedLength += length;
-		stateMutex.unlock();
-		sys->sendMainSignal();
-	}
+void StreamCache::commitAppend(size_t length)
+{
+	stateMutex.lock();
+	receivedLength += length;
+	stateMutex.unlock();
+	sys->sendMainSignal();
 }
 
 class lightspark::MemoryChunk {
 public:
 	MemoryChunk(size_t len);
+	MemoryChunk(_R<MappedFile> f, const unsigned char* data, size_t len);
 	~MemoryChunk();
 	unsigned char * const buffer;
 	const size_t capacity;
 	ACQUIRE_RELEASE_VARIABLE(size_t, used);
+	// set if buffer is a slice of a mapped file
+	_NR<MappedFile> mapping;
 };
 
 MemoryChunk::MemoryChunk(size_t len) :
@@ -101,9 +111,15 @@ MemoryChunk::MemoryChunk(size_t len) :
 {
 }
 
+MemoryChunk::MemoryChunk(_R<MappedFile> f, const unsigned char* data, size_t len) :
+	buffer(const_cast<unsigned char*>(data)), capacity(len), used(len), mapping(f)
+{
+}
+
 MemoryChunk::~MemoryChunk()
 {
-	delete[] buffer;
+	if (mapping.isNull())
+		delete[] buffer;
 }
 
 MemoryStreamCache::MemoryStreamCache(SystemState* _sys):StreamCache(_sys),
@@ -163,6 +179,20 @@ void MemoryStreamCache::handleAppend(const unsigned char* data, size_t length)
 	}
 }
 
+void MemoryStreamCache::appendMapped(_R<MappedFile> file, const unsigned char* buffer, size_t length)
+{
+	if (!buffer || length == 0 || terminated)
+		return;
+
+	{
+		Locker locker(chunkListMutex);
+		// the chunk is full, so the next append() allocates a new one
+		writeChunk = new MemoryChunk(file, buffer, length);
+		chunks.push_back(writeChunk);
+	}
+	commitAppend(length);
+}
+
 void MemoryStreamCache::reserve(size_t expectedLength)
 {
 	if (expectedLength <= receivedLength)
@@ -525,6 +555,104 @@ streamsize FileStreamCache::Reader::xsgetn(char* s, streamsize n)
 	return read;
 }
 
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+	if (data)
+		munmap((void*)data,length);
+#endif
+}
+
+_NR<MappedFile> MappedFile::open(const char* filepath)
+{
+#ifndef _WIN32
+	int fd = ::open(filepath,O_RDONLY);
+	if (fd < 0)
+		return NullRef;
+	struct stat st;
+	if (fstat(fd,&st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+	{
+		close(fd);
+		return NullRef;
+	}
+	void* data = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+	// the mapping stays valid after closing the file
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		LOG(LOG_INFO,"mapping "<<filepath<<" failed, reading it instead");
+		return NullRef;
+	}
+	madvise(data,st.st_size,MADV_SEQUENTIAL);
+	return _MNR(new MappedFile((const uint8_t*)data,st.st_size));
+#else
+	// TODO use CreateFileMapping
+	return NullRef;
+#endif
+}
+
+MappedFileReader::MappedFileReader(_R<MappedFile> f, size_t offset, size_t length):file(f)
+{
+	char* start = (char*)file->getData()+imin(offset,file->getLength());
+	char* end = start+imin(length,file->getLength()-(start-(char*)file->getData()));
+	setg(start,start,end);
+}
+
+streampos MappedFileReader::seekoff(streamoff off, ios_base::seekdir way, ios_base::openmode which)
+{
+	switch (way)
+	{
+		case ios_base::beg:
+			return seekpos(off,which);
+		case ios_base::cur:
+			return seekpos((gptr()-eback())+off,which);
+		case ios_base::end:
+			return seekpos((egptr()-eback())+off,which);
+		default:
+			return streampos(streamoff(-1));
+	}
+}
+
+streampos MappedFileReader::seekpos(streampos pos, ios_base::openmode which)
+{
+	if (!(which & ios_base::in) || pos < 0 || pos > egptr()-eback())
+		return streampos(streamoff(-1));
+	setg(eback(),eback()+pos,egptr());
+	return pos;
+}
+
+const uint8_t* MappedFileReader::readSlice(istream& in, size_t len, _NR<MappedFile>& f)
+{
+	MappedFileReader* r = dynamic_cast<MappedFileReader*>(in.rdbuf());
+	if (!r || size_t(r->egptr()-r->gptr()) < len)
+		return nullptr;
+	const uint8_t* ret = (const uint8_t*)r->gptr();
+	r->setg(r->eback(),r->gptr()+len,r->egptr());
+	f = r->file;
+	return ret;
+}
+
+void StreamData::read(istream& in, size_t length)
+{
+	clear();
+	ptr = MappedFileReader::readSlice(in,length,file);
+	if (!ptr)
+	{
+		buffer.resize(length);
+		in.read((char*)buffer.data(),length);
+		ptr = buffer.data();
+	}
+	len = length;
+}
+
+void StreamData::clear()
+{
+	file.reset();
+	std::vector<uint8_t>().swap(buffer);
+	ptr = nullptr;
+	len = 0;
+}
+
 streamsize lsfilereader::xsgetn(char *s, streamsize n)
 {
 	if (filehandler)
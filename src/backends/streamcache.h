@@ -21,6 +21,7 @@
 #define BACKENDS_STREAMCACHE_H 1
 
 #include <list>
+#include <vector>
 #include <istream>
 #include <fstream>
 #include <cstdint>
@@ -65,6 +66,8 @@ protected:
 
 	// Derived class implements this to store received data
 	virtual void handleAppend(const unsigned char* buffer, size_t length)=0;
+	// Accounts appended data and wakes up the readers
+	void commitAppend(size_t length);
 
 public:
 	virtual ~StreamCache() {}
@@ -102,6 +105,67 @@ public:
 	virtual void openForWriting() = 0;
 };
 
+/*
+ * A read-only memory mapping of a complete local file.
+ * Tags read from the mapping can reference slices of it instead of copying their data.
+ * The file must not be truncated while it is mapped
+ */
+class DLL_PUBLIC MappedFile : public RefCountable {
+private:
+	const uint8_t* data;
+	size_t length;
+	MappedFile(const uint8_t* d, size_t l):data(d),length(l){}
+public:
+	~MappedFile();
+	// Returns NullRef if the file can't be mapped
+	static _NR<MappedFile> open(const char* filepath);
+	const uint8_t* getData() const { return data; }
+	size_t getLength() const { return length; }
+};
+
+/*
+ * Reads a range of a MappedFile without copying it into an intermediate buffer.
+ */
+class DLL_PUBLIC MappedFileReader : public std::streambuf {
+private:
+	_R<MappedFile> file;
+	std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which) override;
+	std::streampos seekpos(std::streampos pos, std::ios_base::openmode which) override;
+public:
+	MappedFileReader(_R<MappedFile> f, size_t offset=0, size_t length=SIZE_MAX);
+	_R<MappedFile> getFile() const { return file; }
+	// true if the reader covers the whole file
+	bool isWholeFile() const { return (const uint8_t*)eback()==file->getData() && size_t(egptr()-eback())==file->getLength(); }
+	/*
+	 * Skips the next len bytes of the stream and returns a pointer to them in the mapping.
+	 * Returns nullptr if the stream doesn't read from a MappedFile or the bytes aren't available,
+	 * the stream is unchanged in that case
+	 */
+	static const uint8_t* readSlice(std::istream& in, size_t len, _NR<MappedFile>& f);
+};
+
+/*
+ * A block of data read from a stream. It references the mapping if the stream reads from
+ * a MappedFile, otherwise it owns a copy of the data
+ */
+class DLL_PUBLIC StreamData {
+private:
+	_NR<MappedFile> file;
+	std::vector<uint8_t> buffer;
+	const uint8_t* ptr;
+	size_t len;
+	StreamData(const StreamData&) = delete;
+	StreamData& operator=(const StreamData&) = delete;
+public:
+	StreamData():ptr(nullptr),len(0){}
+	void read(std::istream& in, size_t length);
+	const uint8_t* data() const { return ptr; }
+	size_t size() const { return len; }
+	bool empty() const { return len==0; }
+	// releases the data or the reference to the mapping
+	void clear();
+};
+
 class MemoryChunk;
 
 /*
@@ -154,6 +218,9 @@ public:
 
 	void reserve(size_t expectedLength) override;
 
+	// Appends a slice of a MappedFile without copying it (writer thread)
+	void appendMapped(_R<MappedFile> file, const unsigned char* buffer, size_t length);
+
 	std::streambuf *createReader() override;
 	
 	void openForWriting() override;
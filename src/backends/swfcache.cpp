@@ -0,0 +1,191 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "backends/swfcache.h"
+#include "backends/config.h"
+#include "parsing/streams.h"
+#include "logger.h"
+#include "swf.h"
+
+using namespace lightspark;
+using namespace std;
+
+// size of the uncompressed SWF header (signature, version and file length)
+#define SWFCACHE_HEADER_SIZE 8
+// number and size of the blocks of the compressed file that are hashed for the entry name
+#define SWFCACHE_SAMPLE_COUNT 16
+#define SWFCACHE_SAMPLE_SIZE 4096
+
+// returns the FileLength field of the SWF header, the length of the whole uncompressed file including the header
+static uint32_t getSWFFileLength(const uint8_t* header)
+{
+	return uint32_t(header[4]) | (uint32_t(header[5])<<8) | (uint32_t(header[6])<<16) | (uint32_t(header[7])<<24);
+}
+
+bool SWFCache::isEnabled()
+{
+	return Config::getConfig()->isSWFCacheEnabled();
+}
+
+string SWFCache::getEntryPath(const MappedFile* compressed)
+{
+	GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	uint64_t length = compressed->getLength();
+	g_checksum_update(checksum,(const guchar*)&length,sizeof(length));
+	// the samples are spread evenly, the first one starts at the beginning and the last one ends at the end of the file
+	for (uint32_t i = 0; i < SWFCACHE_SAMPLE_COUNT; i++)
+	{
+		uint64_t offset = length > SWFCACHE_SAMPLE_SIZE ? (length-SWFCACHE_SAMPLE_SIZE)*i/(SWFCACHE_SAMPLE_COUNT-1) : 0;
+		g_checksum_update(checksum,compressed->getData()+offset,min(uint64_t(SWFCACHE_SAMPLE_SIZE),length-offset));
+	}
+	string path = Config::getConfig()->getCacheDirectory() + G_DIR_SEPARATOR_S + "swf" + G_DIR_SEPARATOR_S + g_checksum_get_string(checksum) + ".swf";
+	g_checksum_free(checksum);
+	return path;
+}
+
+string SWFCache::getFileHash(const MappedFile* compressed)
+{
+	gchar* hash = g_compute_checksum_for_data(G_CHECKSUM_SHA256,compressed->getData(),compressed->getLength());
+	string ret = hash;
+	g_free(hash);
+	return ret;
+}
+
+_NR<MappedFile> SWFCache::lookup(_R<MappedFile> compressed, const string& path)
+{
+	if (compressed->getLength() <= SWFCACHE_HEADER_SIZE)
+		return NullRef;
+	_NR<MappedFile> entry = MappedFile::open(path.c_str());
+	if (entry.isNull())
+		return NullRef;
+	// entries are only renamed into place when complete, but the header and the length have to match anyway
+	if (entry->getLength() <= SWFCACHE_HEADER_SIZE || memcmp(entry->getData(),compressed->getData(),SWFCACHE_HEADER_SIZE)!=0
+			|| entry->getLength() != getSWFFileLength(compressed->getData()))
+	{
+		LOG(LOG_ERROR,"invalid entry in swf cache:"<<path);
+		return NullRef;
+	}
+	LOG(LOG_INFO,"using decompressed swf from cache:"<<path);
+	return entry;
+}
+
+void SWFCache::verify(SystemState* sys, _R<MappedFile> compressed, const string& path)
+{
+	sys->addJob(new SWFCacheVerifyJob(compressed,path));
+}
+
+void SWFCache::store(SystemState* sys, _R<MappedFile> compressed, FILE_TYPE type, const string& path)
+{
+	if (compressed->getLength() <= SWFCACHE_HEADER_SIZE)
+		return;
+	sys->addJob(new SWFCacheJob(compressed,type,path));
+}
+
+void SWFCacheJob::execute()
+{
+	string dir = Config::getConfig()->getCacheDirectory() + G_DIR_SEPARATOR_S + "swf";
+	if (g_mkdir_with_parents(dir.c_str(),S_IRUSR | S_IWUSR | S_IXUSR))
+	{
+		LOG(LOG_INFO,"Could not create swf cache directory " << dir);
+		return;
+	}
+	// write to a temporary file, so an incomplete entry is never found by lookup
+	string tmpName = path + ".XXXXXX";
+	char* tmpNameC = g_newa(char,tmpName.length()+1);
+	strncpy(tmpNameC, tmpName.c_str(), tmpName.length());
+	tmpNameC[tmpName.length()] = '\0';
+	int fd = g_mkstemp(tmpNameC);
+	if (fd == -1)
+	{
+		LOG(LOG_INFO,"Could not create swf cache entry " << tmpNameC);
+		return;
+	}
+
+	bool ok = write(fd,compressed->getData(),SWFCACHE_HEADER_SIZE)==SWFCACHE_HEADER_SIZE;
+	uint64_t length = SWFCACHE_HEADER_SIZE;
+	MappedFileReader reader(compressed,SWFCACHE_HEADER_SIZE);
+	uncompressing_filter* filter = nullptr;
+	try
+	{
+		if (type==FT_COMPRESSED_SWF)
+			filter = new zlib_filter(&reader);
+		else
+			filter = new liblzma_filter(&reader);
+		char buf[4096];
+		while (ok && !threadAborting)
+		{
+			streamsize n = filter->sgetn(buf,sizeof(buf));
+			if (n <= 0)
+				break;
+			ok = write(fd,buf,n)==n;
+			length += n;
+		}
+		// lookup rejects entries that don't have the length given in the header
+		if (ok && length != getSWFFileLength(compressed->getData()))
+		{
+			LOG(LOG_INFO,"not caching swf, the uncompressed length "<<length<<" doesn't match the header "<<getSWFFileLength(compressed->getData()));
+			ok = false;
+		}
+	}
+	catch(std::exception& e)
+	{
+		LOG(LOG_ERROR,"Exception while decompressing swf for cache:"<<e.what());
+		ok = false;
+	}
+	delete filter;
+	if (close(fd) != 0)
+		ok = false;
+	// the hash of the whole file is stored before the entry is renamed into place, so it exists when the entry is found
+	if (ok && !threadAborting)
+	{
+		string hash = SWFCache::getFileHash(compressed.getPtr());
+		ok = g_file_set_contents(SWFCache::getHashPath(path).c_str(),hash.c_str(),hash.length(),nullptr);
+	}
+	if (!ok || threadAborting || g_rename(tmpNameC,path.c_str()) != 0)
+	{
+		g_unlink(tmpNameC);
+		return;
+	}
+	LOG(LOG_INFO,"stored decompressed swf in cache:"<<path);
+}
+
+void SWFCacheVerifyJob::execute()
+{
+	if (threadAborting)
+		return;
+	string hash = SWFCache::getFileHash(compressed.getPtr());
+	if (threadAborting)
+		return;
+	gchar* storedhash = nullptr;
+	bool valid = g_file_get_contents(SWFCache::getHashPath(path).c_str(),&storedhash,nullptr,nullptr) && hash == storedhash;
+	g_free(storedhash);
+	if (valid)
+		return;
+	// the entry has no stored hash or was created from a different file with the same length and sampled blocks,
+	// it is recreated on the next launch
+	// the mapping of the entry used by the running ParseThread stays valid after it is removed
+	LOG(LOG_ERROR,"swf cache entry doesn't match the hash of the file, removing it:"<<path);
+	g_unlink(path.c_str());
+	g_unlink(SWFCache::getHashPath(path).c_str());
+}
@@ -0,0 +1,85 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef BACKENDS_SWFCACHE_H
+#define BACKENDS_SWFCACHE_H 1
+
+#include <string>
+#include "compat.h"
+#include "swftypes.h"
+#include "smartrefs.h"
+#include "interfaces/threading.h"
+#include "backends/streamcache.h"
+
+namespace lightspark
+{
+
+class SystemState;
+
+/*
+ * On-disk cache of decompressed SWF files, enabled by "swf" in the "cache" group of the configuration.
+ * An entry contains the 8 byte header of the compressed file followed by the uncompressed data,
+ * so stream positions are the same as when reading through the uncompressing filter.
+ * It is named by a hash of the length and some sampled blocks of the compressed file, which is cheap
+ * enough to compute before parsing. The SHA-256 hash of the whole compressed file is stored next to
+ * the entry and checked in the ThreadPool after a hit, entries that don't match are removed
+ */
+class DLL_PUBLIC SWFCache
+{
+public:
+	static bool isEnabled();
+	// Computes the entry name from the length and sampled blocks of the compressed file, the path is passed to lookup, verify and store
+	static std::string getEntryPath(const MappedFile* compressed);
+	// Returns the mapped entry for the file, or NullRef if it isn't cached yet
+	static _NR<MappedFile> lookup(_R<MappedFile> compressed, const std::string& path);
+	// Checks the hash of the whole compressed file against the one stored with the entry in the ThreadPool
+	static void verify(SystemState* sys, _R<MappedFile> compressed, const std::string& path);
+	// Decompresses the file into the cache in the ThreadPool
+	static void store(SystemState* sys, _R<MappedFile> compressed, FILE_TYPE type, const std::string& path);
+	// SHA-256 hash of the whole compressed file
+	static std::string getFileHash(const MappedFile* compressed);
+	// path of the file containing the hash of the compressed file an entry was created from
+	static std::string getHashPath(const std::string& path) { return path+".sha256"; }
+};
+
+class SWFCacheJob: public IThreadJob
+{
+private:
+	_R<MappedFile> compressed;
+	FILE_TYPE type;
+	std::string path;
+public:
+	SWFCacheJob(_R<MappedFile> f, FILE_TYPE t, const std::string& p):compressed(f),type(t),path(p) {}
+	void execute() override;
+	void jobFence() override { delete this; }
+};
+
+class SWFCacheVerifyJob: public IThreadJob
+{
+private:
+	_R<MappedFile> compressed;
+	std::string path;
+public:
+	SWFCacheVerifyJob(_R<MappedFile> f, const std::string& p):compressed(f),path(p) {}
+	void execute() override;
+	void jobFence() override { delete this; }
+};
+
+};
+#endif /* BACKENDS_SWFCACHE_H */
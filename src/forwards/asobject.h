@@ -30,6 +30,8 @@ struct asfreelist;
 union asAtom;
 union asAtom;
 class asAtomHandler;
+struct AVM1StackArena;
+class AVM1Stack;
 struct variable;
 struct cyclicmembercount;
 struct garbagecollectorstate;
@@ -28,6 +28,7 @@ namespace lightspark
 /* forward declarations */
 struct FilterData;
 class SurfaceState;
+struct SoftwareRaster;
 class CachedSurface;
 
 };
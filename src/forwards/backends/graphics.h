@@ -33,6 +33,9 @@ struct RefreshableSurface;
 struct RenderDisplayObjectToBitmapContainer;
 class IDrawable;
 class AsyncDrawJob;
+class AsyncDrawTileJob;
+struct RasterCacheKey;
+class RasterCache;
 class CairoRenderer;
 class CairoTokenRenderer;
 struct FormatText;
@@ -30,6 +30,9 @@ class StreamCache;
 class MemoryStreamCache;
 class FileStreamCache;
 class lsfilereader;
+class MappedFile;
+class MappedFileReader;
+class StreamData;
 
 };
 #endif /* FORWARDS_BACKENDS_STREAMCACHE_H */
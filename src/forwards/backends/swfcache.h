@@ -0,0 +1,34 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+/* This file was generated by forward-declare-gen.sh. - DO NOT EDIT */
+
+#ifndef FORWARDS_BACKENDS_SWFCACHE_H
+#define FORWARDS_BACKENDS_SWFCACHE_H 1
+
+namespace lightspark
+{
+
+/* forward declarations */
+class SWFCache;
+class SWFCacheJob;
+class SWFCacheVerifyJob;
+
+};
+#endif /* FORWARDS_BACKENDS_SWFCACHE_H */
@@ -65,6 +65,8 @@ class DefineTextTag;
 class DefineText2Tag;
 class DefineSpriteTag;
 class ProtectTag;
+class BitmapTagPayload;
+class BitmapDecodeJob;
 class BitmapTag;
 class JPEGTablesTag;
 class DefineBitsLosslessTag;
@@ -89,6 +91,8 @@ class EnableDebugger2Tag;
 class DebugIDTag;
 class ExportAssetsTag;
 class NameCharacterTag;
+class ParseTagJob;
+class ParseTagPipeline;
 class TagFactory;
 class DoABCTag;
 class DoABCDefineTag;
@@ -88,6 +88,12 @@ class FILTER;
 class FILTERLIST;
 class BUTTONRECORD;
 class CLIPEVENTFLAGS;
+struct AVM1PushValue;
+struct AVM1Action;
+struct AVM1TryBlock;
+struct AVM1FunctionDefinition;
+class AVM1DecodedActions;
+class AVM1ActionList;
 class CLIPACTIONRECORD;
 class CLIPACTIONS;
 class SOUNDENVELOPE;
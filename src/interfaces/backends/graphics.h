@@ -48,6 +48,11 @@ public:
 	*/
 	virtual uint8_t* upload(bool refresh)=0;
 	virtual TextureChunk& getTexture()=0;
+	/*
+		Returns true if the owner of the texture marks its surface as damaged itself,
+		otherwise the whole stage is redrawn after the upload
+	*/
+	virtual bool reportsDamage() const { return false; }
 	/*
 		Signal the completion of the upload to the texture
 		NOTE: fence may be called on shutdown even if the upload has not happen, so be ready for this event
@@ -20,6 +20,7 @@
 #ifndef INTERFACES_THREADING_H
 #define INTERFACES_THREADING_H 1
 
+#include <cstdint>
 #include "forwards/scripting/flash/system/flashsystem.h"
 
 namespace lightspark
@@ -37,6 +38,12 @@ public:
 	 * to poll threadAborted and not implement threadAbort().
 	 */
 	volatile bool threadAborting;
+	/*
+	 * Jobs waiting in the ThreadPool are executed in order of
+	 * descending priority, jobs with the same priority are
+	 * executed in the order they were added
+	 */
+	uint32_t priority;
 	/*
 	 * Called in a dedicated thread to do the actual
 	 * work. You may throw a JobTerminationException
@@ -60,7 +67,7 @@ public:
 	 * 'delete this'.
 	 */
 	virtual void jobFence()=0;
-	IThreadJob() : fromWorker(nullptr),threadAborting(false) {}
+	IThreadJob() : fromWorker(nullptr),threadAborting(false),priority(0) {}
 	virtual ~IThreadJob() {}
 	void setWorker(ASWorker* w) { fromWorker = w;}
 };
@@ -6,6 +6,7 @@ uniform sampler2D g_tex_standard;
 uniform sampler2D g_tex_blend; // blend base texture
 uniform sampler2D g_tex_filter1; // filter original rendered displayobject texture
 uniform sampler2D g_tex_filter2; // previous filter output texture
+uniform sampler2D g_tex_filter_map; // additional bitmap of the filter (map of DisplacementMapFilter)
 uniform float yuv;
 uniform float alpha;
 uniform float direct;
@@ -241,6 +242,41 @@ vec4 filter_convolution()
 				preserveAlpha == 1.0 ? src.a : clamp(alphaResult / divisor + bias,0.0,1.0));
 }
 
+vec4 filter_displacementmap()
+{
+	float width=filterdata[254];// last values of filterdata are always width and height
+	float height=filterdata[255];
+	vec4 src = texture2D(g_tex_standard,ls_TexCoords[0].xy);
+	// filterdata[248-253] is the matrix from DisplayObject to filter texture coordinates
+	mat2 m = mat2(filterdata[248],filterdata[249],filterdata[250],filterdata[251]);
+	vec2 translate = vec2(filterdata[252],filterdata[253]);
+	float det = m[0][0]*m[1][1]-m[1][0]*m[0][1];
+	if (det == 0.0)
+		return src;
+	vec2 texpos = ls_TexCoords[0].xy*vec2(width,height);
+	vec2 mappos = (mat2(m[1][1],-m[0][1],-m[1][0],m[0][0])/det)*(texpos-translate)-vec2(filterdata[11],filterdata[12]);
+	vec2 mapsize = vec2(filterdata[18],filterdata[19]);
+	// pixels outside of the map are not displaced
+	if (mappos.x < 0.0 || mappos.y < 0.0 || mappos.x >= mapsize.x || mappos.y >= mapsize.y)
+		return src;
+	vec4 mapcolor = texture2D(g_tex_filter_map,(floor(mappos)+0.5)/mapsize);
+	vec2 offset = vec2((dot(mapcolor,vec4(filterdata[1],filterdata[2],filterdata[3],filterdata[4]))*255.0-128.0)*filterdata[9]/256.0,
+					   (dot(mapcolor,vec4(filterdata[5],filterdata[6],filterdata[7],filterdata[8]))*255.0-128.0)*filterdata[10]/256.0);
+	vec2 srcpos = (texpos+m*offset)/vec2(width,height);
+	if (srcpos.x < 0.0 || srcpos.y < 0.0 || srcpos.x > 1.0 || srcpos.y > 1.0)
+	{
+		if (filterdata[13]==0.0) // wrap
+			srcpos = fract(srcpos);
+		else if (filterdata[13]==1.0) // clamp
+			srcpos = clamp(srcpos,0.0,1.0);
+		else if (filterdata[13]==2.0) // ignore
+			return src;
+		else // color
+			return vec4(filterdata[14],filterdata[15],filterdata[16],1.0)*filterdata[17];
+	}
+	return texture2D(g_tex_standard,srcpos);
+}
+
 void main()
 {
 	vec4 vbase = texture2D(g_tex_standard,ls_TexCoords[0].xy);
@@ -267,6 +303,8 @@ void main()
 			vbase = filter_colormatrix(vbase);
 		} else if (filterdata[0]==7.0) {// FILTERSTEP_CONVOLUTION
 			vbase = filter_convolution();
+		} else if (filterdata[0]==8.0) {// FILTERSTEP_DISPLACEMENTMAP
+			vbase = filter_displacementmap();
 		}
 	}
 
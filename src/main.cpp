@@ -390,6 +390,11 @@ int main(int argc, char* argv[])
 	SecurityManager::SANDBOXTYPE sandboxType=SecurityManager::LOCAL_WITH_FILE;
 	bool useInterpreter=true;
 	bool useFastInterpreter=false;
+	uint16_t tierUpThreshold=10;
+	char* abcProfileDirectory=nullptr;
+	char* headlessOutputDirectory=nullptr;
+	uint32_t headlessFrameLimit=0;
+	bool headlessFastForward=false;
 	bool useJit=false;
 	bool ignoreUnhandledExceptions = false;
 	bool startInFullScreenMode=false;
@@ -424,6 +429,26 @@ int main(int argc, char* argv[])
 			useInterpreter=false;
 		else if(strcmp(argv[i],"-fi")==0 || strcmp(argv[i],"--enable-fast-interpreter")==0)
 			useFastInterpreter=true;
+		else if(strcmp(argv[i],"-tt")==0 || strcmp(argv[i],"--tier-up-threshold")==0)
+		{
+			i++;
+			if(i==argc)
+			{
+				fileName=nullptr;
+				break;
+			}
+			tierUpThreshold=min(UINT16_MAX, max(0, atoi(argv[i])));
+		}
+		else if(strcmp(argv[i],"-ap")==0 || strcmp(argv[i],"--abc-profile-dir")==0)
+		{
+			i++;
+			if(i==argc)
+			{
+				fileName=nullptr;
+				break;
+			}
+			abcProfileDirectory=argv[i];
+		}
 		else if(strcmp(argv[i],"-j")==0 || strcmp(argv[i],"--enable-jit")==0)
 			useJit=true;
 		else if(strcmp(argv[i],"-ne")==0 || strcmp(argv[i],"--ignore-unhandled-exceptions")==0)
@@ -518,6 +543,30 @@ int main(int argc, char* argv[])
 		{
 			EngineData::enablerendering = false;
 		}
+		else if(strcmp(argv[i],"-ho")==0 || strcmp(argv[i],"--headless-output")==0)
+		{
+			i++;
+			if(i==argc)
+			{
+				fileName=nullptr;
+				break;
+			}
+			headlessOutputDirectory=argv[i];
+			// headless rendering replaces the OpenGL rendering
+			EngineData::enablerendering = false;
+		}
+		else if(strcmp(argv[i],"-hf")==0 || strcmp(argv[i],"--headless-frames")==0)
+		{
+			i++;
+			if(i==argc)
+			{
+				fileName=nullptr;
+				break;
+			}
+			headlessFrameLimit=max(0, atoi(argv[i]));
+		}
+		else if(strcmp(argv[i],"-hff")==0 || strcmp(argv[i],"--headless-fast-forward")==0)
+			headlessFastForward=true;
 		
 		else if(strcmp(argv[i],"--HTTP-cookies")==0)
 		{
@@ -543,12 +592,13 @@ int main(int argc, char* argv[])
 				 strcmp(argv[i],"--help")==0)
 		{
 			LOG(LOG_ERROR, "Usage: " << argv[0] << " [--url|-u http://loader.url/file.swf]" <<
-							   " [--disable-interpreter|-ni] [--enable-fast-interpreter|-fi]" <<
+							   " [--disable-interpreter|-ni] [--enable-fast-interpreter|-fi] [--tier-up-threshold|-tt calls] [--abc-profile-dir|-ap directory]" <<
 #ifdef LLVM_ENABLED
 							   " [--enable-jit|-j]" <<
 #endif
 							   " [--log-level|-l 0-4] [--parameters-file|-p params-file] [--security-sandbox|-s sandbox]" <<
 							   " [--exit-on-error] [--HTTP-cookies cookie] [--air] [--disable-rendering]" <<
+							   " [--headless-output|-ho directory] [--headless-frames|-hf frames] [--headless-fast-forward|-hff]" <<
 #ifdef PROFILING_SUPPORT
 							   " [--profiling-output|-o profiling-file]" <<
 #endif
@@ -600,8 +650,14 @@ int main(int argc, char* argv[])
 	}
 
 	Log::setLogLevel(log_level);
-	lsfilereader r(fileName);
-	istream f(&r);
+	// a mapped file lets the tags reference their data instead of copying it
+	_NR<MappedFile> mappedFile = MappedFile::open(fileName);
+	std::streambuf* filebuf;
+	if (!mappedFile.isNull())
+		filebuf = new MappedFileReader(mappedFile);
+	else
+		filebuf = new lsfilereader(fileName);
+	istream f(filebuf);
 	f.seekg(0, ios::end);
 	uint32_t fileSize=f.tellg();
 	f.seekg(0, ios::beg);
@@ -673,6 +729,19 @@ int main(int argc, char* argv[])
 	}
 	sys->useInterpreter=useInterpreter;
 	sys->useFastInterpreter=useFastInterpreter;
+	sys->tierUpThreshold=tierUpThreshold;
+	if(abcProfileDirectory)
+	{
+		g_mkdir_with_parents(abcProfileDirectory,0700);
+		sys->abcProfileDirectory=abcProfileDirectory;
+	}
+	if(headlessOutputDirectory)
+	{
+		g_mkdir_with_parents(headlessOutputDirectory,0700);
+		sys->headlessOutputDirectory=headlessOutputDirectory;
+		sys->headlessFrameLimit=headlessFrameLimit;
+		sys->headlessFastForward=headlessFastForward;
+	}
 	sys->useJit=useJit;
 	sys->ignoreUnhandledExceptions=ignoreUnhandledExceptions;
 	sys->exitOnError=exitOnError;
@@ -729,6 +798,7 @@ int main(int argc, char* argv[])
 
 	delete pt;
 	delete sys;
+	delete filebuf;
 
 	SystemState::staticDeinit();
 	
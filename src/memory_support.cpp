@@ -30,3 +30,87 @@ MemoryAccount* lightspark::getUnaccountedMemoryAccount()
 		return NULL;
 }
 #endif
+
+namespace
+{
+struct sizeclass_freeblock
+{
+	sizeclass_freeblock* next;
+};
+class sizeclass_cache
+{
+public:
+	sizeclass_freeblock* freelists[SIZECLASS_COUNT];
+	uint32_t freecount[SIZECLASS_COUNT];
+	// set when the thread terminates, objects deleted afterwards (e.g. by static destructors) are freed directly
+	bool destroyed;
+	sizeclass_cache():destroyed(false)
+	{
+		for (uint32_t i = 0; i < SIZECLASS_COUNT; i++)
+		{
+			freelists[i]=nullptr;
+			freecount[i]=0;
+		}
+	}
+	~sizeclass_cache()
+	{
+		release();
+		destroyed=true;
+	}
+	void release()
+	{
+		for (uint32_t i = 0; i < SIZECLASS_COUNT; i++)
+		{
+			while (freelists[i])
+			{
+				sizeclass_freeblock* b = freelists[i];
+				freelists[i] = b->next;
+				free(b);
+			}
+			freecount[i]=0;
+		}
+	}
+};
+thread_local sizeclass_cache threadcache;
+}
+
+void* lightspark::sizeclass_allocate(size_t size)
+{
+	if (size > SIZECLASS_MAX_SIZE)
+		return malloc(size);
+	uint32_t c = (size+SIZECLASS_GRANULARITY-1)/SIZECLASS_GRANULARITY-1;
+	sizeclass_cache& cache = threadcache;
+	sizeclass_freeblock* b = cache.freelists[c];
+	if (b)
+	{
+		cache.freelists[c] = b->next;
+		cache.freecount[c]--;
+		return b;
+	}
+	return malloc((c+1)*SIZECLASS_GRANULARITY);
+}
+
+void lightspark::sizeclass_free(void* p, size_t size)
+{
+	if (size > SIZECLASS_MAX_SIZE)
+	{
+		free(p);
+		return;
+	}
+	uint32_t c = (size+SIZECLASS_GRANULARITY-1)/SIZECLASS_GRANULARITY-1;
+	sizeclass_cache& cache = threadcache;
+	if (cache.destroyed || cache.freecount[c]*(c+1)*SIZECLASS_GRANULARITY >= SIZECLASS_CACHE_BYTES)
+	{
+		free(p);
+		return;
+	}
+	sizeclass_freeblock* b = reinterpret_cast<sizeclass_freeblock*>(p);
+	b->next = cache.freelists[c];
+	cache.freelists[c] = b;
+	cache.freecount[c]++;
+}
+
+void lightspark::sizeclass_release_thread_cache()
+{
+	threadcache.release();
+}
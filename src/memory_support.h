@@ -31,6 +31,23 @@
 namespace lightspark
 {
 
+/*
+ * Allocator for objects derived from memory_reporter.
+ * Blocks up to SIZECLASS_MAX_SIZE bytes are rounded up to multiples of SIZECLASS_GRANULARITY.
+ * Freed blocks are kept in per-thread lists for every size class and are reused by the next allocation
+ * of the same size class, so bursts of short-lived objects don't have to go through malloc.
+ * The cached blocks of a thread are released when the thread (e.g. a worker) terminates.
+ */
+#define SIZECLASS_GRANULARITY 16
+#define SIZECLASS_MAX_SIZE 1024
+#define SIZECLASS_COUNT (SIZECLASS_MAX_SIZE/SIZECLASS_GRANULARITY)
+// maximum number of bytes cached per size class and thread
+#define SIZECLASS_CACHE_BYTES (128*1024)
+DLL_PUBLIC void* sizeclass_allocate(size_t size);
+DLL_PUBLIC void sizeclass_free(void* p, size_t size);
+// frees all blocks cached by the current thread
+DLL_PUBLIC void sizeclass_release_thread_cache();
+
 #ifdef MEMORY_USAGE_PROFILING
 class MemoryAccount;
 DLL_PUBLIC MemoryAccount* getUnaccountedMemoryAccount();
@@ -79,7 +96,7 @@ public:
 		//Prepend some internal data.
 		//Adding the data to the object itself would not work
 		//since it can be reset by the constructors
-		objData* ret=reinterpret_cast<objData*>(malloc(size+sizeof(objData)));
+		objData* ret=reinterpret_cast<objData*>(sizeclass_allocate(size+sizeof(objData)));
 		if(!m)
 			m = getUnaccountedMemoryAccount();
 		m->addBytes(size);
@@ -87,12 +104,12 @@ public:
 		ret->memoryAccount = m;
 		return ret+1;
 	}
-	inline void operator delete( void* obj )
+	inline void operator delete( void* obj, size_t )
 	{
 		//Get back the metadata
 		objData* th=reinterpret_cast<objData*>(obj)-1;
 		th->memoryAccount->removeBytes(th->objSize);
-		free(th);
+		sizeclass_free(th,th->objSize+sizeof(objData));
 	}
 };
 
@@ -187,11 +204,12 @@ public:
 	//Regular allocator
 	inline void* operator new( size_t size, MemoryAccount* m)
 	{
-		return malloc(size);
+		return sizeclass_allocate(size);
 	}
-	inline void operator delete( void* obj )
+	//The size is the one of the dynamic type, as objects are deleted through virtual destructors
+	inline void operator delete( void* obj, size_t size )
 	{
-		free(obj);
+		sizeclass_free(obj,size);
 	}
 };
 
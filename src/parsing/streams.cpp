@@ -50,6 +50,9 @@ int uncompressing_filter::underflow()
 
 	int available=fillBuffer();
 	setg(buffer,buffer,buffer+available);
+	// the end of the stream may be reached without producing any output
+	if(available==0)
+		return -1;
 	
 	//Cast to unsigned, otherwise 0xff would become eof
 	return (unsigned char)buffer[0];
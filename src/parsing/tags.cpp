@@ -96,6 +96,15 @@ Tag* TagFactory::readTag(RootMovieClip* root, DefineSpriteTag *sprite)
 		unsigned int expectedLen=h.getLength();
 		unsigned int start=f.tellg();
 		LOG(LOG_TRACE,"Reading tag type: " << h.getTagType() << " at byte " << start << " with length " << expectedLen << " bytes");
+		if(pipeline && !datatag && pipeline->processTag(h,f))
+		{
+			//The tag is constructed in the ThreadPool, continue with the next one
+			firstTag=false;
+			if (reportProgress)
+				root->loaderInfo->setBytesLoaded(f.tellg());
+			done = false;
+			continue;
+		}
 		switch(h.getTagType())
 		{
 			case 0:
@@ -324,7 +333,8 @@ Tag* TagFactory::readTag(RootMovieClip* root, DefineSpriteTag *sprite)
 			//throw ParseException("Malformed SWF file");
 		}
 
-		root->loaderInfo->setBytesLoaded(f.tellg());
+		if (reportProgress)
+			root->loaderInfo->setBytesLoaded(f.tellg());
 	}
 	if (datatag)
 	{
@@ -334,6 +344,210 @@ Tag* TagFactory::readTag(RootMovieClip* root, DefineSpriteTag *sprite)
 	return ret;
 }
 
+ParseTagJob::ParseTagJob(ParseThread* p, RootMovieClip* r, std::string& d, int _id):parsethread(p),root(r),mappedOffset(0),mappedLength(0),tag(nullptr),state(PENDING),owners(2),id(_id)
+{
+	data.swap(d);
+}
+
+ParseTagJob::ParseTagJob(ParseThread* p, RootMovieClip* r, _R<MappedFile> f, size_t offset, size_t length, int _id):
+	parsethread(p),root(r),mappedFile(f),mappedOffset(offset),mappedLength(length),tag(nullptr),state(PENDING),owners(2),id(_id)
+{
+}
+
+void ParseTagJob::construct()
+{
+	// read from the mapping, so the tag can reference its data instead of copying it
+	std::streambuf* buf;
+	if (!mappedFile.isNull())
+		buf = new MappedFileReader(mappedFile,mappedOffset,mappedLength);
+	else
+		buf = new stringbuf(data,ios_base::in);
+	istream s(buf);
+	s.exceptions ( istream::eofbit | istream::failbit | istream::badbit );
+	TagFactory factory(s,nullptr,false);
+	try
+	{
+		tag=factory.readTag(root);
+	}
+	catch(std::exception& e)
+	{
+		LOG(LOG_ERROR,"Exception while parsing tag "<<id<<" in ThreadPool:"<<e.what());
+		tag=nullptr;
+	}
+	delete buf;
+	std::string().swap(data);
+	mappedFile.reset();
+}
+
+bool ParseTagJob::isDone()
+{
+	Locker l(mutex);
+	return state==DONE;
+}
+
+Tag* ParseTagJob::getTag()
+{
+	Locker l(mutex);
+	if (state==PENDING)
+	{
+		state=RUNNING;
+		l.release();
+		construct();
+		l.acquire();
+		state=DONE;
+	}
+	while (state!=DONE)
+		finished.wait(mutex);
+	return tag;
+}
+
+void ParseTagJob::release()
+{
+	if (--owners == 0)
+		delete this;
+}
+
+void ParseTagJob::execute()
+{
+	{
+		Locker l(mutex);
+		if (state!=PENDING)
+			return;
+		state=RUNNING;
+	}
+	// shapes look up bitmaps through the ParseThread
+	setTLSParseThread(parsethread);
+	construct();
+	setTLSParseThread(nullptr);
+	Locker l(mutex);
+	state=DONE;
+	finished.broadcast();
+}
+
+void ParseTagJob::jobFence()
+{
+	release();
+}
+
+ParseTagPipeline::~ParseTagPipeline()
+{
+	collect(true);
+}
+
+bool ParseTagPipeline::isDeferrable(unsigned int tagtype)
+{
+	switch (tagtype)
+	{
+		case 2: // DefineShape
+		case 14: // DefineSound
+		case 22: // DefineShape2
+		case 32: // DefineShape3
+		case 46: // DefineMorphShape
+		case 83: // DefineShape4
+		case 84: // DefineMorphShape2
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool ParseTagPipeline::isIndependent(unsigned int tagtype)
+{
+	switch (tagtype)
+	{
+		case 6: // DefineBits
+		case 8: // JPEGTables
+		case 20: // DefineBitsLossless
+		case 21: // DefineBitsJPEG2
+		case 35: // DefineBitsJPEG3
+		case 36: // DefineBitsLossless2
+		case 87: // DefineBinaryData
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool ParseTagPipeline::processTag(const RECORDHEADER& h, istream& in)
+{
+	collect(false);
+	unsigned int tagtype = h.getTagType();
+	if (!isDeferrable(tagtype) || h.getLength() < 2 || h.getLength() > PARSETAGPIPELINE_MAXTAGSIZE)
+	{
+		// the tag may look up any tag defined before
+		if (!isIndependent(tagtype))
+			collect(true);
+		return false;
+	}
+	uint32_t len = h.getLength();
+	std::string data;
+	_NR<MappedFile> file;
+	const uint8_t* body = MappedFileReader::readSlice(in,len,file);
+	if (!body)
+	{
+		// store the tag with a long header, so it can be read by a TagFactory
+		data.resize(len+6);
+		uint16_t codeandlen = GUINT16_TO_LE((tagtype<<6)|0x3f);
+		uint32_t length = GUINT32_TO_LE(len);
+		memcpy(&data[0],&codeandlen,2);
+		memcpy(&data[2],&length,4);
+		in.read(&data[6],len);
+		body = (const uint8_t*)&data[6];
+	}
+
+	// the first field of all deferred tags is the character id
+	int id = body[0] | (body[1]<<8);
+	// a redefined id has to be added to the dictionary after the previous definition
+	if (isPending(id))
+		collect(true);
+	while (pending.size() >= PARSETAGPIPELINE_MAXPENDING)
+	{
+		ParseTagJob* job = pending.front();
+		Tag* tag = job->getTag();
+		pending.pop_front();
+		job->release();
+		if (tag)
+			root->applicationDomain->addToDictionary(static_cast<DictionaryTag*>(tag));
+	}
+	ParseTagJob* job;
+	if (!file.isNull())
+	{
+		// the mapping still contains the original header in front of the body
+		size_t offset = (body-file->getData())-h.getHeaderSize();
+		job = new ParseTagJob(parsethread,root,file,offset,len+h.getHeaderSize(),id);
+	}
+	else
+		job = new ParseTagJob(parsethread,root,data,id);
+	pending.push_back(job);
+	root->getSystemState()->addJob(job);
+	return true;
+}
+
+void ParseTagPipeline::collect(bool all)
+{
+	while (!pending.empty())
+	{
+		ParseTagJob* job = pending.front();
+		if (!all && !job->isDone())
+			break;
+		Tag* tag = job->getTag();
+		pending.pop_front();
+		job->release();
+		if (tag)
+			root->applicationDomain->addToDictionary(static_cast<DictionaryTag*>(tag));
+	}
+}
+
+bool ParseTagPipeline::isPending(int id) const
+{
+	for (auto it = pending.begin(); it != pending.end(); it++)
+	{
+		if ((*it)->id == id)
+			return true;
+	}
+	return false;
+}
+
 RemoveObject2Tag::RemoveObject2Tag(RECORDHEADER h, std::istream& in):DisplayListTag(h)
 {
 	in >> Depth;
@@ -1318,19 +1532,105 @@ ASObject* DefineFont4Tag::instance(Class_base* c)
 	return ret;
 }
 
-BitmapTag::BitmapTag(RECORDHEADER h,RootMovieClip* root):DictionaryTag(h,root),bitmap(_MR(new BitmapContainer(root->getSystemState()->tagsMemory)))
+BitmapTagPayload::BitmapTagPayload(SystemState* s, _NR<BitmapContainer> b):decoded(false),sys(s),bitmap(b),id(0),lossless(false),
+	tablesData(nullptr),tablesLen(0),losslessFormat(0),losslessWidth(0),losslessHeight(0),losslessColorTableSize(0),losslessVersion(0),decodedSize(0),eagerDecodeReservation(0)
 {
 }
 
-BitmapTag::~BitmapTag()
+BitmapTagPayload::~BitmapTagPayload()
 {
-	bitmap.reset();
+	if (eagerDecodeReservation)
+		sys->eagerBitmapDecodeMemory.fetch_sub(eagerDecodeReservation);
 }
 
-_NR<BitmapContainer> BitmapTag::getBitmap() const {
-	return bitmap;
+void BitmapTagPayload::computeDecodedSize()
+{
+	decodedSize=0;
+	if (lossless)
+	{
+		decodedSize = uint64_t(losslessWidth)*losslessHeight*4;
+		return;
+	}
+	const uint8_t* d = data.data();
+	size_t len = data.size();
+	// broken jpegs starting with the jpeg "end of file" magic bytes are skipped the same way as in decodeImage
+	if (len >= 4 && d[0]==0xff && d[1]==0xd9)
+	{
+		d += 4;
+		len -= 4;
+	}
+	if (len >= 24 && d[0]==0x89 && d[1]=='P' && d[2]=='N' && d[3]=='G')
+	{
+		// the IHDR chunk always comes first
+		uint64_t w = (uint32_t(d[16])<<24)|(uint32_t(d[17])<<16)|(uint32_t(d[18])<<8)|d[19];
+		uint64_t h = (uint32_t(d[20])<<24)|(uint32_t(d[21])<<16)|(uint32_t(d[22])<<8)|d[23];
+		decodedSize = w*h*4;
+	}
+	else if (len >= 4 && d[0]==0xff && d[1]==0xd8)
+	{
+		// look for the start of frame marker
+		size_t pos = 2;
+		while (pos+9 <= len)
+		{
+			if (d[pos] != 0xff)
+				return;
+			uint8_t marker = d[pos+1];
+			if (marker == 0xff)
+			{
+				// fill byte
+				pos++;
+				continue;
+			}
+			if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+			{
+				uint64_t h = (uint32_t(d[pos+5])<<8)|d[pos+6];
+				uint64_t w = (uint32_t(d[pos+7])<<8)|d[pos+8];
+				decodedSize = w*h*4;
+				return;
+			}
+			// markers without a length, swf files may contain additional end/start of image markers before the image
+			if (marker == 0xd8 || marker == 0xd9 || marker == 0x01 || (marker >= 0xd0 && marker <= 0xd7))
+				pos += 2;
+			else
+				pos += 2+((uint32_t(d[pos+2])<<8)|d[pos+3]);
+		}
+	}
 }
-void BitmapTag::loadBitmap(uint8_t* inData, int datasize, const uint8_t *tablesData, int tablesLen)
+
+bool BitmapTagPayload::decode()
+{
+	if (decoded)
+		return false;
+	Locker l(mutex);
+	if (decoded)
+		return false;
+	try
+	{
+		if (lossless)
+			decodeLossless();
+		else
+		{
+			decodeImage(const_cast<uint8_t*>(data.data()),data.size());
+			if (!alphaData.empty())
+				decodeAlpha();
+		}
+	}
+	catch(std::exception& e)
+	{
+		LOG(LOG_ERROR,"decoding bitmap for ID "<<id<<" failed:"<<e.what());
+	}
+	data.clear();
+	alphaData.clear();
+	decoded=true;
+	return true;
+}
+
+bool BitmapTagPayload::allowsEagerDecoding() const
+{
+	return lossless || data.size() < 4 || memcmp(data.data(),"GIF8",4)!=0;
+}
+
+void BitmapTagPayload::decodeImage(uint8_t* inData, int datasize)
 {
 	if (datasize < 4)
 		return;
@@ -1339,82 +1639,177 @@ void BitmapTag::loadBitmap(uint8_t* inData, int datasize, const uint8_t *tablesD
 	else if(inData[0]==0xff && inData[1]==0xd8 && inData[2]==0xff)
 		bitmap->fromJPEG(inData,datasize,tablesData,tablesLen);
 	else if(inData[0]=='G' && inData[1]=='I' && inData[2]=='F' && inData[3]=='8')
-		bitmap->fromGIF(inData,datasize,loadedFrom->getSystemState());
+		bitmap->fromGIF(inData,datasize,sys);
 	else if(inData[0]==0xff && inData[1]==0xd9)
 		// I've found swf files with broken jpegs that start with the jpeg "end of file" magic bytes and two times the "begin of file" magic bytes
 		// so we just ignore the first 4 bytes
 		// TODO check if libjpeg has a better common way to deal with invalid headers
-		loadBitmap(inData+4, datasize-4, tablesData, tablesLen);
+		decodeImage(inData+4, datasize-4);
 	else
-		LOG(LOG_ERROR,"unknown image format for ID "<<getId());
+		LOG(LOG_ERROR,"unknown image format for ID "<<id);
 }
-DefineBitsLosslessTag::DefineBitsLosslessTag(RECORDHEADER h, istream& in, int version, RootMovieClip* root):BitmapTag(h,root),BitmapColorTableSize(0)
+
+void BitmapTagPayload::decodeAlpha()
 {
-	int dest=in.tellg();
-	dest+=h.getLength();
-	in >> CharacterId >> BitmapFormat >> BitmapWidth >> BitmapHeight;
-	if(BitmapFormat==LOSSLESS_BITMAP_PALETTE)
-		in >> BitmapColorTableSize;
+	//Create a zlib filter
+	bytes_buf alphaBuf(alphaData.data(),alphaData.size());
+	zlib_filter zf(&alphaBuf);
+	istream zfstream(&zf);
+	zfstream.exceptions ( istream::eofbit | istream::failbit | istream::badbit );
 
-	string cData;
-	size_t cSize = dest-in.tellg(); //rest of this tag
-	cData.resize(cSize);
-	in.read(&cData[0], cSize);
-	istringstream cDataStream(cData);
-	zlib_filter zf(cDataStream.rdbuf());
+	vector<char> alphaDataUncompressed;
+	alphaDataUncompressed.resize(bitmap->getHeight()*bitmap->getWidth());
+
+	//Catch the exception if the stream ends
+	try
+	{
+		zfstream.read(alphaDataUncompressed.data(),bitmap->getHeight()*bitmap->getWidth());
+	}
+	catch(std::exception& e)
+	{
+		LOG(LOG_ERROR, "Exception while parsing Alpha data in DefineBitsJPEG3");
+	}
+	uint8_t* d = bitmap->getData();
+	//Set alpha
+	for(int32_t i=0;i<bitmap->getHeight()*bitmap->getWidth();i++)
+	{
+		d[i*4+3]=alphaDataUncompressed[i];
+	}
+}
+
+void BitmapTagPayload::decodeLossless()
+{
+	bytes_buf cDataBuf(data.data(),data.size());
+	zlib_filter zf(&cDataBuf);
 	istream zfstream(&zf);
 
-	if (BitmapFormat == LOSSLESS_BITMAP_RGB15 ||
-	    BitmapFormat == LOSSLESS_BITMAP_RGB24)
+	if (losslessFormat == LOSSLESS_BITMAP_RGB15 ||
+	    losslessFormat == LOSSLESS_BITMAP_RGB24)
 	{
-		size_t size = BitmapWidth * BitmapHeight * 4;
+		size_t size = losslessWidth * losslessHeight * 4;
 		uint8_t* inData=new(nothrow) uint8_t[size];
 		zfstream.read((char*)inData,size);
 		assert(!zfstream.fail() && !zfstream.eof());
 
 		BitmapContainer::BITMAP_FORMAT format;
-		if (BitmapFormat == LOSSLESS_BITMAP_RGB15)
+		if (losslessFormat == LOSSLESS_BITMAP_RGB15)
 			format = BitmapContainer::RGB15;
-		else if (version == 1)
+		else if (losslessVersion == 1)
 			format = BitmapContainer::RGB32;
 		else
 			format = BitmapContainer::ARGB32;
 
-		bitmap->fromRGB(inData, BitmapWidth, BitmapHeight, format);
+		bitmap->fromRGB(inData, losslessWidth, losslessHeight, format);
 	}
-	else if (BitmapFormat == LOSSLESS_BITMAP_PALETTE)
+	else if (losslessFormat == LOSSLESS_BITMAP_PALETTE)
 	{
-		unsigned numColors = BitmapColorTableSize+1;
+		unsigned numColors = losslessColorTableSize+1;
 
 		/* Bitmap rows are 32 bit aligned */
-		uint32_t stride = BitmapWidth;
+		uint32_t stride = losslessWidth;
 		while (stride % 4 != 0)
 			stride++;
 
 		unsigned int paletteBPP;
-		if (version == 1)
+		if (losslessVersion == 1)
 			paletteBPP = 3;
 		else
 			paletteBPP = 4;
 
-		size_t size = paletteBPP*numColors + stride*BitmapHeight;
+		size_t size = paletteBPP*numColors + stride*losslessHeight;
 		uint8_t* inData=new(nothrow) uint8_t[size];
 		zfstream.read((char*)inData,size);
 		assert(!zfstream.fail() && !zfstream.eof());
 
 		uint8_t *palette = inData;
 		uint8_t *pixelData = inData + paletteBPP*numColors;
-		bitmap->fromPalette(pixelData, BitmapWidth, BitmapHeight, stride, palette, numColors, paletteBPP);
+		bitmap->fromPalette(pixelData, losslessWidth, losslessHeight, stride, palette, numColors, paletteBPP);
 		delete[] inData;
 	}
 	else
 	{
-		LOG(LOG_NOT_IMPLEMENTED,"DefineBitsLossless(2)Tag with unsupported BitmapFormat " << BitmapFormat);
+		LOG(LOG_NOT_IMPLEMENTED,"DefineBitsLossless(2)Tag with unsupported BitmapFormat " << losslessFormat);
+	}
+}
+
+BitmapDecodeJob::BitmapDecodeJob(SystemState* s, _R<BitmapTagPayload> p):sys(s),payload(p)
+{
+}
+
+void BitmapDecodeJob::execute()
+{
+	if (threadAborting)
+		return;
+	// the size is reserved before decoding, so concurrent jobs can't exceed the budget
+	// if the budget is exceeded the bitmap is decoded on first use
+	int32_t size = payload->decodedSize;
+	if (ATOMIC_ADD(sys->eagerBitmapDecodeMemory,size) > BITMAPTAG_EAGER_DECODE_BUDGET)
+	{
+		sys->eagerBitmapDecodeMemory.fetch_sub(size);
+		return;
 	}
+	// the bitmap was already decoded on first use
+	if (!payload->decode())
+		sys->eagerBitmapDecodeMemory.fetch_sub(size);
+	else
+		payload->eagerDecodeReservation=size;
+}
+
+void BitmapDecodeJob::jobFence()
+{
+	delete this;
+}
+
+BitmapTag::BitmapTag(RECORDHEADER h,RootMovieClip* root):DictionaryTag(h,root),bitmap(_MR(new BitmapContainer(root->getSystemState()->tagsMemory))),
+	payload(_MR(new BitmapTagPayload(root->getSystemState(),bitmap)))
+{
+}
+
+BitmapTag::~BitmapTag()
+{
+	bitmap.reset();
+}
+
+void BitmapTag::decodeInBackground()
+{
+	SystemState* sys = loadedFrom->getSystemState();
+	if (sys->runSingleThreaded || sys->isShuttingDown() || sys->eagerBitmapDecodeMemory >= BITMAPTAG_EAGER_DECODE_BUDGET || !payload->allowsEagerDecoding())
+		return;
+	// bitmaps without a readable size can't be accounted for, so they are decoded on first use
+	payload->computeDecodedSize();
+	if (payload->decodedSize == 0 || payload->decodedSize > BITMAPTAG_EAGER_DECODE_BUDGET)
+		return;
+	sys->addJob(new BitmapDecodeJob(sys,payload));
+}
+
+_NR<BitmapContainer> BitmapTag::getBitmap() const {
+	payload->decode();
+	return bitmap;
+}
+DefineBitsLosslessTag::DefineBitsLosslessTag(RECORDHEADER h, istream& in, int version, RootMovieClip* root):BitmapTag(h,root),BitmapColorTableSize(0)
+{
+	int dest=in.tellg();
+	dest+=h.getLength();
+	in >> CharacterId >> BitmapFormat >> BitmapWidth >> BitmapHeight;
+	if(BitmapFormat==LOSSLESS_BITMAP_PALETTE)
+		in >> BitmapColorTableSize;
+
+	//Read the zlib compressed pixels, they are decoded on first use
+	size_t cSize = dest-in.tellg(); //rest of this tag
+	payload->id = CharacterId;
+	payload->lossless = true;
+	payload->losslessFormat = BitmapFormat;
+	payload->losslessWidth = BitmapWidth;
+	payload->losslessHeight = BitmapHeight;
+	payload->losslessColorTableSize = BitmapColorTableSize;
+	payload->losslessVersion = version;
+	payload->data.read(in, cSize);
+	decodeInBackground();
 }
 
 ASObject* BitmapTag::instance(Class_base* c)
 {
+	payload->decode();
 	//Flex imports bitmaps using BitmapAsset as the base class, which is derived from bitmap
 	//Also BitmapData is used in the wild though, so support both cases
 
@@ -1617,6 +2012,17 @@ ASObject *DefineShapeTag::instance(Class_base *c)
 			it->FillType.ShapeBounds = ShapeBounds;
 		}
 		TokenContainer::FromShaperecordListToShapeVector(Shapes.ShapeRecords,*tokens,false,MATRIX(),Shapes.FillStyles.FillStyles,Shapes.LineStyles.LineStyles2,ShapeBounds);
+		if (tokens->filltokens)
+			tokens->filltokens->immutable=true;
+		if (tokens->stroketokens)
+			tokens->stroketokens->immutable=true;
+		// the tokens of a shape tag never change, so their tessellation can be shared by all instances
+		// non-scaling strokes depend on the matrix of the instance, so they can't be cached
+		bool hasNonScalingStrokes = false;
+		for (auto it = Shapes.LineStyles.LineStyles2.begin(); it != Shapes.LineStyles.LineStyles2.end(); it++)
+			hasNonScalingStrokes |= it->NoHScaleFlag || it->NoVScaleFlag;
+		if (!hasNonScalingStrokes)
+			tokens->tessellation = _MR(new tessellationCache());
 	}
 	Shape* ret=nullptr;
 	if(c==nullptr)
@@ -2470,15 +2876,13 @@ DefineBinaryDataTag::DefineBinaryDataTag(RECORDHEADER h,std::istream& s,RootMovi
 	int size=h.getLength();
 	s >> Tag >> Reserved;
 	size -= sizeof(Tag)+sizeof(Reserved);
-	bytes=new uint8_t[size];
-	len=size;
-	s.read((char*)bytes,size);
+	bytes.read(s,size);
 }
 
 ASObject* DefineBinaryDataTag::instance(Class_base* c)
 {
-	uint8_t* b = new uint8_t[len];
-	memcpy(b,bytes,len);
+	uint8_t* b = new uint8_t[bytes.size()];
+	memcpy(b,bytes.data(),bytes.size());
 
 	Class_base* classRet = nullptr;
 	if(c)
@@ -2488,7 +2892,7 @@ ASObject* DefineBinaryDataTag::instance(Class_base* c)
 	else
 		classRet=Class<ByteArray>::getClass(loadedFrom->getSystemState());
 
-	ByteArray* ret=new (classRet->memoryAccount) ByteArray(loadedFrom->getInstanceWorker(),classRet, b, len);
+	ByteArray* ret=new (classRet->memoryAccount) ByteArray(loadedFrom->getInstanceWorker(),classRet, b, bytes.size());
 	return ret;
 }
 
@@ -2643,21 +3047,31 @@ DefineSoundTag::DefineSoundTag(RECORDHEADER h, std::istream& in, RootMovieClip*
 		}
 		default:
 		{
-			//TODO: get rid of the temporary copy
-			uint8_t* tmp = new uint8_t[soundDataLength];
-			in.read((char *)tmp, soundDataLength);
-			unsigned char *tmpp = tmp;
+			_NR<MappedFile> file;
+			const unsigned char* mapped = MappedFileReader::readSlice(in, soundDataLength, file);
+			uint8_t* tmp = nullptr;
+			const unsigned char *tmpp = mapped;
+			if (!mapped)
+			{
+				tmp = new uint8_t[soundDataLength];
+				in.read((char *)tmp, soundDataLength);
+				tmpp = tmp;
+			}
 			// it seems that adobe allows zeros at the beginning of the sound data
 			// at least for MP3 we ignore them, otherwise ffmpeg will not work properly
 			if (SoundFormat == LS_AUDIO_CODEC::MP3)
 			{
-				while (*tmpp == 0 && soundDataLength)
+				while (soundDataLength && *tmpp == 0)
 				{
 					soundDataLength--;
 					tmpp++;
 				}
 			}
-			SoundData->append(tmpp, soundDataLength);
+			// reference the sound data in the mapped file instead of copying it
+			if (mapped)
+				SoundData->appendMapped(file, tmpp, soundDataLength);
+			else
+				SoundData->append(tmpp, soundDataLength);
 			delete[] tmp;
 		}
 	}
@@ -2940,24 +3354,24 @@ DefineBitsTag::DefineBitsTag(RECORDHEADER h, std::istream& in,RootMovieClip* roo
 	}
 
 	in >> CharacterId;
-	//Read image data
+	//Read image data, it is decoded on first use
 	int dataSize=Header.getLength()-2;
-	uint8_t *inData=new(nothrow) uint8_t[dataSize];
-	in.read((char*)inData,dataSize);
-	loadBitmap(inData,dataSize,JPEGTablesTag::getJPEGTables(),JPEGTablesTag::getJPEGTableSize());
-	delete[] inData;
+	payload->id = CharacterId;
+	payload->tablesData = JPEGTablesTag::getJPEGTables();
+	payload->tablesLen = JPEGTablesTag::getJPEGTableSize();
+	payload->data.read(in,dataSize);
+	decodeInBackground();
 }
 
 DefineBitsJPEG2Tag::DefineBitsJPEG2Tag(RECORDHEADER h, std::istream& in, RootMovieClip* root):BitmapTag(h,root)
 {
 	LOG(LOG_TRACE,"DefineBitsJPEG2Tag Tag");
 	in >> CharacterId;
-	//Read image data
+	//Read image data, it is decoded on first use
 	int dataSize=Header.getLength()-2;
-	uint8_t* inData=new(nothrow) uint8_t[dataSize];
-	in.read((char*)inData,dataSize);
-	loadBitmap(inData,dataSize);
-	delete[] inData;
+	payload->id = CharacterId;
+	payload->data.read(in,dataSize);
+	decodeInBackground();
 }
 
 DefineBitsJPEG3Tag::DefineBitsJPEG3Tag(RECORDHEADER h, std::istream& in, RootMovieClip* root):BitmapTag(h,root),alphaData(NULL)
@@ -2965,45 +3379,17 @@ DefineBitsJPEG3Tag::DefineBitsJPEG3Tag(RECORDHEADER h, std::istream& in, RootMov
 	LOG(LOG_TRACE,"DefineBitsJPEG3Tag Tag");
 	UI32_SWF dataSize;
 	in >> CharacterId >> dataSize;
-	//Read image data
-	uint8_t* inData=new(nothrow) uint8_t[dataSize];
-	in.read((char*)inData,dataSize);
-
-	loadBitmap(inData,dataSize);
-	delete[] inData;
+	//Read image data, it is decoded on first use
+	payload->id = CharacterId;
+	payload->data.read(in,dataSize);
 
 	//Read alpha data (if any)
 	int alphaSize=Header.getLength()-dataSize-6;
 	if(alphaSize>0) //If less that 0 the consistency check on tag size will stop later
 	{
-		//Create a zlib filter
-		string alphaData;
-		alphaData.resize(alphaSize);
-		in.read(&alphaData[0], alphaSize);
-		istringstream alphaStream(alphaData);
-		zlib_filter zf(alphaStream.rdbuf());
-		istream zfstream(&zf);
-		zfstream.exceptions ( istream::eofbit | istream::failbit | istream::badbit );
-
-		vector<char> alphaDataUncompressed;
-		alphaDataUncompressed.resize(bitmap->getHeight()*bitmap->getWidth());
-		
-		//Catch the exception if the stream ends
-		try
-		{
-			zfstream.read(alphaDataUncompressed.data(),bitmap->getHeight()*bitmap->getWidth());
-		}
-		catch(std::exception& e)
-		{
-			LOG(LOG_ERROR, "Exception while parsing Alpha data in DefineBitsJPEG3");
-		}
-		uint8_t* d = bitmap->getData();
-		//Set alpha
-		for(int32_t i=0;i<bitmap->getHeight()*bitmap->getWidth();i++)
-		{
-			d[i*4+3]=alphaDataUncompressed[i];
-		}
+		payload->alphaData.read(in, alphaSize);
 	}
+	decodeInBackground();
 }
 
 DefineBitsJPEG3Tag::~DefineBitsJPEG3Tag()
@@ -26,6 +26,7 @@
 #include "swftypes.h"
 #include "backends/geometry.h"
 #include "backends/decoder.h"
+#include "backends/streamcache.h"
 #include "scripting/flash/display/flashdisplay.h"
 #include "scripting/flash/display/MovieClip.h"
 
@@ -37,6 +38,7 @@ class ApplicationDomain;
 class DisplayObjectContainer;
 class DefineSpriteTag;
 class AdditionalDataTag;
+class ParseThread;
 
 enum TAGTYPE {TAG=0,DISPLAY_LIST_TAG,SHOW_TAG,CONTROL_TAG,DICT_TAG,FRAMELABEL_TAG,SYMBOL_CLASS_TAG,ACTION_TAG,ABC_TAG,END_TAG,
 			  AVM1ACTION_TAG,AVM1INITACTION_TAG,BUTTONSOUND_TAG, FILEATTRIBUTES_TAG,METADATA_TAG,BACKGROUNDCOLOR_TAG,ENABLEDEBUGGER_TAG,DEFINESCALINGGRID_TAG};
@@ -119,7 +121,7 @@ public:
 class AVM1ActionTag: public DisplayListTag
 {
 private:
-	std::vector<uint8_t> actions;
+	AVM1ActionList actions;
 	uint32_t startactionpos;
 public:
 	AVM1ActionTag(RECORDHEADER h, std::istream& s,RootMovieClip* root, AdditionalDataTag* datatag);
@@ -132,7 +134,7 @@ class AVM1InitActionTag: public ControlTag
 {
 private:
 	UI16_SWF SpriteId;
-	std::vector<uint8_t> actions;
+	AVM1ActionList actions;
 	uint32_t startactionpos;
 public:
 	AVM1InitActionTag(RECORDHEADER h, std::istream& s,RootMovieClip* root, AdditionalDataTag* datatag);
@@ -449,11 +451,9 @@ class DefineBinaryDataTag: public DictionaryTag
 private:
 	UI16_SWF Tag;
 	UI32_SWF Reserved;
-	uint8_t* bytes;
-	uint32_t len;
+	StreamData bytes;
 public:
 	DefineBinaryDataTag(RECORDHEADER h,std::istream& s,RootMovieClip* root);
-	~DefineBinaryDataTag() { delete[] bytes; }
 	int getId() const override {return Tag;}
 	ASObject* instance(Class_base* c=nullptr) override;
 };
@@ -648,16 +648,86 @@ public:
 
 class BitmapContainer;
 
+// maximum amount of bitmap memory a SystemState decodes in advance in the ThreadPool
+#define BITMAPTAG_EAGER_DECODE_BUDGET (128*1024*1024)
+
+/*
+ * The compressed data of a bitmap tag. It is decoded into the BitmapContainer of the tag
+ * on first use or in advance by a BitmapDecodeJob.
+ * It is refcounted, so a pending BitmapDecodeJob may outlive the tag
+ */
+class BitmapTagPayload: public RefCountable
+{
+private:
+	Mutex mutex;
+	ACQUIRE_RELEASE_FLAG(decoded);
+	void decodeImage(uint8_t* inData, int datasize);
+	void decodeAlpha();
+	void decodeLossless();
+public:
+	SystemState* sys;
+	_NR<BitmapContainer> bitmap;
+	int id;
+	bool lossless;
+	// jpeg/png/gif image, or the zlib compressed pixels of DefineBitsLossless
+	StreamData data;
+	// zlib compressed alpha channel of DefineBitsJPEG3
+	StreamData alphaData;
+	const uint8_t* tablesData;
+	int tablesLen;
+	// DefineBitsLossless(2) header
+	uint8_t losslessFormat;
+	uint16_t losslessWidth;
+	uint16_t losslessHeight;
+	uint8_t losslessColorTableSize;
+	int losslessVersion;
+	// size of the decoded pixels as read from the image header, 0 if it is unknown
+	uint64_t decodedSize;
+	// bytes of SystemState::eagerBitmapDecodeMemory reserved by the BitmapDecodeJob that decoded this payload, released on destruction
+	int32_t eagerDecodeReservation;
+	BitmapTagPayload(SystemState* s, _NR<BitmapContainer> b);
+	~BitmapTagPayload();
+	// reads the image size from the header of the data, has to be called when the payload is complete and not yet decoded
+	void computeDecodedSize();
+	/*
+	 * Decodes the data into the bitmap and releases it.
+	 * Returns false if the data was already decoded.
+	 * It is safe to call this concurrently
+	 */
+	bool decode();
+	bool isDecoded() const { return decoded; }
+	// gifs are decoded with ffmpeg, so they are only decoded on first use
+	bool allowsEagerDecoding() const;
+};
+
+// decodes a BitmapTagPayload in the ThreadPool, as long as the memory budget is not exceeded
+class BitmapDecodeJob: public IThreadJob
+{
+private:
+	SystemState* sys;
+	_R<BitmapTagPayload> payload;
+public:
+	BitmapDecodeJob(SystemState* s, _R<BitmapTagPayload> p);
+	//IThreadJob interface
+	void execute() override;
+	void jobFence() override;
+};
+
 class BitmapTag: public DictionaryTag
 {
 protected:
 	_NR<BitmapContainer> bitmap;
-	void loadBitmap(uint8_t* inData, int datasize, const uint8_t *tablesData=nullptr, int tablesLen=0);
+	// the bitmap is decoded on first use of instance() or getBitmap()
+	_R<BitmapTagPayload> payload;
+	// starts decoding the payload in the ThreadPool, has to be called when the payload is complete
+	void decodeInBackground();
 public:
 	BitmapTag(RECORDHEADER h,RootMovieClip* root);
 	~BitmapTag();
 	ASObject* instance(Class_base* c=nullptr) override;
 	_NR<BitmapContainer> getBitmap() const;
+	// the payload is not decoded, used by bitmap fills that are decoded on first use
+	_R<BitmapTagPayload> getPayload() const { return payload; }
 };
 
 class JPEGTablesTag: public Tag
@@ -895,13 +965,89 @@ public:
 	NameCharacterTag(RECORDHEADER h, std::istream& in, RootMovieClip *root);
 };
 
+// maximum number of deferred tags that are constructed concurrently
+#define PARSETAGPIPELINE_MAXPENDING 64
+// larger tags are always constructed by the ParseThread
+#define PARSETAGPIPELINE_MAXTAGSIZE (16*1024*1024)
+
+/*
+ * Constructs a deferred tag from its raw data in the ThreadPool.
+ * It is owned by the ParseTagPipeline and the ThreadPool, and deleted by whichever releases it last
+ */
+class ParseTagJob: public IThreadJob
+{
+private:
+	ParseThread* parsethread;
+	RootMovieClip* root;
+	// the tag including its header, either copied or as a slice of the mapped file
+	std::string data;
+	_NR<MappedFile> mappedFile;
+	size_t mappedOffset;
+	size_t mappedLength;
+	Tag* tag;
+	Mutex mutex;
+	Cond finished;
+	enum STATE { PENDING, RUNNING, DONE };
+	STATE state;
+	ATOMIC_INT32(owners);
+	void construct();
+public:
+	int id;
+	ParseTagJob(ParseThread* p, RootMovieClip* r, std::string& d, int _id);
+	ParseTagJob(ParseThread* p, RootMovieClip* r, _R<MappedFile> f, size_t offset, size_t length, int _id);
+	bool isDone();
+	/*
+	 * Returns the constructed tag, or nullptr if the tag could not be parsed.
+	 * The tag is constructed by the calling thread if the job has not been started yet
+	 */
+	Tag* getTag();
+	void release();
+	//IThreadJob interface
+	void execute() override;
+	void jobFence() override;
+};
+
+/*
+ * Constructs dictionary tags that don't depend on other tags (shapes, morph shapes and sounds)
+ * concurrently in the ThreadPool, while the ParseThread continues decompressing and reading the file.
+ * All other tags are still constructed in order by the ParseThread, after all deferred tags have been
+ * added to the dictionary
+ */
+class ParseTagPipeline
+{
+private:
+	ParseThread* parsethread;
+	RootMovieClip* root;
+	std::deque<ParseTagJob*> pending;
+	static bool isDeferrable(unsigned int tagtype);
+	// tags that don't look up the dictionary, so they can be constructed while deferred tags are pending
+	static bool isIndependent(unsigned int tagtype);
+public:
+	ParseTagPipeline(ParseThread* p, RootMovieClip* r):parsethread(p),root(r){}
+	~ParseTagPipeline();
+	/*
+	 * Called by the TagFactory after the header of a tag has been read.
+	 * Returns true if the tag has been read and deferred
+	 */
+	bool processTag(const RECORDHEADER& h, std::istream& in);
+	// adds constructed tags to the dictionary, if all is true it waits for all pending tags
+	void collect(bool all);
+	bool isPending(int id) const;
+};
+
 class TagFactory
 {
 private:
 	std::istream& f;
 	bool firstTag;
+	ParseTagPipeline* pipeline;
+	bool reportProgress;
 public:
-	TagFactory(std::istream& in):f(in),firstTag(true){}
+	/**
+	 * @param p if set, some tags are constructed concurrently by the pipeline
+	 * @param _reportProgress if true, LoaderInfo.bytesLoaded is updated after every tag
+	 */
+	TagFactory(std::istream& in, ParseTagPipeline* p=nullptr, bool _reportProgress=true):f(in),firstTag(true),pipeline(p),reportProgress(_reportProgress){}
 	/**
 	 * The RootMovieClip that is the owner of the content.
 	 * It is needed to solve references to other tags during construction
@@ -0,0 +1,685 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#include "platforms/boxblur.h"
+#include <SDL.h>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOXBLUR_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BOXBLUR_NEON 1
+#include <arm_neon.h>
+#endif
+
+using namespace lightspark;
+
+// blur algorithm taken from haxe https://github.com/haxelime/lime/blob/develop/src/lime/_internal/graphics/StackBlur.hx
+static const uint32_t MUL_TABLE[BOXBLUR_MAXRADIUS+1] =
+{
+
+	1, 171, 205, 293, 57, 373, 79, 137, 241, 27, 391, 357, 41, 19, 283, 265, 497, 469, 443, 421, 25, 191, 365, 349, 335, 161, 155, 149, 9, 278, 269, 261,
+	505, 245, 475, 231, 449, 437, 213, 415, 405, 395, 193, 377, 369, 361, 353, 345, 169, 331, 325, 319, 313, 307, 301, 37, 145, 285, 281, 69, 271, 267,
+	263, 259, 509, 501, 493, 243, 479, 118, 465, 459, 113, 446, 55, 435, 429, 423, 209, 413, 51, 403, 199, 393, 97, 3, 379, 375, 371, 367, 363, 359, 355,
+	351, 347, 43, 85, 337, 333, 165, 327, 323, 5, 317, 157, 311, 77, 305, 303, 75, 297, 294, 73, 289, 287, 71, 141, 279, 277, 275, 68, 135, 67, 133, 33,
+	262, 260, 129, 511, 507, 503, 499, 495, 491, 61, 121, 481, 477, 237, 235, 467, 232, 115, 457, 227, 451, 7, 445, 221, 439, 218, 433, 215, 427, 425,
+	211, 419, 417, 207, 411, 409, 203, 202, 401, 399, 396, 197, 49, 389, 387, 385, 383, 95, 189, 47, 187, 93, 185, 23, 183, 91, 181, 45, 179, 89, 177, 11,
+	175, 87, 173, 345, 343, 341, 339, 337, 21, 167, 83, 331, 329, 327, 163, 81, 323, 321, 319, 159, 79, 315, 313, 39, 155, 309, 307, 153, 305, 303, 151,
+	75, 299, 149, 37, 295, 147, 73, 291, 145, 289, 287, 143, 285, 71, 141, 281, 35, 279, 139, 69, 275, 137, 273, 17, 271, 135, 269, 267, 133, 265, 33,
+	263, 131, 261, 130, 259, 129, 257, 1
+};
+static const uint32_t SHG_TABLE[BOXBLUR_MAXRADIUS+1] =
+{
+
+	0, 9, 10, 11, 9, 12, 10, 11, 12, 9, 13, 13, 10, 9, 13, 13, 14, 14, 14, 14, 10, 13, 14, 14, 14, 13, 13, 13, 9, 14, 14, 14, 15, 14, 15, 14, 15, 15, 14,
+	15, 15, 15, 14, 15, 15, 15, 15, 15, 14, 15, 15, 15, 15, 15, 15, 12, 14, 15, 15, 13, 15, 15, 15, 15, 16, 16, 16, 15, 16, 14, 16, 16, 14, 16, 13, 16,
+	16, 16, 15, 16, 13, 16, 15, 16, 14, 9, 16, 16, 16, 16, 16, 16, 16, 16, 16, 13, 14, 16, 16, 15, 16, 16, 10, 16, 15, 16, 14, 16, 16, 14, 16, 16, 14, 16,
+	16, 14, 15, 16, 16, 16, 14, 15, 14, 15, 13, 16, 16, 15, 17, 17, 17, 17, 17, 17, 14, 15, 17, 17, 16, 16, 17, 16, 15, 17, 16, 17, 11, 17, 16, 17, 16,
+	17, 16, 17, 17, 16, 17, 17, 16, 17, 17, 16, 16, 17, 17, 17, 16, 14, 17, 17, 17, 17, 15, 16, 14, 16, 15, 16, 13, 16, 15, 16, 14, 16, 15, 16, 12, 16,
+	15, 16, 17, 17, 17, 17, 17, 13, 16, 15, 17, 17, 17, 16, 15, 17, 17, 17, 16, 15, 17, 17, 14, 16, 17, 17, 16, 17, 17, 16, 15, 17, 16, 14, 17, 16, 15,
+	17, 16, 17, 17, 16, 17, 15, 16, 17, 14, 17, 16, 15, 17, 16, 17, 13, 17, 16, 17, 17, 16, 17, 14, 17, 16, 17, 16, 17, 16, 17, 9
+};
+
+/*
+ * Every pass blurs the pixels in place. The window of a pixel only contains pixels that are not yet written,
+ * so the result is the same as if the pass would read from a copy of the image.
+ * The ring buffer contains the window of the current pixel, it is initialized exactly like in the original
+ * stack blur implementation (for the horizontal pass this means that the first entry already contains
+ * the pixel at radius, not the first pixel), as the vectorized kernels have to be bit-exact.
+ */
+// lastpass is only used by the vertical passes, which clamp the color channels in the last iteration
+typedef void (*blurPassFunc)(uint8_t* data, int width, int height, int radius, bool lastpass, int32_t* ring);
+
+static void blurHorizontalScalar(uint8_t* data, int width, int height, int radius, bool /*lastpass*/, int32_t* ring)
+{
+	const uint32_t mul = MUL_TABLE[radius];
+	const uint32_t shift = SHG_TABLE[radius];
+	const int div = radius+radius+1;
+	const int w1 = width-1;
+	for (int y = 0; y < height; y++)
+	{
+		uint8_t* px = data+y*width*4;
+		int32_t sum[4];
+		for (int c = 0; c < 4; c++)
+		{
+			sum[c] = (radius+1)*px[c];
+			for (int i = 0; i <= radius+1; i++)
+				ring[i*4+c] = px[c];
+			for (int i = 1; i <= radius; i++)
+			{
+				int32_t v = px[(i < w1 ? i : w1)*4+c];
+				ring[((radius+1+i)%div)*4+c] = v;
+				sum[c] += v;
+			}
+		}
+		int si = 0;
+		for (int x = 0; x < width; x++)
+		{
+			for (int c = 0; c < 4; c++)
+				px[x*4+c] = (uint32_t(sum[c])*mul) >> shift;
+			int p = x+radius+1;
+			p = (p < w1 ? p : w1)*4;
+			for (int c = 0; c < 4; c++)
+			{
+				sum[c] -= ring[si*4+c];
+				ring[si*4+c] = px[p+c];
+				sum[c] += ring[si*4+c];
+			}
+			if (++si == div)
+				si = 0;
+		}
+	}
+}
+
+static void blurColumnScalar(uint8_t* data, int width, int height, int x, int radius, bool lastpass, int32_t* ring)
+{
+	const uint32_t mul = MUL_TABLE[radius];
+	const uint32_t shift = SHG_TABLE[radius];
+	const int div = radius+radius+1;
+	const int h1 = height-1;
+	const int stride = width*4;
+	uint8_t* col = data+x*4;
+	int32_t sum[4];
+	for (int c = 0; c < 4; c++)
+	{
+		sum[c] = (radius+1)*col[c];
+		for (int i = 0; i <= radius; i++)
+			ring[i*4+c] = col[c];
+		for (int i = 1; i <= radius; i++)
+		{
+			int32_t v = col[(i < h1 ? i : h1)*stride+c];
+			ring[(radius+i)*4+c] = v;
+			sum[c] += v;
+		}
+	}
+	int si = 0;
+	for (int y = 0; y < height; y++)
+	{
+		uint8_t* dst = col+y*stride;
+		uint32_t a = (uint32_t(sum[3])*mul) >> shift;
+		dst[3] = a;
+		for (int c = 0; c < 3; c++)
+		{
+			uint32_t v = a > 0 ? (uint32_t(sum[c])*mul) >> shift : 0;
+			dst[c] = lastpass && v > 255 ? 255 : v;
+		}
+		int p = y+radius+1;
+		const uint8_t* src = col+(p < h1 ? p : h1)*stride;
+		for (int c = 0; c < 4; c++)
+		{
+			sum[c] -= ring[si*4+c];
+			ring[si*4+c] = src[c];
+			sum[c] += ring[si*4+c];
+		}
+		if (++si == div)
+			si = 0;
+	}
+}
+
+static void blurVerticalScalar(uint8_t* data, int width, int height, int radius, bool lastpass, int32_t* ring)
+{
+	for (int x = 0; x < width; x++)
+		blurColumnScalar(data, width, height, x, radius, lastpass, ring);
+}
+
+#ifdef BOXBLUR_X86
+// all values are below 2^24, so the low 32 bits of the unsigned products are sufficient
+__attribute__((target("sse2")))
+static inline __m128i mulShiftSSE2(__m128i sum, __m128i mul, __m128i shift)
+{
+	__m128i even = _mm_mul_epu32(sum, mul);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(sum, 32), _mm_srli_epi64(mul, 32));
+	__m128i prod = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+	return _mm_srl_epi32(prod, shift);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i loadPixelSSE2(const uint8_t* p)
+{
+	int32_t v;
+	memcpy(&v, p, 4);
+	__m128i zero = _mm_setzero_si128();
+	return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+}
+
+// mask selects the bits that are kept before saturating to 8 bit, so 0xff truncates like the scalar code
+__attribute__((target("sse2")))
+static inline void storePixelSSE2(uint8_t* p, __m128i v, __m128i mask)
+{
+	v = _mm_and_si128(v, mask);
+	v = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+	int32_t r = _mm_cvtsi128_si32(v);
+	memcpy(p, &r, 4);
+}
+
+// keeps the color channels only if the alpha channel is not 0
+__attribute__((target("sse2")))
+static inline __m128i maskAlphaSSE2(__m128i v)
+{
+	return _mm_and_si128(v, _mm_cmpgt_epi32(_mm_shuffle_epi32(v, _MM_SHUFFLE(3,3,3,3)), _mm_setzero_si128()));
+}
+
+__attribute__((target("sse2")))
+static void blurRowSSE2(uint8_t* px, int width, int radius, __m128i* ring)
+{
+	const __m128i mul = _mm_set1_epi32(MUL_TABLE[radius]);
+	const __m128i shift = _mm_cvtsi32_si128(SHG_TABLE[radius]);
+	const __m128i truncate = _mm_set1_epi32(0xff);
+	const int div = radius+radius+1;
+	const int w1 = width-1;
+	__m128i first = loadPixelSSE2(px);
+	__m128i sum = _mm_setzero_si128();
+	for (int i = 0; i <= radius+1; i++)
+		ring[i] = first;
+	for (int i = 0; i <= radius; i++)
+		sum = _mm_add_epi32(sum, first);
+	for (int i = 1; i <= radius; i++)
+	{
+		__m128i v = loadPixelSSE2(px+(i < w1 ? i : w1)*4);
+		ring[(radius+1+i)%div] = v;
+		sum = _mm_add_epi32(sum, v);
+	}
+	int si = 0;
+	for (int x = 0; x < width; x++)
+	{
+		storePixelSSE2(px+x*4, mulShiftSSE2(sum, mul, shift), truncate);
+		int p = x+radius+1;
+		__m128i v = loadPixelSSE2(px+(p < w1 ? p : w1)*4);
+		sum = _mm_add_epi32(_mm_sub_epi32(sum, ring[si]), v);
+		ring[si] = v;
+		if (++si == div)
+			si = 0;
+	}
+}
+
+__attribute__((target("sse2")))
+static void blurHorizontalSSE2(uint8_t* data, int width, int height, int radius, bool /*lastpass*/, int32_t* ring)
+{
+	for (int y = 0; y < height; y++)
+		blurRowSSE2(data+y*width*4, width, radius, (__m128i*)ring);
+}
+
+// blurs 4 adjacent columns starting at x
+__attribute__((target("sse2")))
+static void blurColumns4SSE2(uint8_t* data, int width, int height, int x, int radius, bool lastpass, __m128i* ring)
+{
+	const __m128i mul = _mm_set1_epi32(MUL_TABLE[radius]);
+	const __m128i shift = _mm_cvtsi32_si128(SHG_TABLE[radius]);
+	// the color channels are clamped in the last pass, alpha is always truncated
+	const __m128i mask = lastpass ? _mm_set_epi32(0xff,-1,-1,-1) : _mm_set1_epi32(0xff);
+	const __m128i zero = _mm_setzero_si128();
+	const int div = radius+radius+1;
+	const int h1 = height-1;
+	const int stride = width*4;
+	uint8_t* col = data+x*4;
+	__m128i sum[4];
+	__m128i v[4];
+#define LOADPIXELS4_SSE2(p) \
+	{ \
+		__m128i raw = _mm_loadu_si128((const __m128i*)(p)); \
+		__m128i lo = _mm_unpacklo_epi8(raw, zero); \
+		__m128i hi = _mm_unpackhi_epi8(raw, zero); \
+		v[0] = _mm_unpacklo_epi16(lo, zero); \
+		v[1] = _mm_unpackhi_epi16(lo, zero); \
+		v[2] = _mm_unpacklo_epi16(hi, zero); \
+		v[3] = _mm_unpackhi_epi16(hi, zero); \
+	}
+	LOADPIXELS4_SSE2(col);
+	for (int j = 0; j < 4; j++)
+	{
+		sum[j] = zero;
+		for (int i = 0; i <= radius; i++)
+		{
+			ring[i*4+j] = v[j];
+			sum[j] = _mm_add_epi32(sum[j], v[j]);
+		}
+	}
+	for (int i = 1; i <= radius; i++)
+	{
+		LOADPIXELS4_SSE2(col+(i < h1 ? i : h1)*stride);
+		for (int j = 0; j < 4; j++)
+		{
+			ring[(radius+i)*4+j] = v[j];
+			sum[j] = _mm_add_epi32(sum[j], v[j]);
+		}
+	}
+	int si = 0;
+	for (int y = 0; y < height; y++)
+	{
+		__m128i r[4];
+		for (int j = 0; j < 4; j++)
+			r[j] = _mm_and_si128(maskAlphaSSE2(mulShiftSSE2(sum[j], mul, shift)), mask);
+		_mm_storeu_si128((__m128i*)(col+y*stride), _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]), _mm_packs_epi32(r[2], r[3])));
+		int p = y+radius+1;
+		LOADPIXELS4_SSE2(col+(p < h1 ? p : h1)*stride);
+		for (int j = 0; j < 4; j++)
+		{
+			sum[j] = _mm_add_epi32(_mm_sub_epi32(sum[j], ring[si*4+j]), v[j]);
+			ring[si*4+j] = v[j];
+		}
+		if (++si == div)
+			si = 0;
+	}
+#undef LOADPIXELS4_SSE2
+}
+
+__attribute__((target("sse2")))
+static void blurVerticalSSE2(uint8_t* data, int width, int height, int radius, bool lastpass, int32_t* ring)
+{
+	int x = 0;
+	for (; x+4 <= width; x += 4)
+		blurColumns4SSE2(data, width, height, x, radius, lastpass, (__m128i*)ring);
+	for (; x < width; x++)
+		blurColumnScalar(data, width, height, x, radius, lastpass, ring);
+}
+
+// loads the pixel at a into the low half and the pixel at b into the high half
+__attribute__((target("avx2")))
+static inline __m256i loadPixelPairAVX2(const uint8_t* a, const uint8_t* b)
+{
+	int32_t va;
+	int32_t vb;
+	memcpy(&va, a, 4);
+	memcpy(&vb, b, 4);
+	return _mm256_cvtepu8_epi32(_mm_unpacklo_epi32(_mm_cvtsi32_si128(va), _mm_cvtsi32_si128(vb)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i mulShiftAVX2(__m256i sum, __m256i mul, __m128i shift)
+{
+	return _mm256_srl_epi32(_mm256_mullo_epi32(sum, mul), shift);
+}
+
+// blurs the rows y and y+1 at once, one row in each 128 bit lane
+__attribute__((target("avx2")))
+static void blurRowPairAVX2(uint8_t* pxa, uint8_t* pxb, int width, int radius, __m256i* ring)
+{
+	const __m256i mul = _mm256_set1_epi32(MUL_TABLE[radius]);
+	const __m128i shift = _mm_cvtsi32_si128(SHG_TABLE[radius]);
+	const __m256i truncate = _mm256_set1_epi32(0xff);
+	const int div = radius+radius+1;
+	const int w1 = width-1;
+	__m256i first = loadPixelPairAVX2(pxa, pxb);
+	__m256i sum = _mm256_setzero_si256();
+	for (int i = 0; i <= radius+1; i++)
+		ring[i] = first;
+	for (int i = 0; i <= radius; i++)
+		sum = _mm256_add_epi32(sum, first);
+	for (int i = 1; i <= radius; i++)
+	{
+		int p = (i < w1 ? i : w1)*4;
+		__m256i v = loadPixelPairAVX2(pxa+p, pxb+p);
+		ring[(radius+1+i)%div] = v;
+		sum = _mm256_add_epi32(sum, v);
+	}
+	int si = 0;
+	for (int x = 0; x < width; x++)
+	{
+		__m256i r = _mm256_and_si256(mulShiftAVX2(sum, mul, shift), truncate);
+		r = _mm256_packus_epi16(_mm256_packs_epi32(r, r), r);
+		int32_t ra = _mm_cvtsi128_si32(_mm256_castsi256_si128(r));
+		int32_t rb = _mm_cvtsi128_si32(_mm256_extracti128_si256(r, 1));
+		memcpy(pxa+x*4, &ra, 4);
+		memcpy(pxb+x*4, &rb, 4);
+		int p = x+radius+1;
+		p = (p < w1 ? p : w1)*4;
+		__m256i v = loadPixelPairAVX2(pxa+p, pxb+p);
+		sum = _mm256_add_epi32(_mm256_sub_epi32(sum, ring[si]), v);
+		ring[si] = v;
+		if (++si == div)
+			si = 0;
+	}
+}
+
+__attribute__((target("avx2")))
+static void blurHorizontalAVX2(uint8_t* data, int width, int height, int radius, bool /*lastpass*/, int32_t* ring)
+{
+	int y = 0;
+	for (; y+2 <= height; y += 2)
+		blurRowPairAVX2(data+y*width*4, data+(y+1)*width*4, width, radius, (__m256i*)ring);
+	if (y < height)
+		blurRowSSE2(data+y*width*4, width, radius, (__m128i*)ring);
+}
+
+// blurs 8 adjacent columns starting at x, every register contains two neighbouring pixels
+__attribute__((target("avx2")))
+static void blurColumns8AVX2(uint8_t* data, int width, int height, int x, int radius, bool lastpass, __m256i* ring)
+{
+	const __m256i mul = _mm256_set1_epi32(MUL_TABLE[radius]);
+	const __m128i shift = _mm_cvtsi32_si128(SHG_TABLE[radius]);
+	// the color channels are clamped in the last pass, alpha is always truncated
+	const __m256i mask = lastpass ? _mm256_setr_epi32(-1,-1,-1,0xff,-1,-1,-1,0xff) : _mm256_set1_epi32(0xff);
+	const __m256i zero = _mm256_setzero_si256();
+	// restores the pixel order after packing
+	const __m256i order = _mm256_setr_epi32(0,4,1,5,2,6,3,7);
+	const int div = radius+radius+1;
+	const int h1 = height-1;
+	const int stride = width*4;
+	uint8_t* col = data+x*4;
+	__m256i sum[4];
+	__m256i v[4];
+#define LOADPIXELS8_AVX2(p) \
+	for (int j = 0; j < 4; j++) \
+		v[j] = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)((p)+j*8)));
+	LOADPIXELS8_AVX2(col);
+	for (int j = 0; j < 4; j++)
+	{
+		sum[j] = zero;
+		for (int i = 0; i <= radius; i++)
+		{
+			ring[i*4+j] = v[j];
+			sum[j] = _mm256_add_epi32(sum[j], v[j]);
+		}
+	}
+	for (int i = 1; i <= radius; i++)
+	{
+		LOADPIXELS8_AVX2(col+(i < h1 ? i : h1)*stride);
+		for (int j = 0; j < 4; j++)
+		{
+			ring[(radius+i)*4+j] = v[j];
+			sum[j] = _mm256_add_epi32(sum[j], v[j]);
+		}
+	}
+	int si = 0;
+	for (int y = 0; y < height; y++)
+	{
+		__m256i r[4];
+		for (int j = 0; j < 4; j++)
+		{
+			r[j] = mulShiftAVX2(sum[j], mul, shift);
+			r[j] = _mm256_and_si256(r[j], _mm256_cmpgt_epi32(_mm256_shuffle_epi32(r[j], _MM_SHUFFLE(3,3,3,3)), zero));
+			r[j] = _mm256_and_si256(r[j], mask);
+		}
+		__m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(r[0], r[1]), _mm256_packs_epi32(r[2], r[3]));
+		_mm256_storeu_si256((__m256i*)(col+y*stride), _mm256_permutevar8x32_epi32(packed, order));
+		int p = y+radius+1;
+		LOADPIXELS8_AVX2(col+(p < h1 ? p : h1)*stride);
+		for (int j = 0; j < 4; j++)
+		{
+			sum[j] = _mm256_add_epi32(_mm256_sub_epi32(sum[j], ring[si*4+j]), v[j]);
+			ring[si*4+j] = v[j];
+		}
+		if (++si == div)
+			si = 0;
+	}
+#undef LOADPIXELS8_AVX2
+}
+
+__attribute__((target("avx2")))
+static void blurVerticalAVX2(uint8_t* data, int width, int height, int radius, bool lastpass, int32_t* ring)
+{
+	int x = 0;
+	for (; x+8 <= width; x += 8)
+		blurColumns8AVX2(data, width, height, x, radius, lastpass, (__m256i*)ring);
+	for (; x+4 <= width; x += 4)
+		blurColumns4SSE2(data, width, height, x, radius, lastpass, (__m128i*)ring);
+	for (; x < width; x++)
+		blurColumnScalar(data, width, height, x, radius, lastpass, ring);
+}
+#endif
+
+#ifdef BOXBLUR_NEON
+static inline uint32x4_t loadPixelNEON(const uint8_t* p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(v)))));
+}
+
+static inline uint32x4_t mulShiftNEON(uint32x4_t sum, uint32x4_t mul, int32x4_t shift)
+{
+	return vshlq_u32(vmulq_u32(sum, mul), shift);
+}
+
+// keeps the color channels only if the alpha channel is not 0
+static inline uint32x4_t maskAlphaNEON(uint32x4_t v)
+{
+	return vandq_u32(v, vcgtq_u32(vdupq_n_u32(vgetq_lane_u32(v, 3)), vdupq_n_u32(0)));
+}
+
+static void blurHorizontalNEON(uint8_t* data, int width, int height, int radius, bool /*lastpass*/, int32_t* ringbuf)
+{
+	const uint32x4_t mul = vdupq_n_u32(MUL_TABLE[radius]);
+	const int32x4_t shift = vdupq_n_s32(-int32_t(SHG_TABLE[radius]));
+	const int div = radius+radius+1;
+	const int w1 = width-1;
+	uint32x4_t* ring = (uint32x4_t*)ringbuf;
+	for (int y = 0; y < height; y++)
+	{
+		uint8_t* px = data+y*width*4;
+		uint32x4_t first = loadPixelNEON(px);
+		uint32x4_t sum = vmulq_n_u32(first, radius+1);
+		for (int i = 0; i <= radius+1; i++)
+			ring[i] = first;
+		for (int i = 1; i <= radius; i++)
+		{
+			uint32x4_t v = loadPixelNEON(px+(i < w1 ? i : w1)*4);
+			ring[(radius+1+i)%div] = v;
+			sum = vaddq_u32(sum, v);
+		}
+		int si = 0;
+		for (int x = 0; x < width; x++)
+		{
+			// vmovn keeps the low bits, like the truncation in the scalar code
+			uint8x8_t r = vmovn_u16(vcombine_u16(vmovn_u32(mulShiftNEON(sum, mul, shift)), vdup_n_u16(0)));
+			uint32_t out = vget_lane_u32(vreinterpret_u32_u8(r), 0);
+			memcpy(px+x*4, &out, 4);
+			int p = x+radius+1;
+			uint32x4_t v = loadPixelNEON(px+(p < w1 ? p : w1)*4);
+			sum = vaddq_u32(vsubq_u32(sum, ring[si]), v);
+			ring[si] = v;
+			if (++si == div)
+				si = 0;
+		}
+	}
+}
+
+static void blurVerticalNEON(uint8_t* data, int width, int height, int radius, bool lastpass, int32_t* ringbuf)
+{
+	const uint32x4_t mul = vdupq_n_u32(MUL_TABLE[radius]);
+	const int32x4_t shift = vdupq_n_s32(-int32_t(SHG_TABLE[radius]));
+	// the color channels are clamped in the last pass, alpha is always truncated
+	const uint32_t maskvalues[4] = { lastpass ? 0xffffffffU : 0xffU, lastpass ? 0xffffffffU : 0xffU, lastpass ? 0xffffffffU : 0xffU, 0xffU };
+	const uint32x4_t mask = vld1q_u32(maskvalues);
+	const int div = radius+radius+1;
+	const int h1 = height-1;
+	const int stride = width*4;
+	uint32x4_t* ring = (uint32x4_t*)ringbuf;
+	int x = 0;
+	for (; x+4 <= width; x += 4)
+	{
+		uint8_t* col = data+x*4;
+		uint32x4_t sum[4];
+		uint32x4_t v[4];
+#define LOADPIXELS4_NEON(p) \
+		{ \
+			uint8x16_t raw = vld1q_u8(p); \
+			uint16x8_t lo = vmovl_u8(vget_low_u8(raw)); \
+			uint16x8_t hi = vmovl_u8(vget_high_u8(raw)); \
+			v[0] = vmovl_u16(vget_low_u16(lo)); \
+			v[1] = vmovl_u16(vget_high_u16(lo)); \
+			v[2] = vmovl_u16(vget_low_u16(hi)); \
+			v[3] = vmovl_u16(vget_high_u16(hi)); \
+		}
+		LOADPIXELS4_NEON(col);
+		for (int j = 0; j < 4; j++)
+		{
+			sum[j] = vmulq_n_u32(v[j], radius+1);
+			for (int i = 0; i <= radius; i++)
+				ring[i*4+j] = v[j];
+		}
+		for (int i = 1; i <= radius; i++)
+		{
+			LOADPIXELS4_NEON(col+(i < h1 ? i : h1)*stride);
+			for (int j = 0; j < 4; j++)
+			{
+				ring[(radius+i)*4+j] = v[j];
+				sum[j] = vaddq_u32(sum[j], v[j]);
+			}
+		}
+		int si = 0;
+		for (int y = 0; y < height; y++)
+		{
+			uint16x4_t r[4];
+			for (int j = 0; j < 4; j++)
+				r[j] = vqmovn_u32(vandq_u32(maskAlphaNEON(mulShiftNEON(sum[j], mul, shift)), mask));
+			vst1q_u8(col+y*stride, vcombine_u8(vqmovn_u16(vcombine_u16(r[0], r[1])), vqmovn_u16(vcombine_u16(r[2], r[3]))));
+			int p = y+radius+1;
+			LOADPIXELS4_NEON(col+(p < h1 ? p : h1)*stride);
+			for (int j = 0; j < 4; j++)
+			{
+				sum[j] = vaddq_u32(vsubq_u32(sum[j], ring[si*4+j]), v[j]);
+				ring[si*4+j] = v[j];
+			}
+			if (++si == div)
+				si = 0;
+		}
+#undef LOADPIXELS4_NEON
+	}
+	for (; x < width; x++)
+		blurColumnScalar(data, width, height, x, radius, lastpass, ringbuf);
+}
+#endif
+
+bool lightspark::boxBlurKernelSupported(BOXBLUR_KERNEL kernel)
+{
+	switch (kernel)
+	{
+		case BOXBLUR_KERNEL::AUTO:
+		case BOXBLUR_KERNEL::SCALAR:
+			return true;
+#ifdef BOXBLUR_X86
+		case BOXBLUR_KERNEL::SSE2:
+			return SDL_HasSSE2();
+		case BOXBLUR_KERNEL::AVX2:
+			return SDL_HasAVX2();
+#endif
+#ifdef BOXBLUR_NEON
+		case BOXBLUR_KERNEL::NEON:
+#ifdef __aarch64__
+			return true;
+#else
+			return SDL_HasNEON();
+#endif
+#endif
+		default:
+			return false;
+	}
+}
+
+const char* lightspark::boxBlurKernelName(BOXBLUR_KERNEL kernel)
+{
+	switch (kernel)
+	{
+		case BOXBLUR_KERNEL::AUTO:
+			return "auto";
+		case BOXBLUR_KERNEL::SCALAR:
+			return "scalar";
+		case BOXBLUR_KERNEL::SSE2:
+			return "sse2";
+		case BOXBLUR_KERNEL::AVX2:
+			return "avx2";
+		case BOXBLUR_KERNEL::NEON:
+			return "neon";
+	}
+	return "unknown";
+}
+
+static BOXBLUR_KERNEL selectBestKernel()
+{
+	if (boxBlurKernelSupported(BOXBLUR_KERNEL::AVX2))
+		return BOXBLUR_KERNEL::AVX2;
+	if (boxBlurKernelSupported(BOXBLUR_KERNEL::SSE2))
+		return BOXBLUR_KERNEL::SSE2;
+	if (boxBlurKernelSupported(BOXBLUR_KERNEL::NEON))
+		return BOXBLUR_KERNEL::NEON;
+	return BOXBLUR_KERNEL::SCALAR;
+}
+
+void lightspark::boxBlur(uint8_t* data, uint32_t width, uint32_t height, int radiusX, int radiusY, int iterations, BOXBLUR_KERNEL kernel)
+{
+	if (width == 0 || height == 0 || radiusX <= 0 || radiusY <= 0)
+		return;
+	if (radiusX > BOXBLUR_MAXRADIUS)
+		radiusX = BOXBLUR_MAXRADIUS;
+	if (radiusY > BOXBLUR_MAXRADIUS)
+		radiusY = BOXBLUR_MAXRADIUS;
+	if (kernel == BOXBLUR_KERNEL::AUTO)
+	{
+		// cpu features don't change, so the kernel is only selected once
+		static const BOXBLUR_KERNEL best = selectBestKernel();
+		kernel = best;
+	}
+	blurPassFunc horizontal = blurHorizontalScalar;
+	blurPassFunc vertical = blurVerticalScalar;
+	switch (kernel)
+	{
+#ifdef BOXBLUR_X86
+		case BOXBLUR_KERNEL::SSE2:
+			horizontal = blurHorizontalSSE2;
+			vertical = blurVerticalSSE2;
+			break;
+		case BOXBLUR_KERNEL::AVX2:
+			horizontal = blurHorizontalAVX2;
+			vertical = blurVerticalAVX2;
+			break;
+#endif
+#ifdef BOXBLUR_NEON
+		case BOXBLUR_KERNEL::NEON:
+			horizontal = blurHorizontalNEON;
+			vertical = blurVerticalNEON;
+			break;
+#endif
+		default:
+			break;
+	}
+	// the ring buffer has to hold the window for up to 8 pixels of 4 channels, aligned for 256 bit vectors
+	int div = 2*(radiusX > radiusY ? radiusX : radiusY)+2;
+	std::vector<int32_t> ringstorage(div*32+8);
+	int32_t* ring = (int32_t*)((uintptr_t(ringstorage.data())+31) & ~uintptr_t(31));
+	while (iterations > 0)
+	{
+		iterations--;
+		horizontal(data, width, height, radiusX, false, ring);
+		vertical(data, width, height, radiusY, iterations == 0, ring);
+	}
+}
@@ -0,0 +1,53 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+#ifndef PLATFORMS_BOXBLUR_H
+#define PLATFORMS_BOXBLUR_H 1
+
+#include <cstdint>
+
+namespace lightspark
+{
+
+enum class BOXBLUR_KERNEL { AUTO=0, SCALAR, SSE2, AVX2, NEON };
+
+// largest radius supported by boxBlur
+#define BOXBLUR_MAXRADIUS 256
+
+/**
+	Returns true if the kernel can be used on the current cpu.
+	AUTO and SCALAR are always supported.
+*/
+bool boxBlurKernelSupported(BOXBLUR_KERNEL kernel);
+const char* boxBlurKernelName(BOXBLUR_KERNEL kernel);
+
+/**
+	In-place box blur of BGRA pixels as used by BitmapFilter::applyBlur.
+	Every iteration is a horizontal pass followed by a vertical pass, the last vertical pass clamps the color channels.
+	The division by the window size is approximated with the multiply/shift tables of the stack blur algorithm.
+	All kernels produce identical results, AUTO selects the fastest kernel supported by the cpu.
+
+	@param data Pixels, width*height*4 bytes without padding
+	@param radiusX Horizontal radius, larger radii are clamped to BOXBLUR_MAXRADIUS, nothing is done if it is less than 1
+	@param radiusY Vertical radius, larger radii are clamped to BOXBLUR_MAXRADIUS, nothing is done if it is less than 1
+*/
+void boxBlur(uint8_t* data, uint32_t width, uint32_t height, int radiusX, int radiusY, int iterations, BOXBLUR_KERNEL kernel=BOXBLUR_KERNEL::AUTO);
+
+};
+#endif /* PLATFORMS_BOXBLUR_H */
@@ -0,0 +1,105 @@
+/**************************************************************************
+    Lightspark, a free flash player implementation
+
+    Copyright (C) 2009-2013  Alessandro Pignotti (a.pignotti@sssup.it)
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+**************************************************************************/
+
+/*
+ * Micro benchmark for the box blur kernels used by BitmapFilter::applyBlur.
+ * Every kernel supported by the cpu blurs the same random image and is compared against the scalar kernel.
+ * usage: boxblur-benchmark [width height radius iterations repetitions]
+ */
+
+#include "platforms/boxblur.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace lightspark;
+
+int main(int argc, char* argv[])
+{
+	uint32_t width = 1024;
+	uint32_t height = 768;
+	int radius = 8;
+	int iterations = 3;
+	int repetitions = 50;
+	if (argc == 6)
+	{
+		width = atoi(argv[1]);
+		height = atoi(argv[2]);
+		radius = atoi(argv[3]);
+		iterations = atoi(argv[4]);
+		repetitions = atoi(argv[5]);
+	}
+	else if (argc != 1)
+	{
+		fprintf(stderr, "usage: %s [width height radius iterations repetitions]\n", argv[0]);
+		return 1;
+	}
+	if (width == 0 || height == 0 || radius <= 0 || radius > BOXBLUR_MAXRADIUS || iterations <= 0 || repetitions <= 0)
+	{
+		fprintf(stderr, "invalid arguments\n");
+		return 1;
+	}
+
+	// random premultiplied pixels
+	std::vector<uint8_t> source(width*height*4);
+	srand(42);
+	for (uint32_t i = 0; i < width*height; i++)
+	{
+		uint8_t alpha = rand()%256;
+		source[i*4+3] = alpha;
+		for (uint32_t c = 0; c < 3; c++)
+			source[i*4+c] = rand()%(alpha+1);
+	}
+
+	std::vector<uint8_t> reference = source;
+	boxBlur(reference.data(), width, height, radius, radius, iterations, BOXBLUR_KERNEL::SCALAR);
+
+	printf("%ux%u pixels, radius %d, %d iterations, %d repetitions\n", width, height, radius, iterations, repetitions);
+	double scalartime = 0;
+	bool identical = true;
+	for (BOXBLUR_KERNEL kernel : { BOXBLUR_KERNEL::SCALAR, BOXBLUR_KERNEL::SSE2, BOXBLUR_KERNEL::AVX2, BOXBLUR_KERNEL::NEON, BOXBLUR_KERNEL::AUTO })
+	{
+		if (!boxBlurKernelSupported(kernel))
+		{
+			printf("%-8s not supported\n", boxBlurKernelName(kernel));
+			continue;
+		}
+		std::vector<uint8_t> data = source;
+		boxBlur(data.data(), width, height, radius, radius, iterations, kernel);
+		bool same = data == reference;
+		identical &= same;
+
+		double best = 0;
+		for (int i = 0; i < repetitions; i++)
+		{
+			memcpy(data.data(), source.data(), source.size());
+			auto start = std::chrono::steady_clock::now();
+			boxBlur(data.data(), width, height, radius, radius, iterations, kernel);
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+			if (i == 0 || ms < best)
+				best = ms;
+		}
+		if (kernel == BOXBLUR_KERNEL::SCALAR)
+			scalartime = best;
+		printf("%-8s %8.3f ms %6.2fx %s\n", boxBlurKernelName(kernel), best, scalartime/best, same ? "identical" : "MISMATCH");
+	}
+	return identical ? 0 : 1;
+}
@@ -80,7 +80,7 @@ bool lightspark::isEventLoopThread()
 
 EngineData::EngineData() : contextmenu(nullptr),contextmenurenderer(nullptr),sdleventtickjob(nullptr),incontextmenu(false),incontextmenupreparing(false),widget(nullptr),
 	nvgcontext(nullptr),
-	width(0), height(0),needrenderthread(true),supportPackedDepthStencil(false),hasExternalFontRenderer(false),
+	width(0), height(0),needrenderthread(true),supportPackedDepthStencil(false),supportPixelBufferObjects(false),supportPersistentMapping(false),hasExternalFontRenderer(false),
 	startInFullScreenMode(false),startscalefactor(1.0)
 {
 #ifdef _WIN32
@@ -494,6 +494,10 @@ void EngineData::initGLEW()
 		throw RunTimeException("Rendering: OpenGL driver does not support framebuffer objects");
 	}
 	supportPackedDepthStencil = GLEW_EXT_packed_depth_stencil;
+	supportPixelBufferObjects = (GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object) && GLEW_ARB_map_buffer_range && GLEW_ARB_sync;
+#ifdef GL_ARB_buffer_storage
+	supportPersistentMapping = supportPixelBufferObjects && GLEW_ARB_buffer_storage;
+#endif
 #endif
 	initNanoVG();
 }
@@ -1610,6 +1614,70 @@ void EngineData::exec_glBufferData_GL_ARRAY_BUFFER_GL_DYNAMIC_DRAW(int32_t size,
 {
 	glBufferData(GL_ARRAY_BUFFER,size, data,GL_DYNAMIC_DRAW);
 }
+void EngineData::exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(uint32_t buffer)
+{
+#ifndef ENABLE_GLES2
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER,buffer);
+#endif
+}
+void EngineData::exec_glBufferData_GL_PIXEL_UNPACK_BUFFER_GL_STREAM_DRAW(int32_t size,const void* data)
+{
+#ifndef ENABLE_GLES2
+	glBufferData(GL_PIXEL_UNPACK_BUFFER,size, data,GL_STREAM_DRAW);
+#endif
+}
+void EngineData::exec_glBufferStorage_GL_PIXEL_UNPACK_BUFFER_GL_MAP_PERSISTENT_BIT(int32_t size)
+{
+#if !defined(ENABLE_GLES2) && defined(GL_ARB_buffer_storage)
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER,size,nullptr,GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT);
+#endif
+}
+uint8_t* EngineData::exec_glMapBufferRange_GL_PIXEL_UNPACK_BUFFER(int32_t offset, int32_t length, bool persistent)
+{
+#ifndef ENABLE_GLES2
+#ifdef GL_ARB_buffer_storage
+	if (persistent)
+		return (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,offset,length,GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT);
+#endif
+	// the caller ensures with fences that the range is not used by the gpu anymore
+	return (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,offset,length,GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT|GL_MAP_UNSYNCHRONIZED_BIT);
+#else
+	return nullptr;
+#endif
+}
+void EngineData::exec_glUnmapBuffer_GL_PIXEL_UNPACK_BUFFER()
+{
+#ifndef ENABLE_GLES2
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+#endif
+}
+void* EngineData::exec_glFenceSync()
+{
+#ifndef ENABLE_GLES2
+	return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE,0);
+#else
+	return nullptr;
+#endif
+}
+void EngineData::exec_glClientWaitSync(void* sync)
+{
+#ifndef ENABLE_GLES2
+	GLenum res;
+	do
+	{
+		res = glClientWaitSync((GLsync)sync,GL_SYNC_FLUSH_COMMANDS_BIT,1000000000);
+	}
+	while (res == GL_TIMEOUT_EXPIRED);
+	if (res == GL_WAIT_FAILED)
+		LOG(LOG_ERROR,"glClientWaitSync failed");
+#endif
+}
+void EngineData::exec_glDeleteSync(void* sync)
+{
+#ifndef ENABLE_GLES2
+	glDeleteSync((GLsync)sync);
+#endif
+}
 
 void EngineData::exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_LINEAR()
 {
@@ -121,6 +121,10 @@ public:
 	uint32_t origheight;
 	bool needrenderthread;
 	bool supportPackedDepthStencil;
+	// pixel unpack buffers with map_buffer_range and sync objects are available for streaming texture uploads
+	bool supportPixelBufferObjects;
+	// pixel unpack buffers can be mapped persistently (ARB_buffer_storage)
+	bool supportPersistentMapping;
 	bool hasExternalFontRenderer;
 	bool startInFullScreenMode;
 	double startscalefactor;
@@ -308,6 +312,14 @@ public:
 	virtual void exec_glBufferData_GL_ELEMENT_ARRAY_BUFFER_GL_DYNAMIC_DRAW(int32_t size, const void* data);
 	virtual void exec_glBufferData_GL_ARRAY_BUFFER_GL_STATIC_DRAW(int32_t size, const void* data);
 	virtual void exec_glBufferData_GL_ARRAY_BUFFER_GL_DYNAMIC_DRAW(int32_t size, const void* data);
+	virtual void exec_glBindBuffer_GL_PIXEL_UNPACK_BUFFER(uint32_t buffer);
+	virtual void exec_glBufferData_GL_PIXEL_UNPACK_BUFFER_GL_STREAM_DRAW(int32_t size, const void* data);
+	virtual void exec_glBufferStorage_GL_PIXEL_UNPACK_BUFFER_GL_MAP_PERSISTENT_BIT(int32_t size);
+	virtual uint8_t* exec_glMapBufferRange_GL_PIXEL_UNPACK_BUFFER(int32_t offset, int32_t length, bool persistent);
+	virtual void exec_glUnmapBuffer_GL_PIXEL_UNPACK_BUFFER();
+	virtual void* exec_glFenceSync();
+	virtual void exec_glClientWaitSync(void* sync);
+	virtual void exec_glDeleteSync(void* sync);
 	virtual void exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_LINEAR();
 	virtual void exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MAG_FILTER_GL_LINEAR();
 	virtual void exec_glTexParameteri_GL_TEXTURE_2D_GL_TEXTURE_MIN_FILTER_GL_NEAREST();
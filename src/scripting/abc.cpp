@@ -73,13 +73,16 @@
 #include "logger.h"
 #include "swftypes.h"
 #include <sstream>
+#include <fstream>
 #include <limits>
 #include <cmath>
+#include <zlib.h>
 #include "swf.h"
 #include "scripting/class.h"
 #include "exceptions.h"
 #include "scripting/abc.h"
 #include "backends/rendering.h"
+#include "backends/headlessrendering.h"
 #include "parsing/tags.h"
 #include "scripting/toplevel/Array.h"
 #include "scripting/toplevel/ASQName.h"
@@ -715,6 +718,8 @@ ABCContext::ABCContext(ApplicationDomain* appDomain,SecurityDomain* secDomain, i
 	}
 
 	hasRunScriptInit.resize(scripts.size(),false);
+	if (!applicationDomain->getSystemState()->abcProfileDirectory.empty())
+		loadMethodProfile(applicationDomain->getSystemState()->abcProfileDirectory);
 #ifdef PROFILING_SUPPORT
 	root->getSystemState()->contextes.push_back(this);
 #endif
@@ -722,8 +727,112 @@ ABCContext::ABCContext(ApplicationDomain* appDomain,SecurityDomain* secDomain, i
 
 ABCContext::~ABCContext()
 {
+	if (!methodProfileFile.empty())
+		saveMethodProfile();
+	logInlineCacheStatistics();
 }
 
+void ABCContext::logInlineCacheStatistics() const
+{
+	uint64_t hits=0;
+	uint64_t misses=0;
+	uint32_t sites=0;
+	uint32_t polymorphicsites=0;
+	for(unsigned int i=0;i<method_body_count;i++)
+	{
+		uint64_t methodhits=0;
+		uint64_t methodmisses=0;
+		for (auto it = method_body[i].inlinecaches.cbegin(); it != method_body[i].inlinecaches.cend(); it++)
+		{
+			if (*it == nullptr)
+				continue;
+			sites++;
+			if ((*it)->count > 1)
+				polymorphicsites++;
+			methodhits += (*it)->hits;
+			methodmisses += (*it)->misses;
+		}
+		if (methodhits || methodmisses)
+			LOG(LOG_TRACE,"inline caches of method body "<<i<<": "<<methodhits<<" hits, "<<methodmisses<<" misses");
+		hits += methodhits;
+		misses += methodmisses;
+	}
+	if (sites)
+		LOG(LOG_INFO,"inline caches: "<<sites<<" sites ("<<polymorphicsites<<" polymorphic), "<<hits<<" hits, "<<misses<<" misses");
+}
+
+/*
+ * The method profile is a profile-guided warm-up: it stores the hit counts of all method bodies of the context
+ * from the previous runs. Methods that were hot are preloaded on their first call instead of running through the
+ * fast interpreter first, so the profile only has an effect with the fast interpreter. The preloaded code itself
+ * is not stored, so preloading still happens on every launch.
+ * The file is identified by the SHA-256 hash of the code of all method bodies, every entry is validated against
+ * the length and checksum of the method code.
+ */
+#define METHOD_PROFILE_MAGIC 0x5046504c // "LPFP"
+#define METHOD_PROFILE_VERSION 1
+void ABCContext::loadMethodProfile(const tiny_string& profiledirectory)
+{
+	GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	for(unsigned int i=0;i<method_body_count;i++)
+		g_checksum_update(checksum,(const guchar*)method_body[i].code.data(),method_body[i].code.size());
+	methodProfileFile = profiledirectory.raw_buf();
+	methodProfileFile += G_DIR_SEPARATOR_S;
+	methodProfileFile += "abcprofile-";
+	methodProfileFile += g_checksum_get_string(checksum);
+	methodProfileFile += "-"+std::to_string(method_body_count)+".bin";
+	g_checksum_free(checksum);
+
+	std::ifstream f(methodProfileFile,std::ios::binary);
+	if (!f.is_open())
+		return;
+	uint32_t header[3];
+	f.read((char*)header,sizeof(header));
+	if (!f || header[0] != METHOD_PROFILE_MAGIC || header[1] != METHOD_PROFILE_VERSION || header[2] != method_body_count)
+	{
+		LOG(LOG_INFO,"ignoring invalid method profile "<<methodProfileFile);
+		return;
+	}
+	uint32_t hotmethods=0;
+	for(unsigned int i=0;i<method_body_count;i++)
+	{
+		uint32_t entry[3]; // code length, code checksum, hit count
+		f.read((char*)entry,sizeof(entry));
+		if (!f)
+		{
+			LOG(LOG_INFO,"method profile truncated "<<methodProfileFile);
+			break;
+		}
+		method_body_info& body = method_body[i];
+		if (entry[0] != body.code.size() || entry[1] != crc32(crc32(0L, Z_NULL, 0),(const Bytef*)body.code.data(),body.code.size()))
+			continue;
+		body.hit_count = min(entry[2],(uint32_t)UINT16_MAX);
+		if (body.hit_count >= applicationDomain->getSystemState()->tierUpThreshold)
+			hotmethods++;
+	}
+	LOG(LOG_INFO,"loaded method profile "<<methodProfileFile<<", hot methods:"<<hotmethods);
+}
+
+void ABCContext::saveMethodProfile()
+{
+	std::ofstream f(methodProfileFile,std::ios::binary|std::ios::trunc);
+	if (!f.is_open())
+	{
+		LOG(LOG_ERROR,"could not write method profile "<<methodProfileFile);
+		return;
+	}
+	uint32_t header[3] = { METHOD_PROFILE_MAGIC, METHOD_PROFILE_VERSION, method_body_count };
+	f.write((const char*)header,sizeof(header));
+	for(unsigned int i=0;i<method_body_count;i++)
+	{
+		const method_body_info& body = method_body[i];
+		uint32_t entry[3] = { (uint32_t)body.code.size(), (uint32_t)crc32(crc32(0L, Z_NULL, 0),(const Bytef*)body.code.data(),body.code.size()), body.hit_count };
+		f.write((const char*)entry,sizeof(entry));
+	}
+}
+#undef METHOD_PROFILE_MAGIC
+#undef METHOD_PROFILE_VERSION
+
 #ifdef PROFILING_SUPPORT
 void ABCContext::dumpProfilingData(ostream& f) const
 {
@@ -1235,6 +1344,12 @@ void ABCVm::handleEvent(std::pair<_NR<EventDispatcher>, _R<Event> > e)
 			}
 			case RENDER_FRAME:
 				m_sys->swapAsyncDrawJobQueue();
+				if (m_sys->getHeadlessRenderer())
+				{
+					// make sure all changes of this frame are contained in the rendered frame
+					m_sys->flushInvalidationQueue();
+					m_sys->getHeadlessRenderer()->renderFrame();
+				}
 				break;
 			case ADVANCE_FRAME:
 			{
@@ -1648,6 +1763,17 @@ void call_context::handleError(int errorcode)
 	createError<ASError>(getWorker(),errorcode);
 }
 
+void call_context::resolveDomainMemory()
+{
+	ApplicationDomain* domain = mi->context->applicationDomain;
+	SystemState* s = domain->getSystemState();
+	// the generation is read before the buffer, so a change in between is seen on the next access
+	domainMemoryGenerationSource = &s->domainMemoryGeneration;
+	domainMemoryGeneration = ACQUIRE_READ(s->domainMemoryGeneration);
+	domainMemory.base = domain->currentDomainMemory->getBufferNoCheck();
+	domainMemory.length = domain->currentDomainMemory->getLength();
+}
+
 bool ABCContext::isinstance(ASObject* obj, multiname* name)
 {
 	LOG(LOG_CALLS, "isinstance " << *name);
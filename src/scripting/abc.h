@@ -211,6 +211,12 @@ friend class ABCVm;
 friend class method_info;
 private:
 	bool scriptsdeclared;
+	// file in the ABC profile directory containing the method hit counts of this context
+	std::string methodProfileFile;
+	void loadMethodProfile(const tiny_string& profiledirectory);
+	void saveMethodProfile();
+	// logs the hit/miss counters of the property inline caches
+	void logInlineCacheStatistics() const;
 public:
 	ApplicationDomain* applicationDomain;
 	SecurityDomain* securityDomain;
@@ -529,6 +535,10 @@ private:
 	static void constructpropnoargs_intern(call_context* context, asAtom& ret, asAtom& obj, multiname* name, ASObject *constructor);
 	static void constructpropMultiArgs_intern(call_context* context,asAtom& ret,asAtom& obj);
 	static void construct_noargs_intern(call_context* context, asAtom& ret, asAtom& obj);
+	// inline cache lookups for getproperty/setproperty with static names, they return false if the slow path has to be taken
+	// name is replaced by the simple getter/setter name remembered by the cache for the slow path
+	static bool getPropertyInlineCached(call_context* context, const preloadedcodedata* instrptr, const asAtom& obj, multiname*& name, asAtom& ret);
+	static bool setPropertyInlineCached(call_context* context, const preloadedcodedata* instrptr, ASObject* o, multiname*& name, asAtom& value, bool* alreadyset);
 
 #ifdef LLVM_ENABLED
 	//Opcode tables
@@ -763,6 +773,16 @@ private:
 	static void abc_sf64_local_constant(call_context* context);
 	static void abc_sf64_constant_local(call_context* context);
 	static void abc_sf64_local_local(call_context* context);
+	// domain memory accesses with constant addresses that are part of a run set up by batchDomainMemoryChecks
+	template<class T> static void abc_loaddomainmemory_constant_runhead(call_context* context);
+	template<class T> static void abc_loaddomainmemory_constant_unchecked(call_context* context);
+	template<class T> static void abc_loaddomainmemory_constant_localresult_runhead(call_context* context);
+	template<class T> static void abc_loaddomainmemory_constant_localresult_unchecked(call_context* context);
+	template<class T> static void abc_storedomainmemory_constant_constant_runhead(call_context* context);
+	template<class T> static void abc_storedomainmemory_constant_constant_unchecked(call_context* context);
+	template<class T> static void abc_storedomainmemory_local_constant_runhead(call_context* context);
+	template<class T> static void abc_storedomainmemory_local_constant_unchecked(call_context* context);
+	static void executeDomainMemoryRunChecked(call_context* context);
 
 	static void abc_newfunction(call_context* context);// 0x40
 	static void abc_call(call_context* context);
@@ -1369,6 +1389,19 @@ private:
 
 	static void abc_invalidinstruction(call_context* context);
 
+	// handlers of a domain memory access with a constant address, with and without bounds check
+	struct domainmemoryaccess
+	{
+		abc_function checked;
+		abc_function runhead;
+		abc_function unchecked;
+		uint32_t size;
+		bool store;
+	};
+	static const domainmemoryaccess domainmemoryaccesses[];
+	static const domainmemoryaccess* getDomainMemoryAccess(abc_function f, bool includerunhead);
+	static void batchDomainMemoryChecks(method_info* mi, const std::set<int32_t>& jumptargets);
+
 public:
 	static abc_function abcfunctions[];
 
@@ -52,11 +52,11 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 {
 	method_info* mi=function->mi;
 
-	const char* const code=&(mi->body->code[0]);
+	const char* const code=&(mi->body->optimizedcode[0]);
 	//This may be non-zero and point to the position of an exception handler
 
 #if defined (PROFILING_SUPPORT) || !defined(NDEBUG)
-	const uint32_t code_len=mi->body->code.size();
+	const uint32_t code_len=mi->body->optimizedcode.size();
 #endif
 	uint32_t instructionPointer=context->exec_pos-context->mi->body->preloadedcode.data();
 
@@ -70,10 +70,15 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 #define PROF_ACCOUNT_TIME(a, b) do{ ; }while(0)
 #define PROF_IGNORE_TIME(a) do{ ; } while(0)
 #endif
+	//Backward branches count as method hits, so methods with long running loops are preloaded on their next call
+#define BRANCH_TO(dest) do{ if(dest<instructionPointer && mi->body->hit_count<UINT16_MAX) ++mi->body->hit_count; instructionPointer=dest; }while(0)
 
 	//Each case block builds the correct parameters for the interpreter function and call it
 	while(1)
 	{
+		//Leave on exceptions, they are handled by SyntheticFunction::call using the position of the last instruction
+		if(context->exceptionthrown)
+			return nullptr;
 		assert(instructionPointer<code_len);
 		uint8_t opcode=code[instructionPointer];
 		//Save ip for exception handling in SyntheticFunction::callImpl
@@ -149,7 +154,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -164,7 +169,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -179,7 +184,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -194,7 +199,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -205,7 +210,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				instructionPointer+=4;
 
 				assert(dest < code_len);
-				instructionPointer=dest;
+				BRANCH_TO(dest);
 				break;
 			}
 			case 0x11:
@@ -219,7 +224,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -234,7 +239,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -250,7 +255,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -266,7 +271,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -282,7 +287,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -298,7 +303,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -314,7 +319,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -330,7 +335,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -346,7 +351,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -362,7 +367,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				if(cond)
 				{
 					assert(dest < code_len);
-					instructionPointer=dest;
+					BRANCH_TO(dest);
 				}
 				break;
 			}
@@ -383,7 +388,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 					dest=data->uints[2+index];
 
 				assert(dest < code_len);
-				instructionPointer=dest;
+				BRANCH_TO(dest);
 				break;
 			}
 			case 0x1c:
@@ -568,70 +573,70 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 			{
 				//li8
 				LOG_CALL( "li8");
-				ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::loadIntN<uint8_t>(context);
 				break;
 			}
 			case 0x36:
 			{
 				//li16
 				LOG_CALL( "li16");
-				ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::loadIntN<uint16_t>(context);
 				break;
 			}
 			case 0x37:
 			{
 				//li32
 				LOG_CALL( "li32");
-				ApplicationDomain::loadIntN<uint32_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::loadIntN<uint32_t>(context);
 				break;
 			}
 			case 0x38:
 			{
 				//lf32
 				LOG_CALL( "lf32");
-				ApplicationDomain::loadFloat(context->mi->context->applicationDomain, context);
+				ApplicationDomain::loadFloat(context);
 				break;
 			}
 			case 0x39:
 			{
 				//lf32
 				LOG_CALL( "lf64");
-				ApplicationDomain::loadDouble(context->mi->context->applicationDomain, context);
+				ApplicationDomain::loadDouble(context);
 				break;
 			}
 			case 0x3a:
 			{
 				//si8
 				LOG_CALL( "si8");
-				ApplicationDomain::storeIntN<uint8_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::storeIntN<uint8_t>(context);
 				break;
 			}
 			case 0x3b:
 			{
 				//si16
 				LOG_CALL( "si16");
-				ApplicationDomain::storeIntN<uint16_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::storeIntN<uint16_t>(context);
 				break;
 			}
 			case 0x3c:
 			{
 				//si32
 				LOG_CALL( "si32");
-				ApplicationDomain::storeIntN<uint32_t>(context->mi->context->applicationDomain, context);
+				ApplicationDomain::storeIntN<uint32_t>(context);
 				break;
 			}
 			case 0x3d:
 			{
 				//sf32
 				LOG_CALL( "sf32");
-				ApplicationDomain::storeFloat(context->mi->context->applicationDomain, context);
+				ApplicationDomain::storeFloat(context);
 				break;
 			}
 			case 0x3e:
 			{
 				//sf32
 				LOG_CALL( "sf64");
-				ApplicationDomain::storeDouble(context->mi->context->applicationDomain, context);
+				ApplicationDomain::storeDouble(context);
 				break;
 			}
 			case 0x40:
@@ -1148,7 +1153,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 			{
 				//coerce
 				multiname* name=data->names[0];
-				char* rewriteableCode = &(mi->body->code[0]);
+				char* rewriteableCode = &(mi->body->optimizedcode[0]);
 				Type* type = Type::getTypeFromMultiname(name, context->mi->context);
 				OpcodeData* rewritableData=reinterpret_cast<OpcodeData*>(rewriteableCode+instructionPointer);
 				//Rewrite this to a coerceEarly
@@ -1714,7 +1719,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 				ABCVm::getCurrentApplicationDomain(context)->getVariableAndTargetByMultiname(obj,*name,target,context->worker);
 				//The object must exists, since it was found during optimization
 				assert_and_throw(asAtomHandler::isValid(obj));
-				char* rewriteableCode = &(mi->body->code[0]);
+				char* rewriteableCode = &(mi->body->optimizedcode[0]);
 				OpcodeData* rewritableData=reinterpret_cast<OpcodeData*>(rewriteableCode+instructionPointer);
 				//Rewrite this to a pushearly
 				rewriteableCode[instructionPointer-1]=0xff;
@@ -1746,6 +1751,7 @@ ASObject* ABCVm::executeFunctionFast(const SyntheticFunction* function, call_con
 
 #undef PROF_ACCOUNT_TIME 
 #undef PROF_IGNORE_TIME
+#undef BRANCH_TO
 	//We managed to execute all the function
 	RUNTIME_STACK_POP_CREATE_ASOBJECT(context,returnvalue);
 	return returnvalue;
@@ -8310,6 +8310,7 @@ void ABCVm::preloadFunction(SyntheticFunction* function, ASWorker* wrk)
 	state.oldnewpositions[code.tellg()+1] = (int32_t)state.preloadedcode.size();
 	
 	// adjust jump positions to new code vector;
+	std::set<int32_t> newjumptargets;
 	auto itj = jumppositions.begin();
 	while (itj != jumppositions.end())
 	{
@@ -8321,7 +8322,10 @@ void ABCVm::preloadFunction(SyntheticFunction* function, ASWorker* wrk)
 			createError<VerifyError>(wrk,kInvalidBranchTargetError);
 		}
 		else
+		{
 			state.preloadedcode[itj->first].pcode.arg3_int = (state.oldnewpositions[p+itj->second]-(state.oldnewpositions[p]))+1;
+			newjumptargets.insert(state.oldnewpositions[p+itj->second]);
+		}
 		itj++;
 	}
 	// adjust switch positions to new code vector;
@@ -8332,6 +8336,7 @@ void ABCVm::preloadFunction(SyntheticFunction* function, ASWorker* wrk)
 		assert (state.oldnewpositions.find(p) != state.oldnewpositions.end());
 		assert (state.oldnewpositions.find(p+its->second) != state.oldnewpositions.end());
 		state.preloadedcode[its->first].pcode.arg3_int = state.oldnewpositions[p+its->second]-(state.oldnewpositions[p]);
+		newjumptargets.insert(state.oldnewpositions[p+its->second]);
 		its++;
 	}
 	auto itexc = mi->body->exceptions.begin();
@@ -8361,6 +8366,7 @@ void ABCVm::preloadFunction(SyntheticFunction* function, ASWorker* wrk)
 
 		assert (state.oldnewpositions.find(itexc->target) != state.oldnewpositions.end());
 		itexc->target = state.oldnewpositions[itexc->target];
+		newjumptargets.insert(itexc->target);
 		itexc++;
 	}
 	assert(mi->body->preloadedcode.size()==0);
@@ -8377,7 +8383,52 @@ void ABCVm::preloadFunction(SyntheticFunction* function, ASWorker* wrk)
 		if ((*itc).cachedslot3)
 			mi->body->preloadedcode[mi->body->preloadedcode.size()-1].local3.pos+= mi->body->getReturnValuePos()+1+mi->body->localresultcount;
 	}
+	batchDomainMemoryChecks(mi,newjumptargets);
 	if (activationobject)
 		activationobject->decRef();
 }
 
+/* find runs of consecutive domain memory accesses with constant addresses that are not interrupted by a jump target.
+ * The first access of a run checks the bounds for the whole run, the following accesses are done unchecked */
+void ABCVm::batchDomainMemoryChecks(method_info* mi, const std::set<int32_t>& jumptargets)
+{
+	std::vector<preloadedcodedata>& code = mi->body->preloadedcode;
+	std::vector<const domainmemoryaccess*> run;
+	uint32_t i = 0;
+	while (i < code.size())
+	{
+		uint32_t runstart = i;
+		uint64_t runend = 0;
+		run.clear();
+		while (i < code.size() && (i == runstart || jumptargets.find(i) == jumptargets.end()))
+		{
+			const domainmemoryaccess* access = domainmemoryaccesses;
+			while (access->checked && access->checked != code[i].func)
+				access++;
+			if (!access->checked)
+				break;
+			asAtom& addr = access->store ? *code[i].arg2_constant : *code[i].arg1_constant;
+			if (!asAtomHandler::isUInteger(addr) && !(asAtomHandler::isInteger(addr) && asAtomHandler::toInt(addr) >= 0))
+				break;
+			uint64_t end = uint64_t(asAtomHandler::toUInt(addr))+access->size;
+			if (end > UINT32_MAX)
+				break;
+			runend = max(runend,end);
+			run.push_back(access);
+			i++;
+		}
+		if (run.size() > 1)
+		{
+			if (run[0]->store)
+				code[runstart].arg3_uint = runend;
+			else
+				code[runstart].arg2_uint = runend;
+			code[runstart].func = run[0]->runhead;
+			for (uint32_t j = 1; j < run.size(); j++)
+				code[runstart+j].func = run[j]->unchecked;
+		}
+		if (i == runstart)
+			i++;
+	}
+}
+
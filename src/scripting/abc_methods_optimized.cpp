@@ -84,6 +84,139 @@ FORCE_INLINE bool checkPropertyExceptionInteger(const asAtom& obj,int index, asA
 	return checkPropertyException(obj,&m, prop, wrk);
 }
 
+// only instances of sealed user classes are cached, as their properties are always found in the slots created by the class traits
+FORCE_INLINE bool isInlineCacheable(ASObject* o)
+{
+	Class_base* cls = o->getClass();
+	if (o->getObjectType() != T_OBJECT || cls == nullptr || cls->isBuiltin() || !cls->isSealed)
+		return false;
+	switch (o->getSubtype())
+	{
+		case SUBTYPE_PROXY:
+		case SUBTYPE_XML:
+		case SUBTYPE_XMLLIST:
+		case SUBTYPE_BYTEARRAY:
+		case SUBTYPE_DICTIONARY:
+		case SUBTYPE_ACTIVATIONOBJECT:
+		case SUBTYPE_GLOBAL:
+			return false;
+		default:
+			return true;
+	}
+}
+FORCE_INLINE inlinecache_entry* findInlineCacheEntry(property_inlinecache* ic, Class_base* cls)
+{
+	if (cls == nullptr)
+		return nullptr;
+	for (uint32_t i = 0; i < ic->count; i++)
+	{
+		if (ic->entries[i].classUniqueID == cls->uniqueID)
+			return &ic->entries[i];
+	}
+	return nullptr;
+}
+// adds an entry for the class, slot UINT32_MAX marks classes that always have to take the slow path
+void addInlineCacheEntry(property_inlinecache* ic, Class_base* cls, uint32_t slot)
+{
+	if (ic->count == INLINECACHE_SIZE)
+		return;
+	inlinecache_entry& e = ic->entries[ic->count++];
+	e.classUniqueID = cls->uniqueID;
+	e.slot = slot;
+	LOG_CALL("inline cache entry added " << *ic->name << " " << cls->toDebugString() << " slot " << slot << " entries " << ic->count);
+}
+
+bool ABCVm::getPropertyInlineCached(call_context* context, const preloadedcodedata* instrptr, const asAtom& obj, multiname*& name, asAtom& ret)
+{
+	property_inlinecache* ic = context->mi->body->getInlineCache(instrptr,name);
+	if (ic->simplename)
+		name = ic->simplename;
+	if (!asAtomHandler::isObject(obj))
+		return false;
+	ASObject* o = asAtomHandler::getObjectNoCheck(obj);
+	inlinecache_entry* e = findInlineCacheEntry(ic,o->getClass());
+	variable* v = nullptr;
+	if (e)
+	{
+		if (e->slot < o->Variables.slotcount)
+			v = o->Variables.slots_vars[e->slot];
+		if (!v || asAtomHandler::isInvalid(v->var) || asAtomHandler::isFunction(v->var))
+		{
+			ic->misses++;
+			return false;
+		}
+		ic->hits++;
+	}
+	else
+	{
+		ic->misses++;
+		if (ic->count == INLINECACHE_SIZE || !isInlineCacheable(o))
+			return false;
+		v = o->Variables.findObjVar(o->getSystemState(),*ic->name,DECLARED_TRAIT|DYNAMIC_TRAIT);
+		if (!v || (v->kind != DECLARED_TRAIT && v->kind != CONSTANT_TRAIT) || v->slotid == 0 || v->min_swfversion
+				|| asAtomHandler::isValid(v->getter) || asAtomHandler::isValid(v->setter)
+				|| asAtomHandler::isInvalid(v->var) || asAtomHandler::isFunction(v->var)
+				|| v->slotid > o->Variables.slotcount || o->Variables.slots_vars[v->slotid-1] != v)
+		{
+			addInlineCacheEntry(ic,o->getClass(),UINT32_MAX);
+			return false;
+		}
+		addInlineCacheEntry(ic,o->getClass(),v->slotid-1);
+	}
+	ret = v->var;
+	ASATOM_INCREF(ret);
+	return true;
+}
+
+bool ABCVm::setPropertyInlineCached(call_context* context, const preloadedcodedata* instrptr, ASObject* o, multiname*& name, asAtom& value, bool* alreadyset)
+{
+	property_inlinecache* ic = context->mi->body->getInlineCache(instrptr,name);
+	if (ic->simplename)
+		name = ic->simplename;
+	inlinecache_entry* e = findInlineCacheEntry(ic,o->getClass());
+	variable* v = nullptr;
+	if (e)
+	{
+		if (e->slot >= o->Variables.slotcount)
+		{
+			ic->misses++;
+			return false;
+		}
+		v = o->Variables.slots_vars[e->slot];
+		ic->hits++;
+	}
+	else
+	{
+		ic->misses++;
+		if (ic->count == INLINECACHE_SIZE || !isInlineCacheable(o))
+			return false;
+		v = o->Variables.findVarOrSetter(o->getSystemState(),*ic->name,DECLARED_TRAIT|DYNAMIC_TRAIT);
+		if (!v || v->kind != DECLARED_TRAIT || v->slotid == 0 || v->min_swfversion
+				|| asAtomHandler::isValid(v->getter) || asAtomHandler::isValid(v->setter)
+				|| asAtomHandler::isInvalid(v->var)
+				|| v->slotid > o->Variables.slotcount || o->Variables.slots_vars[v->slotid-1] != v)
+		{
+			addInlineCacheEntry(ic,o->getClass(),UINT32_MAX);
+			return false;
+		}
+		addInlineCacheEntry(ic,o->getClass(),v->slotid-1);
+	}
+	// same as setting a plain variable in ASObject::setVariableByMultiname_intern
+	if (alreadyset)
+	{
+		if (value.uintval == v->var.uintval)
+			*alreadyset = true;
+		else
+		{
+			v->setVar(context->worker,value);
+			*alreadyset = value.uintval != v->var.uintval; // setVar may coerce the object into a new instance, so we need to check if decRef is necessary
+		}
+	}
+	else
+		v->setVar(context->worker,value);
+	return true;
+}
+
 void setCallException(const asAtom& obj, multiname* name, ASWorker* wrk)
 {
 	ASObject* pobj = asAtomHandler::getObject(obj);
@@ -731,7 +864,7 @@ void ABCVm::abc_li8_constant(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li8_c");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<uint8_t>(context,ret,*instrptr->arg1_constant);
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -740,7 +873,7 @@ void ABCVm::abc_li8_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li8_l");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadIntN<uint8_t>(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -749,7 +882,7 @@ void ABCVm::abc_li8_constant_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li8_cl");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<uint8_t>(context,ret,*instrptr->arg1_constant);
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
@@ -759,20 +892,20 @@ void ABCVm::abc_li8_local_localresult(call_context* context)
 	LOG_CALL( "li8_ll");
 	asAtom oldres = CONTEXT_GETLOCAL(context,instrptr->local3.pos);
 	uint32_t addr=asAtomHandler::getUInt(CONTEXT_GETLOCAL(context,instrptr->local_pos1));
-	ByteArray* dm = context->mi->context->applicationDomain->currentDomainMemory;
-	if(USUALLY_FALSE(dm->getLength() <= addr))
+	const domainmemoryview& dm = context->getDomainMemory();
+	if(USUALLY_FALSE(dm.length <= addr))
 	{
 		createError<RangeError>(context->worker,kInvalidRangeError);
 		return;
 	}
-	(CONTEXT_GETLOCAL(context,instrptr->local3.pos).uintval=(*(dm->getBufferNoCheck()+addr))<<3|ATOM_INTEGER);
+	(CONTEXT_GETLOCAL(context,instrptr->local3.pos).uintval=(*(dm.base+addr))<<3|ATOM_INTEGER);
 	ASATOM_DECREF(oldres);
 	++(context->exec_pos);
 }
 void ABCVm::abc_li8_constant_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain,ret,*context->exec_pos->arg1_constant);
+	ApplicationDomain::loadIntN<uint8_t>(context,ret,*context->exec_pos->arg1_constant);
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -783,7 +916,7 @@ void ABCVm::abc_li8_constant_setslotnocoerce(call_context* context)
 void ABCVm::abc_li8_local_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint8_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
+	ApplicationDomain::loadIntN<uint8_t>(context,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -797,7 +930,7 @@ void ABCVm::abc_li16_constant(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li16_c");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,*instrptr->arg1_constant);
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -806,7 +939,7 @@ void ABCVm::abc_li16_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li16_l");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -815,7 +948,7 @@ void ABCVm::abc_li16_constant_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li16_cl");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,*instrptr->arg1_constant);
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
@@ -824,14 +957,14 @@ void ABCVm::abc_li16_local_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li16_ll");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
 void ABCVm::abc_li16_constant_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,*context->exec_pos->arg1_constant);
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,*context->exec_pos->arg1_constant);
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -842,7 +975,7 @@ void ABCVm::abc_li16_constant_setslotnocoerce(call_context* context)
 void ABCVm::abc_li16_local_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<uint16_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
+	ApplicationDomain::loadIntN<uint16_t>(context,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -855,7 +988,7 @@ void ABCVm::abc_li32_constant(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li32_c");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<int32_t>(context,ret,*instrptr->arg1_constant);
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -864,7 +997,7 @@ void ABCVm::abc_li32_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li32_l");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadIntN<int32_t>(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -873,7 +1006,7 @@ void ABCVm::abc_li32_constant_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li32_cl");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadIntN<int32_t>(context,ret,*instrptr->arg1_constant);
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
@@ -882,14 +1015,14 @@ void ABCVm::abc_li32_local_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "li32_ll");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadIntN<int32_t>(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
 void ABCVm::abc_li32_constant_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,*context->exec_pos->arg1_constant);
+	ApplicationDomain::loadIntN<int32_t>(context,ret,*context->exec_pos->arg1_constant);
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -900,7 +1033,7 @@ void ABCVm::abc_li32_constant_setslotnocoerce(call_context* context)
 void ABCVm::abc_li32_local_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadIntN<int32_t>(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
+	ApplicationDomain::loadIntN<int32_t>(context,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -914,7 +1047,7 @@ void ABCVm::abc_lf32_constant(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf32_c");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadFloat(context,ret,*instrptr->arg1_constant);
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -923,7 +1056,7 @@ void ABCVm::abc_lf32_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf32_l");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadFloat(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -931,20 +1064,20 @@ void ABCVm::abc_lf32_constant_localresult(call_context* context)
 {
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf32_cl");
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local3.pos),*instrptr->arg1_constant);
+	ApplicationDomain::loadFloat(context,CONTEXT_GETLOCAL(context,instrptr->local3.pos),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_lf32_local_localresult(call_context* context)
 {
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf32_ll");
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local3.pos),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadFloat(context,CONTEXT_GETLOCAL(context,instrptr->local3.pos),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_lf32_constant_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,ret,*context->exec_pos->arg1_constant);
+	ApplicationDomain::loadFloat(context,ret,*context->exec_pos->arg1_constant);
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -955,7 +1088,7 @@ void ABCVm::abc_lf32_constant_setslotnocoerce(call_context* context)
 void ABCVm::abc_lf32_local_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadFloat(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
+	ApplicationDomain::loadFloat(context,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -968,7 +1101,7 @@ void ABCVm::abc_lf64_constant(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf64_c");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadDouble(context,ret,*instrptr->arg1_constant);
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -977,7 +1110,7 @@ void ABCVm::abc_lf64_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf64_l");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadDouble(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
@@ -986,7 +1119,7 @@ void ABCVm::abc_lf64_constant_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf64_cl");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,*instrptr->arg1_constant);
+	ApplicationDomain::loadDouble(context,ret,*instrptr->arg1_constant);
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
@@ -995,14 +1128,14 @@ void ABCVm::abc_lf64_local_localresult(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	LOG_CALL( "lf64_ll");
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::loadDouble(context,ret,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	replacelocalresult(context,instrptr->local3.pos,ret);
 	++(context->exec_pos);
 }
 void ABCVm::abc_lf64_constant_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,*context->exec_pos->arg1_constant);
+	ApplicationDomain::loadDouble(context,ret,*context->exec_pos->arg1_constant);
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -1013,7 +1146,7 @@ void ABCVm::abc_lf64_constant_setslotnocoerce(call_context* context)
 void ABCVm::abc_lf64_local_setslotnocoerce(call_context* context)
 {
 	asAtom ret=asAtomHandler::invalidAtom;
-	ApplicationDomain::loadDouble(context->mi->context->applicationDomain,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
+	ApplicationDomain::loadDouble(context,ret,CONTEXT_GETLOCAL(context,context->exec_pos->local_pos1));
 
 	asAtom obj = CONTEXT_GETLOCAL(context,context->exec_pos->local3.pos);
 	uint32_t t = context->exec_pos->local3.flags & ~ABC_OP_BITMASK_USED;
@@ -1025,21 +1158,21 @@ void ABCVm::abc_si8_constant_constant(call_context* context)
 {
 	LOG_CALL( "si8_cc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint8_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint8_t>(context,*instrptr->arg2_constant,*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si8_local_constant(call_context* context)
 {
 	LOG_CALL( "si8_lc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint8_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeIntN<uint8_t>(context,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_si8_constant_local(call_context* context)
 {
 	LOG_CALL( "si8_cl");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint8_t>(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint8_t>(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si8_local_local(call_context* context)
@@ -1048,13 +1181,13 @@ void ABCVm::abc_si8_local_local(call_context* context)
 	preloadedcodedata* instrptr = context->exec_pos;
 	uint32_t addr=asAtomHandler::getUInt(CONTEXT_GETLOCAL(context,instrptr->local_pos2));
 	int32_t val=asAtomHandler::getInt(CONTEXT_GETLOCAL(context,instrptr->local_pos1));
-	ByteArray* dm = context->mi->context->applicationDomain->currentDomainMemory;
-	if(USUALLY_FALSE(dm->getLength() <= addr))
+	const domainmemoryview& dm = context->getDomainMemory();
+	if(USUALLY_FALSE(dm.length <= addr))
 	{
 		createError<RangeError>(context->worker,kInvalidRangeError);
 		return;
 	}
-	*(dm->getBufferNoCheck()+addr)=val;
+	*(dm.base+addr)=val;
 
 	++(context->exec_pos);
 }
@@ -1062,114 +1195,277 @@ void ABCVm::abc_si16_constant_constant(call_context* context)
 {
 	LOG_CALL( "si16_cc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint16_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint16_t>(context,*instrptr->arg2_constant,*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si16_local_constant(call_context* context)
 {
 	LOG_CALL( "si16_lc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint16_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeIntN<uint16_t>(context,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_si16_constant_local(call_context* context)
 {
 	LOG_CALL( "si16_cl");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint16_t>(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint16_t>(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si16_local_local(call_context* context)
 {
 	LOG_CALL( "si16_ll");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint16_t>(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeIntN<uint16_t>(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_si32_constant_constant(call_context* context)
 {
 	LOG_CALL( "si32_cc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint32_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint32_t>(context,*instrptr->arg2_constant,*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si32_local_constant(call_context* context)
 {
 	LOG_CALL( "si32_lc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint32_t>(context->mi->context->applicationDomain,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeIntN<uint32_t>(context,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_si32_constant_local(call_context* context)
 {
 	LOG_CALL( "si32_cl");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint32_t>(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
+	ApplicationDomain::storeIntN<uint32_t>(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_si32_local_local(call_context* context)
 {
 	LOG_CALL( "si32_ll");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeIntN<uint32_t>(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeIntN<uint32_t>(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf32_constant_constant(call_context* context)
 {
 	LOG_CALL( "sf32_cc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeFloat(context->mi->context->applicationDomain,*instrptr->arg2_constant,*instrptr->arg1_constant);
+	ApplicationDomain::storeFloat(context,*instrptr->arg2_constant,*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf32_local_constant(call_context* context)
 {
 	LOG_CALL( "sf32_lc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeFloat(context->mi->context->applicationDomain,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeFloat(context,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf32_constant_local(call_context* context)
 {
 	LOG_CALL( "sf32_cl");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeFloat(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
+	ApplicationDomain::storeFloat(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf32_local_local(call_context* context)
 {
 	LOG_CALL( "sf32_ll");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeFloat(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeFloat(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf64_constant_constant(call_context* context)
 {
 	LOG_CALL( "sf64_cc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeDouble(context->mi->context->applicationDomain,*instrptr->arg2_constant,*instrptr->arg1_constant);
+	ApplicationDomain::storeDouble(context,*instrptr->arg2_constant,*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf64_local_constant(call_context* context)
 {
 	LOG_CALL( "sf64_lc");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeDouble(context->mi->context->applicationDomain,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeDouble(context,*instrptr->arg2_constant,CONTEXT_GETLOCAL(context,instrptr->local_pos1));
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf64_constant_local(call_context* context)
 {
 	LOG_CALL( "sf64_cl");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeDouble(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
+	ApplicationDomain::storeDouble(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),*instrptr->arg1_constant);
 	++(context->exec_pos);
 }
 void ABCVm::abc_sf64_local_local(call_context* context)
 {
 	LOG_CALL( "sf64_ll");
 	preloadedcodedata* instrptr = context->exec_pos;
-	ApplicationDomain::storeDouble(context->mi->context->applicationDomain,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	ApplicationDomain::storeDouble(context,CONTEXT_GETLOCAL(context,instrptr->local_pos2),CONTEXT_GETLOCAL(context,instrptr->local_pos1));
+	++(context->exec_pos);
+}
+
+/* Runs of domain memory accesses with constant addresses (see ABCVm::batchDomainMemoryChecks).
+ * The head of a run checks once that the end of the run is inside the domain memory, the other
+ * accesses of the run use the buffer resolved by the head without checking the bounds.
+ * The end of the run is stored in the argument that is not used by the access (arg2 for loads, arg3 for stores) */
+FORCE_INLINE void setDomainMemoryResult(call_context* context, asAtom& ret, int32_t val)
+{
+	asAtom oldret = ret;
+	ret = asAtomHandler::fromInt(val);
+	ASATOM_DECREF(oldret);
+}
+FORCE_INLINE void setDomainMemoryResult(call_context* context, asAtom& ret, number_t val)
+{
+	asAtom oldret = ret;
+	if (asAtomHandler::replaceNumber(ret,context->worker,val))
+		ASATOM_DECREF(oldret);
+}
+template<class T>
+FORCE_INLINE T getDomainMemoryValue(asAtom& a)
+{
+	return asAtomHandler::toInt(a);
+}
+template<>
+FORCE_INLINE float getDomainMemoryValue<float>(asAtom& a)
+{
+	return asAtomHandler::toNumber(a);
+}
+template<>
+FORCE_INLINE double getDomainMemoryValue<double>(asAtom& a)
+{
+	return asAtomHandler::toNumber(a);
+}
+template<class T>
+void ABCVm::abc_loaddomainmemory_constant_runhead(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("loaddomainmemory_c_runhead "<<instrptr->arg2_uint);
+	if (USUALLY_FALSE(context->getDomainMemory().length < instrptr->arg2_uint))
+	{
+		executeDomainMemoryRunChecked(context);
+		return;
+	}
+	abc_loaddomainmemory_constant_unchecked<T>(context);
+}
+template<class T>
+void ABCVm::abc_loaddomainmemory_constant_unchecked(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("loaddomainmemory_c_unchecked");
+	asAtom ret=asAtomHandler::invalidAtom;
+	setDomainMemoryResult(context,ret,*reinterpret_cast<T*>(context->domainMemory.base+asAtomHandler::toUInt(*instrptr->arg1_constant)));
+	RUNTIME_STACK_PUSH(context,ret);
 	++(context->exec_pos);
 }
+template<class T>
+void ABCVm::abc_loaddomainmemory_constant_localresult_runhead(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("loaddomainmemory_cl_runhead "<<instrptr->arg2_uint);
+	if (USUALLY_FALSE(context->getDomainMemory().length < instrptr->arg2_uint))
+	{
+		executeDomainMemoryRunChecked(context);
+		return;
+	}
+	abc_loaddomainmemory_constant_localresult_unchecked<T>(context);
+}
+template<class T>
+void ABCVm::abc_loaddomainmemory_constant_localresult_unchecked(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("loaddomainmemory_cl_unchecked");
+	setDomainMemoryResult(context,CONTEXT_GETLOCAL(context,instrptr->local3.pos),*reinterpret_cast<T*>(context->domainMemory.base+asAtomHandler::toUInt(*instrptr->arg1_constant)));
+	++(context->exec_pos);
+}
+template<class T>
+void ABCVm::abc_storedomainmemory_constant_constant_runhead(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("storedomainmemory_cc_runhead "<<instrptr->arg3_uint);
+	if (USUALLY_FALSE(context->getDomainMemory().length < instrptr->arg3_uint))
+	{
+		executeDomainMemoryRunChecked(context);
+		return;
+	}
+	abc_storedomainmemory_constant_constant_unchecked<T>(context);
+}
+template<class T>
+void ABCVm::abc_storedomainmemory_constant_constant_unchecked(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("storedomainmemory_cc_unchecked");
+	*reinterpret_cast<T*>(context->domainMemory.base+asAtomHandler::toUInt(*instrptr->arg2_constant))=getDomainMemoryValue<T>(*instrptr->arg1_constant);
+	++(context->exec_pos);
+}
+template<class T>
+void ABCVm::abc_storedomainmemory_local_constant_runhead(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("storedomainmemory_lc_runhead "<<instrptr->arg3_uint);
+	if (USUALLY_FALSE(context->getDomainMemory().length < instrptr->arg3_uint))
+	{
+		executeDomainMemoryRunChecked(context);
+		return;
+	}
+	abc_storedomainmemory_local_constant_unchecked<T>(context);
+}
+template<class T>
+void ABCVm::abc_storedomainmemory_local_constant_unchecked(call_context* context)
+{
+	preloadedcodedata* instrptr = context->exec_pos;
+	LOG_CALL("storedomainmemory_lc_unchecked");
+	asAtom& v = CONTEXT_GETLOCAL(context,instrptr->local_pos1);
+	// converting a non numeric value may call AS code that changes the domain memory, so the rest of the run has to be checked
+	if (USUALLY_FALSE(!asAtomHandler::isNumeric(v)))
+	{
+		executeDomainMemoryRunChecked(context);
+		return;
+	}
+	*reinterpret_cast<T*>(context->domainMemory.base+asAtomHandler::toUInt(*instrptr->arg2_constant))=getDomainMemoryValue<T>(v);
+	++(context->exec_pos);
+}
+// executes the rest of a run with the checked handlers, starting with the current instruction
+void ABCVm::executeDomainMemoryRunChecked(call_context* context)
+{
+	const domainmemoryaccess* access = getDomainMemoryAccess(context->exec_pos->func,true);
+	while (access && !context->exceptionthrown)
+	{
+		access->checked(context);
+		access = getDomainMemoryAccess(context->exec_pos->func,false);
+	}
+}
+const ABCVm::domainmemoryaccess* ABCVm::getDomainMemoryAccess(abc_function f, bool includerunhead)
+{
+	for (const domainmemoryaccess* access = domainmemoryaccesses; access->checked; access++)
+	{
+		if (access->unchecked == f || (includerunhead && access->runhead == f))
+			return access;
+	}
+	return nullptr;
+}
+const ABCVm::domainmemoryaccess ABCVm::domainmemoryaccesses[] = {
+	{ abc_li8_constant, abc_loaddomainmemory_constant_runhead<uint8_t>, abc_loaddomainmemory_constant_unchecked<uint8_t>, 1, false },
+	{ abc_li8_constant_localresult, abc_loaddomainmemory_constant_localresult_runhead<uint8_t>, abc_loaddomainmemory_constant_localresult_unchecked<uint8_t>, 1, false },
+	{ abc_li16_constant, abc_loaddomainmemory_constant_runhead<uint16_t>, abc_loaddomainmemory_constant_unchecked<uint16_t>, 2, false },
+	{ abc_li16_constant_localresult, abc_loaddomainmemory_constant_localresult_runhead<uint16_t>, abc_loaddomainmemory_constant_localresult_unchecked<uint16_t>, 2, false },
+	{ abc_li32_constant, abc_loaddomainmemory_constant_runhead<int32_t>, abc_loaddomainmemory_constant_unchecked<int32_t>, 4, false },
+	{ abc_li32_constant_localresult, abc_loaddomainmemory_constant_localresult_runhead<int32_t>, abc_loaddomainmemory_constant_localresult_unchecked<int32_t>, 4, false },
+	{ abc_lf32_constant, abc_loaddomainmemory_constant_runhead<float>, abc_loaddomainmemory_constant_unchecked<float>, 4, false },
+	{ abc_lf32_constant_localresult, abc_loaddomainmemory_constant_localresult_runhead<float>, abc_loaddomainmemory_constant_localresult_unchecked<float>, 4, false },
+	{ abc_lf64_constant, abc_loaddomainmemory_constant_runhead<double>, abc_loaddomainmemory_constant_unchecked<double>, 8, false },
+	{ abc_lf64_constant_localresult, abc_loaddomainmemory_constant_localresult_runhead<double>, abc_loaddomainmemory_constant_localresult_unchecked<double>, 8, false },
+	{ abc_si8_constant_constant, abc_storedomainmemory_constant_constant_runhead<uint8_t>, abc_storedomainmemory_constant_constant_unchecked<uint8_t>, 1, true },
+	{ abc_si8_local_constant, abc_storedomainmemory_local_constant_runhead<uint8_t>, abc_storedomainmemory_local_constant_unchecked<uint8_t>, 1, true },
+	{ abc_si16_constant_constant, abc_storedomainmemory_constant_constant_runhead<uint16_t>, abc_storedomainmemory_constant_constant_unchecked<uint16_t>, 2, true },
+	{ abc_si16_local_constant, abc_storedomainmemory_local_constant_runhead<uint16_t>, abc_storedomainmemory_local_constant_unchecked<uint16_t>, 2, true },
+	{ abc_si32_constant_constant, abc_storedomainmemory_constant_constant_runhead<uint32_t>, abc_storedomainmemory_constant_constant_unchecked<uint32_t>, 4, true },
+	{ abc_si32_local_constant, abc_storedomainmemory_local_constant_runhead<uint32_t>, abc_storedomainmemory_local_constant_unchecked<uint32_t>, 4, true },
+	{ abc_sf32_constant_constant, abc_storedomainmemory_constant_constant_runhead<float>, abc_storedomainmemory_constant_constant_unchecked<float>, 4, true },
+	{ abc_sf32_local_constant, abc_storedomainmemory_local_constant_runhead<float>, abc_storedomainmemory_local_constant_unchecked<float>, 4, true },
+	{ abc_sf64_constant_constant, abc_storedomainmemory_constant_constant_runhead<double>, abc_storedomainmemory_constant_constant_unchecked<double>, 8, true },
+	{ abc_sf64_local_constant, abc_storedomainmemory_local_constant_runhead<double>, abc_storedomainmemory_local_constant_unchecked<double>, 8, true },
+	{ nullptr, nullptr, nullptr, 0, false }
+};
 void ABCVm::construct_noargs_intern(call_context* context,asAtom& ret,asAtom& obj)
 {
 	context->explicitConstruction = true;
@@ -2231,13 +2527,16 @@ void ABCVm::abc_setPropertyStaticName(call_context* context)
 	}
 	ASObject* o = asAtomHandler::toObject(*obj,context->worker);
 	bool alreadyset=false;
-	multiname* simplesettername = nullptr;
-	if (context->exec_pos->local3.pos == 0x68)//initproperty
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
-	else//Do not allow to set contant traits
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
-	if (simplesettername)
-		context->exec_pos->cachedmultiname2 = simplesettername;
+	if (!setPropertyInlineCached(context,context->exec_pos,o,name,*value,&alreadyset))
+	{
+		multiname* simplesettername = nullptr;
+		if (context->exec_pos->local3.pos == 0x68)//initproperty
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
+		else//Do not allow to set contant traits
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
+		if (simplesettername)
+			context->mi->body->getInlineCache(context->exec_pos,name)->simplename = simplesettername;
+	}
 	if (alreadyset || context->exceptionthrown)
 		ASATOM_DECREF_POINTER(value);
 	ASATOM_DECREF_POINTER(obj);
@@ -2267,13 +2566,16 @@ void ABCVm::abc_setPropertyStaticName_constant_constant(call_context* context)
 	}
 
 	ASObject* o = asAtomHandler::toObject(*obj,context->worker);
-	multiname* simplesettername = nullptr;
-	if (context->exec_pos->local3.pos == 0x68)//initproperty
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,nullptr,context->worker);
-	else//Do not allow to set contant traits
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,nullptr,context->worker);
-	if (simplesettername)
-		context->exec_pos->cachedmultiname2 = simplesettername;
+	if (!setPropertyInlineCached(context,instrptr,o,name,*value,nullptr))
+	{
+		multiname* simplesettername = nullptr;
+		if (context->exec_pos->local3.pos == 0x68)//initproperty
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,nullptr,context->worker);
+		else//Do not allow to set contant traits
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,nullptr,context->worker);
+		if (simplesettername)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplesettername;
+	}
 	++(context->exec_pos);
 }
 void ABCVm::abc_setPropertyStaticName_local_constant(call_context* context)
@@ -2300,13 +2602,16 @@ void ABCVm::abc_setPropertyStaticName_local_constant(call_context* context)
 	}
 	ASObject* o = asAtomHandler::toObject(*obj,context->worker);
 	o->incRef(); // this is neccessary for reference counting in case of exception thrown in setVariableByMultiname
-	multiname* simplesettername = nullptr;
-	if (context->exec_pos->local3.pos == 0x68)//initproperty
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,nullptr,context->worker);
-	else//Do not allow to set contant traits
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,nullptr,context->worker);
-	if (simplesettername)
-		context->exec_pos->cachedmultiname2 = simplesettername;
+	if (!setPropertyInlineCached(context,instrptr,o,name,*value,nullptr))
+	{
+		multiname* simplesettername = nullptr;
+		if (context->exec_pos->local3.pos == 0x68)//initproperty
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,nullptr,context->worker);
+		else//Do not allow to set contant traits
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,nullptr,context->worker);
+		if (simplesettername)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplesettername;
+	}
 	o->decRef(); // this is neccessary for reference counting in case of exception thrown in setVariableByMultiname
 	++(context->exec_pos);
 }
@@ -2335,13 +2640,16 @@ void ABCVm::abc_setPropertyStaticName_constant_local(call_context* context)
 	ASObject* o = asAtomHandler::toObject(*obj,context->worker);
 	ASATOM_INCREF_POINTER(value);
 	bool alreadyset=false;
-	multiname* simplesettername = nullptr;
-	if (context->exec_pos->local3.pos == 0x68)//initproperty
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
-	else//Do not allow to set contant traits
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
-	if (simplesettername)
-		context->exec_pos->cachedmultiname2 = simplesettername;
+	if (!setPropertyInlineCached(context,instrptr,o,name,*value,&alreadyset))
+	{
+		multiname* simplesettername = nullptr;
+		if (context->exec_pos->local3.pos == 0x68)//initproperty
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
+		else//Do not allow to set contant traits
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
+		if (simplesettername)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplesettername;
+	}
 	if (alreadyset || context->exceptionthrown)
 		ASATOM_DECREF_POINTER(value);
 	++(context->exec_pos);
@@ -2372,13 +2680,16 @@ void ABCVm::abc_setPropertyStaticName_local_local(call_context* context)
 	o->incRef(); // this is neccessary for reference counting in case of exception thrown in setVariableByMultiname
 	ASATOM_INCREF_POINTER(value);
 	bool alreadyset=false;
-	multiname* simplesettername = nullptr;
-	if (context->exec_pos->local3.pos == 0x68)//initproperty
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
-	else//Do not allow to set contant traits
-		simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
-	if (simplesettername)
-		context->exec_pos->cachedmultiname2 = simplesettername;
+	if (!setPropertyInlineCached(context,instrptr,o,name,*value,&alreadyset))
+	{
+		multiname* simplesettername = nullptr;
+		if (context->exec_pos->local3.pos == 0x68)//initproperty
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_ALLOWED,&alreadyset,context->worker);
+		else//Do not allow to set contant traits
+			simplesettername =o->setVariableByMultiname(*name,*value,ASObject::CONST_NOT_ALLOWED,&alreadyset,context->worker);
+		if (simplesettername)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplesettername;
+	}
 	if (alreadyset || context->exceptionthrown)
 		ASATOM_DECREF_POINTER(value);
 	o->decRef(); // this is neccessary for reference counting in case of exception thrown in setVariableByMultiname
@@ -3283,12 +3594,15 @@ void ABCVm::abc_getPropertyStaticName_constant(call_context* context)
 	asAtom obj= *instrptr->arg1_constant;
 	LOG_CALL( "getProperty_sc " << *name << ' ' << asAtomHandler::toDebugString(obj));
 	asAtom prop=asAtomHandler::invalidAtom;
-	bool canCache=false;
-	multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
-	if (simplegetter)
-		instrptr->cachedmultiname2 = simplegetter;
-	if(checkPropertyException(obj,name,prop,context->worker))
-		return;
+	if (!getPropertyInlineCached(context,instrptr,obj,name,prop))
+	{
+		bool canCache=false;
+		multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
+		if (simplegetter)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplegetter;
+		if(checkPropertyException(obj,name,prop,context->worker))
+			return;
+	}
 	RUNTIME_STACK_PUSH(context,prop);
 	++(context->exec_pos);
 }
@@ -3311,12 +3625,15 @@ void ABCVm::abc_getPropertyStaticName_local(call_context* context)
 	{
 		asAtom obj= CONTEXT_GETLOCAL(context,instrptr->local_pos1);
 		LOG_CALL( "getProperty_sl " << *name << ' ' << asAtomHandler::toDebugString(obj));
-		bool canCache=false;
-		multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
-		if (simplegetter)
-			instrptr->cachedmultiname2 = simplegetter;
-		if(checkPropertyException(obj,name,prop,context->worker))
-			return;
+		if (!getPropertyInlineCached(context,instrptr,obj,name,prop))
+		{
+			bool canCache=false;
+			multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
+			if (simplegetter)
+				context->mi->body->getInlineCache(instrptr,name)->simplename = simplegetter;
+			if(checkPropertyException(obj,name,prop,context->worker))
+				return;
+		}
 	}
 	RUNTIME_STACK_PUSH(context,prop);
 	++(context->exec_pos);
@@ -3329,12 +3646,15 @@ void ABCVm::abc_getPropertyStaticName_constant_localresult(call_context* context
 	asAtom obj= *instrptr->arg1_constant;
 	LOG_CALL( "getProperty_scl " << *name << ' ' << asAtomHandler::toDebugString(obj));
 	asAtom prop=asAtomHandler::invalidAtom;
-	bool canCache=false;
-	multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
-	if (simplegetter)
-		instrptr->cachedmultiname2 = simplegetter;
-	if(checkPropertyException(obj,name,prop,context->worker))
-		return;
+	if (!getPropertyInlineCached(context,instrptr,obj,name,prop))
+	{
+		bool canCache=false;
+		multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
+		if (simplegetter)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplegetter;
+		if(checkPropertyException(obj,name,prop,context->worker))
+			return;
+	}
 	replacelocalresult(context,instrptr->local3.pos,prop);
 	++(context->exec_pos);
 }
@@ -3359,13 +3679,16 @@ void ABCVm::abc_getPropertyStaticName_local_localresult(call_context* context)
 		LOG_CALL( "getProperty_sll " << *name << ' ' << asAtomHandler::toDebugString(CONTEXT_GETLOCAL(context,instrptr->local_pos1)));
 		asAtom obj = CONTEXT_GETLOCAL(context,instrptr->local_pos1);
 		asAtom prop=asAtomHandler::invalidAtom;
-		bool canCache=false;
-		multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
-		if (simplegetter)
-			instrptr->cachedmultiname2 = simplegetter;
-		LOG_CALL("getProperty_sll done " << *name << ' ' << asAtomHandler::toDebugString(obj)<<" "<<instrptr->local3.pos<<" "<<asAtomHandler::toDebugString(prop));
-		if(checkPropertyException(obj,name,prop,context->worker))
-			return;
+		if (!getPropertyInlineCached(context,instrptr,obj,name,prop))
+		{
+			bool canCache=false;
+			multiname* simplegetter = asAtomHandler::getVariableByMultiname(obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
+			if (simplegetter)
+				context->mi->body->getInlineCache(instrptr,name)->simplename = simplegetter;
+			LOG_CALL("getProperty_sll done " << *name << ' ' << asAtomHandler::toDebugString(obj)<<" "<<instrptr->local3.pos<<" "<<asAtomHandler::toDebugString(prop));
+			if(checkPropertyException(obj,name,prop,context->worker))
+				return;
+		}
 		replacelocalresult(context,instrptr->local3.pos,prop);
 	}
 	++(context->exec_pos);
@@ -3378,12 +3701,15 @@ void ABCVm::abc_getPropertyStaticName_localresult(call_context* context)
 	RUNTIME_STACK_POP_CREATE(context,obj);
 	LOG_CALL( "getProperty_slr " << *name << ' ' << asAtomHandler::toDebugString(*obj)<<" "<<instrptr->local3.pos);
 	asAtom prop=asAtomHandler::invalidAtom;
-	bool canCache=false;
-	multiname* simplegetter = asAtomHandler::getVariableByMultiname(*obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
-	if (simplegetter)
-		instrptr->cachedmultiname2 = simplegetter;
-	if(checkPropertyException(*obj,name,prop,context->worker))
-		return;
+	if (!getPropertyInlineCached(context,instrptr,*obj,name,prop))
+	{
+		bool canCache=false;
+		multiname* simplegetter = asAtomHandler::getVariableByMultiname(*obj,prop,*name,context->worker,canCache,GET_VARIABLE_OPTION::NONE);
+		if (simplegetter)
+			context->mi->body->getInlineCache(instrptr,name)->simplename = simplegetter;
+		if(checkPropertyException(*obj,name,prop,context->worker))
+			return;
+	}
 	replacelocalresult(context,instrptr->local3.pos,prop);
 	ASATOM_DECREF(*obj);
 	++(context->exec_pos);
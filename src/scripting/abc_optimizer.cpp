@@ -1354,15 +1354,6 @@ void ABCVm::optimizeFunction(SyntheticFunction* function)
 				curBlock->pushStack(Class<ASString>::getClass(sys));
 				break;
 			}
-			case 0x73:
-			{
-				//convert_i
-				out << (uint8_t)opcode;
-
-				curBlock->popStack(1);
-				curBlock->pushStack(Class<Integer>::getClass(sys));
-				break;
-			}
 			case 0x74:
 			{
 				//convert_u
@@ -1666,6 +1657,10 @@ void ABCVm::optimizeFunction(SyntheticFunction* function)
 				code >> t;
 				break;
 			}
+			case 0x73:
+				//convert_i, not implemented in the fast interpreter
+				//every instruction that is written to optimizedcode has to be executable by
+				//executeFunctionFast, the method is preloaded instead of failing halfway through
 			default:
 				LOG(LOG_ERROR,"Not optimizable instruction @" << code.tellg());
 				LOG(LOG_ERROR,"dump " << hex << (unsigned int)opcode << dec);
@@ -1677,10 +1672,11 @@ void ABCVm::optimizeFunction(SyntheticFunction* function)
 
 	//The original exception ranges must be translated to one
 	//or more exception ranges as the blocks have been reordered
-	uint32_t originalExceptionSize=mi->body->exceptions.size();
+	mi->body->optimizedexceptions=mi->body->exceptions;
+	uint32_t originalExceptionSize=mi->body->optimizedexceptions.size();
 	for(uint32_t i=0;i<originalExceptionSize;i++)
 	{
-		exception_info_abc* ei=&mi->body->exceptions[i];
+		exception_info_abc* ei=&mi->body->optimizedexceptions[i];
 		//Find out where the exception begins
 		uint32_t excStart = ei->from;
 		assert(instructionsMap.find(ei->target)!=instructionsMap.end());
@@ -1703,9 +1699,9 @@ void ABCVm::optimizeFunction(SyntheticFunction* function)
 			{
 				//Duplicate the exception
 				ei->to = lastRealEnd;
-				mi->body->exceptions.push_back(*ei);
+				mi->body->optimizedexceptions.push_back(*ei);
 				//Careful! ei is invalidated by now!
-				ei=&mi->body->exceptions.back();
+				ei=&mi->body->optimizedexceptions.back();
 				ei->from = it->second.realStart;
 			}
 			lastRealEnd = it->second.realEnd;
@@ -1753,7 +1749,7 @@ void ABCVm::optimizeFunction(SyntheticFunction* function)
 			(void) predScopeStackTypes;
 		}
 	}
-	//Overwrite the old code
-	mi->body->code=out.str();
+	//Keep the original code, it is needed when the method is preloaded
+	mi->body->optimizedcode=out.str();
 	mi->body->codeStatus = method_body_info::OPTIMIZED;
 }
@@ -409,4 +409,6 @@ method_body_info::~method_body_info()
 {
 	if (localsinitialvalues)
 		delete[] localsinitialvalues;
+	for (auto it = inlinecaches.begin(); it != inlinecaches.end(); it++)
+		delete *it;
 }
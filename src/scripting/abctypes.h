@@ -312,10 +312,30 @@ struct localconstantslot
 	uint32_t local_pos;
 	uint32_t slot_number;
 };
+// polymorphic inline cache of a getproperty/setproperty site with a static name
+// it remembers the slot of the property for up to INLINECACHE_SIZE receiver classes
+#define INLINECACHE_SIZE 4
+struct inlinecache_entry
+{
+	uint32_t classUniqueID; // Class_base::uniqueID of the receiver class
+	uint32_t slot; // 0-based index into the slots of the receiver
+};
+struct property_inlinecache
+{
+	inlinecache_entry entries[INLINECACHE_SIZE];
+	// name of the property at this site, the entries are only valid for this name
+	multiname* name;
+	// simple getter/setter name found by the slow path, used instead of name on the next slow lookup
+	multiname* simplename;
+	uint32_t count;
+	uint32_t hits;
+	uint32_t misses;
+	property_inlinecache(multiname* n):name(n),simplename(nullptr),count(0),hits(0),misses(0) {}
+};
 
 struct method_body_info
 {
-	method_body_info():localresultcount(0),hit_count(0),codeStatus(ORIGINAL),localsinitialvalues(nullptr){}
+	method_body_info():localresultcount(0),hit_count(0),codeStatus(ORIGINAL),notOptimizable(false),localsinitialvalues(nullptr){}
 	~method_body_info();
 	u30 method;
 	u30 max_stack;
@@ -333,11 +353,28 @@ struct method_body_info
 	//The code status
 	enum CODE_STATUS { ORIGINAL = 0, USED, OPTIMIZED, JITTED, PRELOADING, PRELOADED };
 	CODE_STATUS codeStatus;
+	// set if optimizeFunction rejected the method (e.g. an instruction the fast interpreter doesn't implement), it is always preloaded then
+	bool notOptimizable;
 	// list of local/slot pairs that were optimized away
 	std::vector<localconstantslot> localconstantslots;
 	std::vector<preloadedcodedata> preloadedcode;
+	// code and exception ranges rewritten by ABCVm::optimizeFunction for the fast interpreter,
+	// only used until the method is hot enough to be preloaded
+	std::string optimizedcode;
+	std::vector<exception_info_abc> optimizedexceptions;
 	asAtom* localsinitialvalues;
+	// inline caches of the property access sites, indexed by position in preloadedcode and created on first use
+	std::vector<property_inlinecache*> inlinecaches;
 	inline uint16_t getReturnValuePos() const { return returnvaluepos; }
+	property_inlinecache* getInlineCache(const preloadedcodedata* instrptr, multiname* name)
+	{
+		uint32_t pos = instrptr-preloadedcode.data();
+		if (pos >= inlinecaches.size())
+			inlinecaches.resize(preloadedcode.size(),nullptr);
+		if (inlinecaches[pos]==nullptr)
+			inlinecaches[pos] = new property_inlinecache(name);
+		return inlinecaches[pos];
+	}
 };
 
 std::istream& operator>>(std::istream& in, u8& v);
@@ -34,6 +34,7 @@ class ASObject;
 class Class_base;
 union asAtom;
 class SyntheticFunction;
+class ByteArray;
 
 struct scope_entry
 {
@@ -49,6 +50,12 @@ public:
 	std::vector<scope_entry> scope;
 };
 struct variable;
+// raw view of the ByteArray used as domain memory, see call_context::getDomainMemory
+struct domainmemoryview
+{
+	uint8_t* base;
+	uint32_t length;
+};
 struct call_context
 {
 	asAtom* locals;
@@ -75,13 +82,26 @@ struct call_context
 	 */
 	uint32_t defaultNamespaceUri;
 	ASObject* exceptionthrown;
+	/* buffer and length of the domain memory used by the alchemy opcodes, resolved on first access during a call.
+	 * They are valid as long as SystemState::domainMemoryGeneration is unchanged, it is incremented when the
+	 * domainMemory of an ApplicationDomain is reassigned and when a ByteArray used as domain memory changes its buffer */
+	domainmemoryview domainMemory;
+	const std::atomic<uint32_t>* domainMemoryGenerationSource;
+	uint32_t domainMemoryGeneration;
+	void resolveDomainMemory();
+	FORCE_INLINE const domainmemoryview& getDomainMemory()
+	{
+		if (USUALLY_FALSE(domainMemoryGenerationSource == nullptr || ACQUIRE_READ((*domainMemoryGenerationSource)) != domainMemoryGeneration))
+			resolveDomainMemory();
+		return domainMemory;
+	}
 	call_context(method_info* _mi):
 		locals(nullptr),stack(nullptr),
 		stackp(nullptr),exec_pos(nullptr),
 		max_stackp(nullptr),
 		parent_scope_stack(nullptr),curr_scope_stack(0),argarrayposition(-1),
 		scope_stack(nullptr),scope_stack_dynamic(nullptr),localslots(nullptr),mi(_mi),
-		function(nullptr),sys(nullptr),worker(nullptr),explicitConstruction(false),defaultNamespaceUri(0),exceptionthrown(nullptr)
+		function(nullptr),sys(nullptr),worker(nullptr),explicitConstruction(false),defaultNamespaceUri(0),exceptionthrown(nullptr),domainMemory{nullptr,0},domainMemoryGenerationSource(nullptr),domainMemoryGeneration(0)
 	{
 	}
 	static void handleError(int errorcode);
@@ -219,7 +219,7 @@ void AVM1Array::nextValue(asAtom& ret, uint32_t index)
 	}
 }
 
-void AVM1Array::AVM1enumerate(std::stack<asAtom>& stack)
+void AVM1Array::AVM1enumerate(AVM1Stack& stack)
 {
 	for (auto it = name_enumeration.begin(); it != name_enumeration.end(); it++)
 	{
@@ -60,7 +60,7 @@ public:
 	uint32_t nextNameIndex(uint32_t cur_index) override;
 	void nextName(asAtom &ret, uint32_t index) override;
 	void nextValue(asAtom &ret, uint32_t index) override;
-	void AVM1enumerate(std::stack<asAtom>& stack) override;
+	void AVM1enumerate(AVM1Stack& stack) override;
 };
 
 }
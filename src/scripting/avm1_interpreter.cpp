@@ -33,36 +33,322 @@
 using namespace std;
 using namespace lightspark;
 
-void ACTIONRECORD::PushStack(std::stack<asAtom> &stack, const asAtom &a)
+void ACTIONRECORD::PushStack(AVM1Stack &stack, const asAtom &a)
 {
 	stack.push(a);
 }
 
-asAtom ACTIONRECORD::PopStack(std::stack<asAtom>& stack)
+asAtom ACTIONRECORD::PopStack(AVM1Stack& stack)
 {
 	if (stack.empty())
 		return asAtomHandler::undefinedAtom;
-	asAtom ret = stack.top();
-	stack.pop();
-	return ret;
+	return stack.pop();
 }
-asAtom ACTIONRECORD::PeekStack(std::stack<asAtom>& stack)
+asAtom ACTIONRECORD::PeekStack(AVM1Stack& stack)
 {
 	if (stack.empty())
 		throw RunTimeException("AVM1: empty stack");
-	return stack.top();
+	return stack.peek();
+}
+namespace
+{
+// helpers for reading action operands, reads beyond the end of the action list return 0
+inline uint8_t readActionU8(const uint8_t* data, uint32_t size, uint32_t& p)
+{
+	uint8_t ret = p < size ? data[p] : 0;
+	p++;
+	return ret;
+}
+inline uint16_t readActionU16(const uint8_t* data, uint32_t size, uint32_t& p)
+{
+	uint16_t ret = readActionU8(data,size,p);
+	return ret | (readActionU8(data,size,p)<<8);
+}
+inline tiny_string readActionString(const uint8_t* data, uint32_t size, uint32_t& p)
+{
+	uint32_t start = p;
+	while (p < size && data[p])
+		p++;
+	tiny_string ret(start < size ? std::string((const char*)data+start,p-start) : std::string());
+	p++;
+	return ret;
+}
+}
+
+AVM1DecodedActions* ACTIONRECORD::decodeActions(SystemState* sys, const uint8_t* data, uint32_t size, uint32_t startactionpos, AVM1DecodedActions* decoded)
+{
+	if (!decoded)
+	{
+		decoded = new AVM1DecodedActions();
+		// the first entry marks the end of the action list
+		AVM1Action end;
+		end.pos=size;
+		end.next=AVM1DecodedActions::END_INDEX;
+		end.target=AVM1DecodedActions::END_INDEX;
+		end.data=0;
+		end.data2=0;
+		end.opcode=0;
+		decoded->actions.push_back(end);
+		decoded->positions[size]=AVM1DecodedActions::END_INDEX;
+	}
+	enum BRANCH_KIND { BRANCH_TARGET, BRANCH_CATCH, BRANCH_CATCHEND };
+	struct branch
+	{
+		uint32_t index;
+		uint32_t pos;
+		BRANCH_KIND kind;
+	};
+	std::vector<branch> branches;
+	std::vector<uint32_t> pending;
+	pending.push_back(startactionpos);
+	while (!pending.empty())
+	{
+		uint32_t pos = pending.back();
+		pending.pop_back();
+		uint32_t previous = UINT32_MAX;
+		while (pos < size && decoded->positions.find(pos) == decoded->positions.end())
+		{
+			uint32_t index = decoded->actions.size();
+			if (previous != UINT32_MAX)
+				decoded->actions[previous].next = index;
+			decoded->positions[pos]=index;
+			AVM1Action action;
+			action.pos = pos;
+			action.next = AVM1DecodedActions::END_INDEX;
+			action.target = AVM1DecodedActions::END_INDEX;
+			action.data = 0;
+			action.data2 = 0;
+			action.opcode = data[pos];
+			uint32_t p = pos+1;
+			uint32_t len = 0;
+			if (action.opcode > 0x80)
+				len = readActionU16(data,size,p);
+			uint32_t operandstart = p;
+			switch (action.opcode)
+			{
+				case 0x81: // ActionGotoFrame
+					action.data = readActionU16(data,size,p);
+					break;
+				case 0x87: // ActionStoreRegister
+					action.data = readActionU8(data,size,p);
+					decoded->registercount = max(decoded->registercount,action.data+1);
+					break;
+				case 0x8d: // ActionWaitForFrame2
+				case 0x9a: // ActionGetURL2
+					action.data = readActionU8(data,size,p);
+					break;
+				case 0x83: // ActionGetURL
+					action.data = decoded->strings.size();
+					decoded->strings.push_back(readActionString(data,size,p));
+					decoded->strings.push_back(readActionString(data,size,p));
+					break;
+				case 0x88: // ActionConstantPool
+				{
+					action.data = decoded->stringids.size();
+					action.data2 = readActionU16(data,size,p);
+					for (uint32_t i = 0; i < action.data2; i++)
+						decoded->stringids.push_back(sys->getUniqueStringId(readActionString(data,size,p)));
+					break;
+				}
+				case 0x8a: // ActionWaitForFrame
+					action.data = readActionU16(data,size,p);
+					action.data2 = readActionU8(data,size,p);
+					break;
+				case 0x8b: // ActionSetTarget
+				case 0x8c: // ActionGotoLabel
+					action.data = decoded->strings.size();
+					decoded->strings.push_back(readActionString(data,size,p));
+					break;
+				case 0x8e: // ActionDefineFunction2
+				case 0x9b: // ActionDefineFunction
+				{
+					AVM1FunctionDefinition f;
+					f.isDefineFunction2 = action.opcode == 0x8e;
+					f.name = readActionString(data,size,p);
+					uint32_t paramcount = readActionU16(data,size,p);
+					f.flags1 = 0;
+					f.flags2 = 0;
+					uint32_t registercount = 0;
+					if (f.isDefineFunction2)
+					{
+						registercount = readActionU8(data,size,p);
+						f.flags1 = readActionU8(data,size,p);
+						f.flags2 = readActionU8(data,size,p);
+					}
+					for (uint16_t i=0; i < paramcount; i++)
+					{
+						if (f.isDefineFunction2)
+							f.registernumbers.push_back(readActionU8(data,size,p));
+						f.paramnames.push_back(sys->getUniqueStringId(readActionString(data,size,p).lowercase()));
+					}
+					uint32_t codesize = readActionU16(data,size,p);
+					if (p+codesize > size)
+					{
+						LOG(LOG_ERROR,"AVM1: function code exceeds action list:"<<f.name<<" "<<codesize<<" "<<p<<" "<<size);
+						codesize = p < size ? size-p : 0;
+					}
+					f.body = _MNR(decodeActions(sys,data+p,codesize,0));
+					f.body->registercount = max(f.body->registercount,registercount);
+					p += codesize;
+					action.data = decoded->functions.size();
+					decoded->functions.push_back(f);
+					break;
+				}
+				case 0x8f: // ActionTry
+				{
+					AVM1TryBlock t;
+					bool catchInRegister = readActionU8(data,size,p)&0x04;
+					t.trysize = readActionU16(data,size,p);
+					t.catchsize = readActionU16(data,size,p);
+					t.finallysize = readActionU16(data,size,p);
+					t.reg=UINT8_MAX;
+					t.nameID = BUILTIN_STRINGS::EMPTY;
+					if (catchInRegister)
+					{
+						t.reg = readActionU8(data,size,p);
+						decoded->registercount = max(decoded->registercount,uint32_t(t.reg)+1);
+					}
+					else
+					{
+						t.name = readActionString(data,size,p);
+						if (!t.name.empty())
+							t.nameID = sys->getUniqueStringId(t.name.lowercase());
+					}
+					t.startpos = p;
+					t.catchindex = AVM1DecodedActions::END_INDEX;
+					t.endindex = AVM1DecodedActions::END_INDEX;
+					action.data = decoded->tryblocks.size();
+					decoded->tryblocks.push_back(t);
+					branches.push_back({action.data,p+t.trysize,BRANCH_CATCH});
+					branches.push_back({action.data,p+t.trysize+t.catchsize,BRANCH_CATCHEND});
+					pending.push_back(p+t.trysize);
+					pending.push_back(p+t.trysize+t.catchsize);
+					break;
+				}
+				case 0x94: // ActionWith
+				{
+					uint32_t codesize = readActionU16(data,size,p);
+					branches.push_back({index,p+codesize,BRANCH_TARGET});
+					pending.push_back(p+codesize);
+					break;
+				}
+				case 0x96: // ActionPush
+				{
+					action.data = decoded->pushvalues.size();
+					while (p < operandstart+len)
+					{
+						AVM1PushValue v;
+						v.type = readActionU8(data,size,p);
+						v.value = 0;
+						v.number = 0;
+						switch (v.type)
+						{
+							case 0:
+								v.value = sys->getUniqueStringId(readActionString(data,size,p));
+								break;
+							case 1:
+							{
+								FLOAT f;
+								if (p+4 <= size)
+									f.read(data+p);
+								p+=4;
+								v.number = f;
+								break;
+							}
+							case 4:
+								v.value = readActionU8(data,size,p);
+								decoded->registercount = max(decoded->registercount,v.value+1);
+								break;
+							case 5:
+							case 8:
+								v.value = readActionU8(data,size,p);
+								break;
+							case 6:
+							{
+								DOUBLE d;
+								if (p+8 <= size)
+									d.read(data+p);
+								p+=8;
+								v.number = d;
+								break;
+							}
+							case 7:
+								v.value = p+4 <= size ? GUINT32_FROM_LE(*(uint32_t*)(data+p)) : 0;
+								p+=4;
+								break;
+							case 9:
+								v.value = readActionU16(data,size,p);
+								break;
+							default:
+								break;
+						}
+						decoded->pushvalues.push_back(v);
+						action.data2++;
+					}
+					break;
+				}
+				case 0x99: // ActionJump
+				case 0x9d: // ActionIf
+				{
+					int32_t skip = int16_t(readActionU16(data,size,p));
+					int64_t target = int64_t(p)+skip;
+					if (target < 0 || target > size)
+					{
+						LOG(LOG_ERROR,"AVM1: invalid skip target:"<<hex<<(int)action.opcode<<dec<<" "<< skip<<" "<<p<<" "<<size);
+						target = target < 0 ? 0 : size;
+					}
+					branches.push_back({index,uint32_t(target),BRANCH_TARGET});
+					pending.push_back(uint32_t(target));
+					break;
+				}
+				case 0x9f: // ActionGotoFrame2
+				{
+					action.data = readActionU8(data,size,p);
+					if (action.data&0x02) // biasflag
+						action.data2 = readActionU16(data,size,p);
+					break;
+				}
+				default:
+					// actions without operands or not implemented, skip all operand bytes
+					p += len;
+					break;
+			}
+			decoded->actions.push_back(action);
+			previous = index;
+			pos = p;
+		}
+		if (previous != UINT32_MAX)
+			decoded->actions[previous].next = decoded->getIndex(pos);
+	}
+	for (auto it = branches.begin(); it != branches.end(); it++)
+	{
+		switch (it->kind)
+		{
+			case BRANCH_TARGET:
+				decoded->actions[it->index].target = decoded->getIndex(it->pos);
+				break;
+			case BRANCH_CATCH:
+				decoded->tryblocks[it->index].catchindex = decoded->getIndex(it->pos);
+				break;
+			case BRANCH_CATCHEND:
+				decoded->tryblocks[it->index].endindex = decoded->getIndex(it->pos);
+				break;
+		}
+	}
+	return decoded;
 }
-struct tryCatchBlock
+
+AVM1DecodedActions* AVM1ActionList::getDecoded(SystemState* sys, uint32_t startactionpos) const
 {
-	uint16_t trysize;
-	uint16_t catchsize;
-	uint16_t finallysize;
-	uint8_t reg=UINT8_MAX;
-	tiny_string name;
-	uint32_t startpos;
-};
+	if (decoded.isNull())
+		decoded = _MNR(ACTIONRECORD::decodeActions(sys,bytes.data(),bytes.size(),startactionpos));
+	else if (!bytes.empty() && decoded->positions.find(startactionpos) == decoded->positions.end())
+		ACTIONRECORD::decodeActions(sys,bytes.data(),bytes.size(),startactionpos,decoded.getPtr());
+	return decoded.getPtr();
+}
+
 Mutex executeactionmutex;
-void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, const std::vector<uint8_t> &actionlist, uint32_t startactionpos, std::map<uint32_t, asAtom> &scopevariables, bool fromInitAction, asAtom* result, asAtom* obj, asAtom *args, uint32_t num_args, const std::vector<uint32_t>& paramnames, const std::vector<uint8_t>& paramregisternumbers,
+void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, const AVM1ActionList &actionlist, uint32_t startactionpos, std::map<uint32_t, asAtom> &scopevariables, bool fromInitAction, asAtom* result, asAtom* obj, asAtom *args, uint32_t num_args, const std::vector<uint32_t>& paramnames, const std::vector<uint8_t>& paramregisternumbers,
 								  bool preloadParent, bool preloadRoot, bool suppressSuper, bool preloadSuper, bool suppressArguments, bool preloadArguments, bool suppressThis, bool preloadThis, bool preloadGlobal, AVM1Function *caller, AVM1Function *callee, Activation_object *actobj, asAtom *superobj)
 {
 	Locker l(executeactionmutex);
@@ -88,9 +374,17 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 	LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" executeActions "<<preloadParent<<preloadRoot<<suppressSuper<<preloadSuper<<suppressArguments<<preloadArguments<<suppressThis<<preloadThis<<preloadGlobal<<" "<<startactionpos<<" "<<num_args);
 	if (result)
 		asAtomHandler::setUndefined(*result);
-	std::stack<asAtom> stack;
-	asAtom registers[256];
-	std::fill_n(registers,256,asAtomHandler::undefinedAtom);
+	AVM1DecodedActions* decoded = actionlist.getDecoded(clip->getSystemState(),startactionpos);
+	// keep the decoded actions alive during execution, the action list may be destroyed by the executed actions
+	decoded->incRef();
+	_R<AVM1DecodedActions> decodedref = _MR(decoded);
+	AVM1Stack stack(wrk->AVM1operandStack);
+	// the register file only has to hold the registers used by the action list, the preloaded registers and the parameter registers
+	uint32_t registercount = max(decoded->registercount,uint32_t(8));
+	for (auto it = paramregisternumbers.begin(); it != paramregisternumbers.end(); it++)
+		registercount = max(registercount,uint32_t(*it)+1);
+	asAtom* registers = g_newa(asAtom, registercount);
+	std::fill_n(registers,registercount,asAtomHandler::undefinedAtom);
 	std::map<uint32_t,asAtom> locals;
 	if (caller)
 		caller->filllocals(locals);
@@ -99,8 +393,8 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 	asAtom* scopestack = g_newa(asAtom, maxdepth);
 	scopestack[0] = obj ? *obj : asAtomHandler::fromObject(clip);
 	ASATOM_INCREF(scopestack[0]);
-	std::vector<uint8_t>::const_iterator* scopestackstop = g_newa(std::vector<uint8_t>::const_iterator, maxdepth);
-	scopestackstop[0] = actionlist.end();
+	uint32_t* scopestackstop = g_newa(uint32_t, maxdepth);
+	scopestackstop[0] = AVM1DecodedActions::END_INDEX;
 	uint32_t currRegister = 1; // spec is not clear, but gnash starts at register 1
 	if (!suppressThis || preloadThis)
 	{
@@ -205,14 +499,14 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			registers[paramregisternumbers[i]] = args[i];
 		}
 	}
-	std::vector<tryCatchBlock> trycatchblocks;
+	std::vector<AVM1TryBlock> trycatchblocks;
 	bool inCatchBlock = false;
 
 	Array* argarray = nullptr;
 	DisplayObject *originalclip = clip;
-	auto it = actionlist.begin()+startactionpos;
-	auto tryblockstart = actionlist.end();
-	while (it != actionlist.end())
+	uint32_t ip = decoded->getIndex(startactionpos);
+	uint32_t tryblockstart = UINT32_MAX;
+	while (ip != AVM1DecodedActions::END_INDEX)
 	{
 		if (!(context->actionsExecuted % 2000))
 		{
@@ -228,18 +522,17 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				);
 			}
 		}
-		if (tryblockstart!= actionlist.end())
+		if (tryblockstart != UINT32_MAX)
 		{
-			tryCatchBlock trycatchblock = trycatchblocks.back();
+			const AVM1TryBlock& trycatchblock = trycatchblocks.back();
 			if (context->exceptionthrown)
 			{
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<int(it-actionlist.begin())<< " exception caught: action code:"<<hex<<(int)*it<<" "<<dec<<context->exceptionthrown->toDebugString());
-				it = tryblockstart + trycatchblock.trysize;
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<decoded->actions[ip].pos<< " exception caught: action code:"<<hex<<(int)decoded->actions[ip].opcode<<" "<<dec<<context->exceptionthrown->toDebugString());
+				ip = trycatchblock.catchindex;
 				if (!trycatchblock.name.empty())
 				{
-					uint32_t nameID = clip->getSystemState()->getUniqueStringId(trycatchblock.name.lowercase());
-					ASATOM_DECREF(locals[nameID]);
-					locals[nameID] = asAtomHandler::fromObject(context->exceptionthrown);
+					ASATOM_DECREF(locals[trycatchblock.nameID]);
+					locals[trycatchblock.nameID] = asAtomHandler::fromObject(context->exceptionthrown);
 				}
 				else if(trycatchblock.reg != UINT8_MAX)
 				{
@@ -251,24 +544,24 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				context->exceptionthrown=nullptr;
 				inCatchBlock=true;
 			}
-			else if (it > tryblockstart + trycatchblock.trysize)
+			else if (decoded->actions[ip].pos > tryblockstart + trycatchblock.trysize)
 			{
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<int(it-actionlist.begin())<< " end of try block: action code:"<<hex<<(int)*it);
-				if (!inCatchBlock && it < tryblockstart + trycatchblock.trysize + trycatchblock.catchsize)
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<decoded->actions[ip].pos<< " end of try block: action code:"<<hex<<(int)decoded->actions[ip].opcode);
+				if (!inCatchBlock && decoded->actions[ip].pos < tryblockstart + trycatchblock.trysize + trycatchblock.catchsize)
 				{
-					it = tryblockstart + trycatchblock.trysize + trycatchblock.catchsize; // skip catchblock
-					LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<int(it-actionlist.begin())<< " skip catch block("<<trycatchblock.catchsize<<") action code:"<<hex<<(int)*it);
+					ip = trycatchblock.endindex; // skip catchblock
+					LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<decoded->actions[ip].pos<< " skip catch block("<<trycatchblock.catchsize<<") action code:"<<hex<<(int)decoded->actions[ip].opcode);
 				}
 				inCatchBlock=false;
 				trycatchblocks.pop_back();
 				if (!trycatchblocks.empty())
-					tryblockstart = actionlist.begin()+ trycatchblocks.back().startpos;
+					tryblockstart = trycatchblocks.back().startpos;
 				else
-					tryblockstart = actionlist.end();
+					tryblockstart = UINT32_MAX;
 			}
 			// TODO special handling for finally block necessary?
 		}
-		while (curdepth > 0 && it == scopestackstop[curdepth])
+		while (curdepth > 0 && ip == scopestackstop[curdepth])
 		{
 			LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" end with "<<asAtomHandler::toDebugString(scopestack[curdepth]));
 			if (asAtomHandler::is<DisplayObject>(scopestack[curdepth]))
@@ -277,22 +570,23 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			curdepth--;
 			Log::calls_indent--;
 		}
+		// copy the action, as the decoded actions may be extended by nested executions
+		AVM1Action action = decoded->actions[ip];
+		ip = action.next;
 		if (!clip
-				&& *it != 0x20 // ActionSetTarget2
-				&& *it != 0x8b // ActionSetTarget
+				&& action.opcode != 0x20 // ActionSetTarget2
+				&& action.opcode != 0x8b // ActionSetTarget
 				)
 		{
 			// we are in a target that was not found during ActionSetTarget(2), so these actions are ignored
 			continue;
 		}
-		LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<int(it-actionlist.begin())<< " action code:"<<hex<<(int)*it<<dec<<" "<<clip->toDebugString());
-		uint8_t opcode = *it++;
-		if (opcode > 0x80)
-			it+=2; // skip length
+		LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<< " "<<action.pos<< " action code:"<<hex<<(int)action.opcode<<dec<<" "<<clip->toDebugString());
+		uint8_t opcode = action.opcode;
 		switch (opcode)
 		{
 			case 0x00:
-				it = actionlist.end(); // force quit loop;
+				ip = AVM1DecodedActions::END_INDEX; // force quit loop;
 				break;
 			case 0x04: // ActionNextFrame
 			{
@@ -1057,9 +1351,9 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				{
 					ASATOM_DECREF(obj);
 				}
-				if (tryblockstart == actionlist.end())
+				if (tryblockstart == UINT32_MAX)
 				{
-					it = actionlist.end(); // force quit loop;
+					ip = AVM1DecodedActions::END_INDEX; // force quit loop;
 				}
 				break;
 			}
@@ -1323,7 +1617,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				if (result)
 					*result = PopStack(stack);
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionReturn ");
-				it = actionlist.end();
+				ip = AVM1DecodedActions::END_INDEX;
 				break;
 			}
 			case 0x3f: // ActionModulo
@@ -2019,7 +2313,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionCallMethod done "<<asAtomHandler::toDebugString(name)<<" "<<numargs<<" "<<asAtomHandler::toDebugString(scriptobject)<<" result:"<<asAtomHandler::toDebugString(ret));
 				if (context->exceptionthrown)
 				{
-					if (tryblockstart== actionlist.end())
+					if (tryblockstart == UINT32_MAX)
 					{
 						context->exceptionthrown->decRef();
 						context->exceptionthrown=nullptr;
@@ -2248,17 +2542,15 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 					LOG(LOG_ERROR,"AVM1:"<<clip->getTagID()<<" no MovieClip for ActionGotoFrame "<<clip->toDebugString());
 					break;
 				}
-				uint32_t frame = uint32_t(*it++) | ((*it++)<<8);
+				uint32_t frame = action.data;
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionGotoFrame "<<frame);
 				clip->as<MovieClip>()->AVM1gotoFrame(frame,true,!clip->as<MovieClip>()->state.stop_FP,false);
 				break;
 			}
 			case 0x83: // ActionGetURL
 			{
-				tiny_string s1((const char*)&(*it));
-				it += s1.numBytes()+1;
-				tiny_string s2((const char*)&(*it));
-				it += s2.numBytes()+1;
+				const tiny_string& s1 = decoded->strings[action.data];
+				const tiny_string& s2 = decoded->strings[action.data+1];
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionGetURL "<<s1<<" "<<s2);
 				clip->getSystemState()->openPageInBrowser(s1,s2);
 				break;
@@ -2267,7 +2559,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			{
 				asAtom a = PeekStack(stack);
 				ASATOM_INCREF(a);
-				uint8_t num = *it++;
+				uint8_t num = action.data;
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionStoreRegister "<<(int)num<<" "<<asAtomHandler::toDebugString(a));
 				ASATOM_DECREF(registers[num]);
 				registers[num] = a;
@@ -2275,14 +2567,10 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x88: // ActionConstantPool
 			{
-				uint32_t c = uint32_t(*it++) | ((*it++)<<8);
+				uint32_t c = action.data2;
 				context->AVM1ClearConstants();
 				for (uint32_t i = 0; i < c; i++)
-				{
-					tiny_string s((const char*)&(*it),true);
-					it += s.numBytes()+1;
-					context->AVM1AddConstant(clip->getSystemState()->getUniqueStringId(s));
-				}
+					context->AVM1AddConstant(decoded->stringids[action.data+i]);
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionConstantPool "<<c);
 				break;
 			}
@@ -2293,31 +2581,26 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 					LOG(LOG_ERROR,"AVM1:"<<clip->getTagID()<<" no MovieClip for ActionWaitForFrame "<<clip->toDebugString());
 					break;
 				}
-				uint32_t frame = uint32_t(*it++) | ((*it++)<<8);
-				uint32_t skipcount = (uint32_t)(*it++);
+				uint32_t frame = action.data;
+				uint32_t skipcount = action.data2;
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionWaitForFrame "<<frame<<"/"<<clip->as<MovieClip>()->getFramesLoaded()<<" skip "<<skipcount);
 				if (clip->as<MovieClip>()->getFramesLoaded() <= frame && !clip->as<MovieClip>()->hasFinishedLoading())
 				{
 					// frame not yet loaded, skip actions
-					while (skipcount && it != actionlist.end())
+					while (skipcount && ip != AVM1DecodedActions::END_INDEX)
 					{
-						if (*it++ > 0x80)
-						{
-							uint32_t c = uint32_t(*it++) | ((*it++)<<8);
-							it+=c;
-						}
+						ip = decoded->actions[ip].next;
 						skipcount--;
 					}
 				}
 				break;
 			}
 			case 0x08: // ActionToggleQuality
-				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF3 DoActionTag ActionToggleQuality "<<hex<<(int)*it);
+				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF3 DoActionTag ActionToggleQuality "<<hex<<(int)opcode);
 				break;
 			case 0x8b: // ActionSetTarget
 			{
-				tiny_string s((const char*)&(*it));
-				it += s.numBytes()+1;
+				tiny_string s = decoded->strings[action.data];
 				if (!clip)
 				{
 					LOG_CALL("AVM1: ActionSetTarget: setting target from undefined value to "<<s);
@@ -2347,19 +2630,17 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 					LOG(LOG_ERROR,"AVM1:"<<clip->getTagID()<<" no MovieClip for ActionGotoLabel "<<clip->toDebugString());
 					break;
 				}
-				tiny_string s((const char*)&(*it));
-				it += s.numBytes()+1;
+				const tiny_string& s = decoded->strings[action.data];
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionGotoLabel "<<s);
 				clip->as<MovieClip>()->AVM1gotoFrameLabel(s,true,true);
 				break;
 			}
 			case 0x8e: // ActionDefineFunction2
 			{
-				tiny_string name((const char*)&(*it),true);
-				it += name.numBytes()+1;
-				uint32_t paramcount = uint32_t(*it++) | ((*it++)<<8);
-				*it++; //register count not used
-				uint8_t flags = *it++;
+				const AVM1FunctionDefinition& def = decoded->functions[action.data];
+				const tiny_string& name = def.name;
+				uint32_t paramcount = def.paramnames.size();
+				uint8_t flags = def.flags1;
 				bool flag1 = flags&0x80;//PreloadParent
 				bool flag2 = flags&0x40;//PreloadRoot
 				bool flag3 = flags&0x20;//SuppressSuper
@@ -2368,24 +2649,12 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				bool flag6 = flags&0x04;//PreloadArguments
 				bool flag7 = flags&0x02;//SuppressThis
 				bool flag8 = flags&0x01;//PreloadThis
-				bool flag9 = (*it++)&0x01;//PreloadGlobal
-				std::vector<uint32_t> funcparamnames;
-				std::vector<uint8_t> registernumber;
-				for (uint16_t i=0; i < paramcount; i++)
-				{
-					uint8_t regnum = *it++;
-					tiny_string n((const char*)&(*it),true);
-					it += n.numBytes()+1;
-					funcparamnames.push_back(clip->getSystemState()->getUniqueStringId(n.lowercase()));
-					registernumber.push_back(regnum);
-				}
-				uint32_t codesize = uint32_t(*it++) | ((*it++)<<8);
-				vector<uint8_t> code;
-				code.assign(it,it+codesize);
-				it += codesize;
+				bool flag9 = def.flags2&0x01;//PreloadGlobal
+				std::vector<uint32_t> funcparamnames = def.paramnames;
+				AVM1ActionList code(def.body);
 				Activation_object* act = name == "" ? new_activationObject(wrk) : nullptr;
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionDefineFunction2 "<<name<<" "<<paramcount<<" "<<flag1<<flag2<<flag3<<flag4<<flag5<<flag6<<flag7<<flag8<<flag9<<" "<<codesize<<" "<<act);
-				AVM1Function* f = Class<IFunction>::getAVM1Function(wrk,clip,act,context,funcparamnames,code,registernumber,flag1, flag2, flag3, flag4, flag5, flag6, flag7, flag8, flag9);
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionDefineFunction2 "<<name<<" "<<paramcount<<" "<<flag1<<flag2<<flag3<<flag4<<flag5<<flag6<<flag7<<flag8<<flag9<<" "<<act);
+				AVM1Function* f = Class<IFunction>::getAVM1Function(wrk,clip,act,context,funcparamnames,code,def.registernumbers,flag1, flag2, flag3, flag4, flag5, flag6, flag7, flag8, flag9);
 				//Create the prototype object
 				f->prototype = _MR(new_asobject(f->getSystemState()->worker));
 				f->prototype->addStoredMember();
@@ -2411,17 +2680,14 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			case 0x94: // ActionWith
 			{
 				asAtom obj = PopStack(stack);
-				uint32_t codesize = uint32_t(*it++) | ((*it++)<<8);
-				auto itend = it;
-				itend+=codesize;
 				if (curdepth >= maxdepth)
 				{
-					it = itend;
+					ip = action.target;
 					LOG(LOG_ERROR,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionWith depth exceeds maxdepth");
 					break;
 				}
 				Log::calls_indent++;
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionWith "<<codesize<<" "<<asAtomHandler::toDebugString(obj));
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionWith "<<decoded->actions[action.target].pos<<" "<<asAtomHandler::toDebugString(obj));
 				++curdepth;
 				if (clip_isTarget)
 					clip->decRef();
@@ -2430,36 +2696,27 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 					clip = asAtomHandler::as<DisplayObject>(obj);
 				ASATOM_INCREF(obj);
 				scopestack[curdepth] = obj;
-				scopestackstop[curdepth] = itend;
+				scopestackstop[curdepth] = action.target;
 				break;
 			}
 			case 0x96: // ActionPush
 			{
-				uint32_t len = ((*(it-1))<<8) | (*(it-2));
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush start:"<<len);
-				while (len > 0)
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush start:"<<action.data2);
+				for (uint32_t i = action.data; i < action.data+action.data2; i++)
 				{
-					uint8_t type = *it++;
-					len--;
-					switch (type)
+					const AVM1PushValue& v = decoded->pushvalues[i];
+					switch (v.type)
 					{
 						case 0:
 						{
-							tiny_string val((const char*)&(*it),true);
-							len -= val.numBytes()+1;
-							it += val.numBytes()+1;
-							asAtom a = asAtomHandler::fromStringID(clip->getSystemState()->getUniqueStringId(val));
+							asAtom a = asAtomHandler::fromStringID(v.value);
 							PushStack(stack,a);
 							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 0 "<<asAtomHandler::toDebugString(a));
 							break;
 						}
 						case 1:
 						{
-							FLOAT f;
-							f.read((const uint8_t*)&(*it));
-							it+=4;
-							len-=4;
-							asAtom a = asAtomHandler::fromNumber(wrk,f,false);
+							asAtom a = asAtomHandler::fromNumber(wrk,v.number,false);
 							PushStack(stack,a);
 							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 1 "<<asAtomHandler::toDebugString(a));
 							break;
@@ -2474,8 +2731,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 							break;
 						case 4:
 						{
-							uint32_t reg = *it++;
-							len--;
+							uint32_t reg = v.value;
 							asAtom a = registers[reg];
 							ASATOM_INCREF(a);
 							PushStack(stack,a);
@@ -2484,53 +2740,36 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 						}
 						case 5:
 						{
-							asAtom a = asAtomHandler::fromBool((bool)*it++);
-							len--;
+							asAtom a = asAtomHandler::fromBool((bool)v.value);
 							PushStack(stack,a);
 							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 5 "<<asAtomHandler::toDebugString(a));
 							break;
 						}
 						case 6:
 						{
-							DOUBLE d;
-							d.read((const uint8_t*)&(*it));
-							it+=8;
-							len-=8;
-							asAtom a = asAtomHandler::fromNumber(wrk,d,false);
+							asAtom a = asAtomHandler::fromNumber(wrk,v.number,false);
 							PushStack(stack,a);
 							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 6 "<<asAtomHandler::toDebugString(a));
 							break;
 						}
 						case 7:
 						{
-							uint32_t d=GUINT32_FROM_LE(*(uint32_t*)&(*it));
-							it+=4;
-							len-=4;
-							asAtom a = asAtomHandler::fromInt((int32_t)d);
+							asAtom a = asAtomHandler::fromInt((int32_t)v.value);
 							PushStack(stack,a);
 							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 7 "<<asAtomHandler::toDebugString(a));
 							break;
 						}
 						case 8:
-						{
-							uint32_t index = (*it++);
-							len--;
-							asAtom a = context->AVM1GetConstant(index);
-							PushStack(stack,a);
-							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 8 "<<index<<" "<<asAtomHandler::toDebugString(a));
-							break;
-						}
 						case 9:
 						{
-							uint32_t index = uint32_t(*it++) | ((*it++)<<8);
-							len-=2;
+							uint32_t index = v.value;
 							asAtom a = context->AVM1GetConstant(index);
 							PushStack(stack,a);
-							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush 9 "<<index<<" "<<asAtomHandler::toDebugString(a));
+							LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionPush "<<(int)v.type<<" "<<index<<" "<<asAtomHandler::toDebugString(a));
 							break;
 						}
 						default:
-							LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF4 DoActionTag push type "<<(int)type);
+							LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF4 DoActionTag push type "<<(int)v.type);
 							break;
 					}
 				}
@@ -2538,27 +2777,15 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x99: // ActionJump
 			{
-				int32_t skip = int16_t((*it++) | ((*it++)<<8));
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionJump "<<skip<<" "<< (it-actionlist.begin()));
-				if (skip < 0 && it-actionlist.begin() < -skip)
-				{
-					LOG(LOG_ERROR,"ActionJump: invalid skip target:"<< skip<<" "<<(it-actionlist.begin())<<" "<<actionlist.size());
-					it = actionlist.begin();
-				}
-				if (skip >=0 && skip + (it-actionlist.begin()) > (int)actionlist.size())
-				{
-					LOG(LOG_ERROR,"ActionJump: invalid skip target:"<< skip<<" "<<(it-actionlist.begin())<<" "<<actionlist.size());
-					it = actionlist.end();
-				}
-				else
-					it+= skip;
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionJump "<<decoded->actions[action.target].pos<<" "<<action.pos);
+				ip = action.target;
 				break;
 			}
 			case 0x9a: // ActionGetURL2
 			{
 				asAtom at=PopStack(stack);
 				asAtom au=PopStack(stack);
-				uint8_t b = *it++;
+				uint8_t b = action.data;
 				uint8_t method = b&0xc0>>6;
 				bool loadtarget = b&0x02;
 				bool loadvars = b&0x01;
@@ -2593,20 +2820,11 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x9b: // ActionDefineFunction
 			{
-				tiny_string name((const char*)&(*it),true);
-				it += name.numBytes()+1;
-				uint32_t paramcount = uint32_t(*it++) | ((*it++)<<8);
-				std::vector<uint32_t> paramnames;
-				for (uint16_t i=0; i < paramcount; i++)
-				{
-					tiny_string n((const char*)&(*it),true);
-					it += n.numBytes()+1;
-					paramnames.push_back(clip->getSystemState()->getUniqueStringId(n.lowercase()));
-				}
-				uint32_t codesize = uint32_t(*it++) | ((*it++)<<8);
-				vector<uint8_t> code;
-				code.assign(it,it+codesize);
-				it += codesize;
+				const AVM1FunctionDefinition& def = decoded->functions[action.data];
+				const tiny_string& name = def.name;
+				uint32_t paramcount = def.paramnames.size();
+				std::vector<uint32_t> paramnames = def.paramnames;
+				AVM1ActionList code(def.body);
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionDefineFunction "<<name<<" "<<paramcount);
 				Activation_object* act = name == "" ? new_activationObject(wrk) : nullptr;
 				AVM1Function* f = Class<IFunction>::getAVM1Function(wrk,clip,act,context,paramnames,code);
@@ -2634,23 +2852,11 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x9d: // ActionIf
 			{
-				int32_t skip = int16_t((*it++) | ((*it++)<<8));
 				asAtom a = PopStack(stack);
-				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionIf "<<asAtomHandler::toDebugString(a)<<" "<<skip);
+				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionIf "<<asAtomHandler::toDebugString(a)<<" "<<decoded->actions[action.target].pos);
 				if (asAtomHandler::AVM1toBool(a,wrk,clip->loadedFrom->version))
 				{
-					if (skip < 0 && it-actionlist.begin() < -skip)
-					{
-						LOG(LOG_ERROR,"ActionIf: invalid skip target:"<< skip<<" "<<(it-actionlist.begin())<<" "<<actionlist.size());
-						it = actionlist.begin();
-					}
-					if (skip >=0 && skip + (it-actionlist.begin()) > (int)actionlist.size())
-					{
-						LOG(LOG_ERROR,"ActionIf: invalid skip target:"<< skip<<" "<<(it-actionlist.begin())<<" "<<actionlist.size());
-						it = actionlist.end();
-					}
-					else
-						it += skip;
+					ip = action.target;
 				}
 				ASATOM_DECREF(a);
 				break;
@@ -2680,12 +2886,8 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x9f: // ActionGotoFrame2
 			{
-				bool biasflag = (*it)&0x02;
-				bool playflag = (*it)&0x01;
-				it++;
-				uint32_t biasframe = 0;
-				if (biasflag)
-					biasframe = uint32_t(*it++) | ((*it++)<<8);
+				bool playflag = action.data&0x01;
+				uint32_t biasframe = action.data2;
 
 				asAtom a = PopStack(stack);
 				if (!clip->is<MovieClip>())
@@ -2716,8 +2918,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x8d: // ActionWaitForFrame2
 			{
-				uint32_t skipcount= (*it);
-				it++;
+				uint32_t skipcount= action.data;
 				asAtom a = PopStack(stack);
 				if (!clip->is<MovieClip>())
 				{
@@ -2738,14 +2939,9 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				if (clip->as<MovieClip>()->getFramesLoaded() <= frame && !clip->as<MovieClip>()->hasFinishedLoading())
 				{
 					// frame not yet loaded, skip actions
-					while (skipcount && it != actionlist.end())
+					while (skipcount && ip != AVM1DecodedActions::END_INDEX)
 					{
-						it++;
-						if (*it > 0x80)
-						{
-							uint32_t c = uint32_t(*it++) | ((*it++)<<8);
-							it+=c;
-						}
+						ip = decoded->actions[ip].next;
 						skipcount--;
 					}
 				}
@@ -2754,26 +2950,12 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			}
 			case 0x8f: // ActionTry
 			{
-				bool catchInRegister = (*it)&0x04;
-				it++;
-				tryCatchBlock trycatchblock;
-				trycatchblock.trysize = uint16_t(*it++) | ((*it++)<<8);
-				trycatchblock.catchsize = uint16_t(*it++) | ((*it++)<<8);
-				trycatchblock.finallysize = uint16_t(*it++) | ((*it++)<<8);
-				trycatchblock.reg=UINT8_MAX;
-				if (catchInRegister)
-					trycatchblock.reg = *it++;
-				else
-				{
-					trycatchblock.name = tiny_string((const char*)&(*it),true);
-					it += trycatchblock.name.numBytes()+1;
-				}
-				trycatchblock.startpos=it-actionlist.begin();
+				const AVM1TryBlock& trycatchblock = decoded->tryblocks[action.data];
 				LOG_CALL("AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionTry "<<trycatchblock.name<<" "<<(int)trycatchblock.reg<<" "<<trycatchblock.trysize<<"/"<<trycatchblock.catchsize<<"/"<<trycatchblock.finallysize);
 				if (trycatchblock.finallysize)
 					LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" ActionTry with finallysize:"<<trycatchblock.name<<" "<<(int)trycatchblock.reg<<" "<<trycatchblock.trysize<<"/"<<trycatchblock.catchsize<<"/"<<trycatchblock.finallysize);
 				trycatchblocks.push_back(trycatchblock);
-				tryblockstart = it;
+				tryblockstart = trycatchblock.startpos;
 				break;
 			}
 			case 0x33: // ActionAsciiToChar
@@ -2803,11 +2985,6 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 			case 0x36: // ActionMBCharToAscii
 			case 0x37: // ActionMBAsciiToChar
 				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF4 DoActionTag "<<hex<<(int)opcode);
-				if(opcode >= 0x80)
-				{
-					uint32_t len = ((*(it-1))<<8) | (*(it-2));
-					it+=len;
-				}
 				break;
 			case 0x45: // ActionTargetPath
 				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF5 DoActionTag "<<hex<<(int)opcode);
@@ -2817,11 +2994,6 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 				break;
 			case 0x2c: // ActionImplementsOp
 				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" SWF7 DoActionTag "<<hex<<(int)opcode);
-				if(opcode >= 0x80)
-				{
-					uint32_t len = ((*(it-1))<<8) | (*(it-2));
-					it+=len;
-				}
 				break;
 			default:
 				LOG(LOG_NOT_IMPLEMENTED,"AVM1:"<<clip->getTagID()<<" "<<(clip->is<MovieClip>() ? clip->as<MovieClip>()->state.FP : 0)<<" invalid DoActionTag "<<hex<<(int)opcode);
@@ -2838,7 +3010,7 @@ void ACTIONRECORD::executeActions(DisplayObject *clip, AVM1context* context, con
 	{
 		ASATOM_DECREF(it->second);
 	}
-	for (uint32_t i = 0; i < 256; i++)
+	for (uint32_t i = 0; i < registercount; i++)
 	{
 		ASATOM_DECREF(registers[i]);
 	}
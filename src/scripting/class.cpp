@@ -87,7 +87,7 @@ Activation_object* lightspark::new_activationObject(ASWorker* wrk)
 }
 
 
-Class_inherit::Class_inherit(const QName& name, MemoryAccount* m, const traits_info *_classtrait, Global *_global):Class_base(name, UINT32_MAX,m),tag(nullptr),bindedToRoot(false),bindingchecked(false),inScriptInit(false),classtrait(_classtrait)
+Class_inherit::Class_inherit(const QName& name, MemoryAccount* m, const traits_info *_classtrait, Global *_global):Class_base(name, UINT32_MAX,m),tag(nullptr),bindedToRoot(false),bindingchecked(false),inScriptInit(false),classtrait(_classtrait),instanceSlotCount(0)
 {
 	this->global=_global;
 	this->incRef(); //create on reference for the classes map
@@ -231,7 +231,9 @@ void Class_inherit::setupDeclaredTraits(ASObject *target, bool checkclone)
 			//HACK: suppress implementation handling of variables just now
 			bool bak=target->implEnable;
 			target->implEnable=false;
+			target->Variables.reserveSlots(instanceSlotCount);
 			recursiveBuild(target);
+			instanceSlotCount = target->Variables.slotcount;
 			
 			//And restore it
 			target->implEnable=bak;
@@ -55,6 +55,9 @@ private:
 	void recursiveBuild(ASObject* target) const;
 	const traits_info* classtrait;
 	_NR<ASObject> instancefactory;
+	// number of slots of the declared traits of an instance, known after the first instance was built
+	// it is only used to pre-size variables_map::slots_vars of later instances
+	uint32_t instanceSlotCount;
 	asfreelist freelist;
 public:
 	Class_inherit(const QName& name, MemoryAccount* m,const traits_info* _classtrait, Global* _global);
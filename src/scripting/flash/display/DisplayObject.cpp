@@ -250,6 +250,7 @@ bool DisplayObject::destruct()
 	avm1mouselistenercount=0;
 	avm1framelistenercount=0;
 	filters.reset();
+	cachedSurface->softwareFilters.clear();
 	legacy=false;
 	markedForLegacyDeletion=false;
 	cacheAsBitmap=false;
@@ -295,6 +296,7 @@ void DisplayObject::prepareShutdown()
 		scalingGrid->prepareShutdown();
 	if (filters)
 		filters->prepareShutdown();
+	cachedSurface->softwareFilters.clear();
 	if (scrollRect)
 		scrollRect->prepareShutdown();
 	for (auto it = avm1variables.begin(); it != avm1variables.end(); it++)
@@ -902,6 +904,7 @@ void DisplayObject::setupSurfaceState(IDrawable* d)
 			{
 				FilterData fdata;
 				asAtomHandler::as<BitmapFilter>(f)->getRenderFilterGradientColors(fdata.gradientcolors);
+				asAtomHandler::as<BitmapFilter>(f)->getRenderFilterBitmap(fdata.bitmapdata,fdata.bitmapwidth,fdata.bitmapheight);
 				uint32_t step = 0;
 				while (true)
 				{
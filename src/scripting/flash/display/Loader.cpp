@@ -154,9 +154,14 @@ void LoaderThread::execute()
 		}
 		if (res != loader->getSystemState()->mainClip)
 		{
-			res->incRef();
-			loader->incRef();
-			getVm(loader->getSystemState())->addBufferEvent(NullRef,_MR(new (loader->getSystemState()->unaccountedMemory) SetLoaderContentEvent(_MR(res), _MR(loader))));
+			// every loaded clip is already set as content by ParseThread::publishContent at its first ShowFrame, including clips with a single frame
+			// only content without a ShowFrame (images and clips without frames) is set here
+			if (!local_pt.hasPublishedContent())
+			{
+				res->incRef();
+				loader->incRef();
+				getVm(loader->getSystemState())->addBufferEvent(NullRef,_MR(new (loader->getSystemState()->unaccountedMemory) SetLoaderContentEvent(_MR(res), _MR(loader))));
+			}
 			getVm(loader->getSystemState())->addEvent(NullRef, _MR(new (loader->getSystemState()->unaccountedMemory) FlushEventBufferEvent(false,true)));
 		}
 	}
@@ -310,8 +310,17 @@ void LoaderInfo::sendInit()
 	loadStatus=INIT_SENT;
 	checkSendComplete();
 }
+void LoaderInfo::setContentParsed()
+{
+	Locker l(spinlock);
+	checkSendComplete();
+}
+
 void LoaderInfo::checkSendComplete()
 {
+	// clips are set as content after their first frame, so they may still be parsed when "init" is sent
+	if (content && content->is<RootMovieClip>() && !content->as<RootMovieClip>()->hasFinishedLoading())
+		return;
 	if(loadStatus==INIT_SENT && bytesTotal && bytesLoaded==bytesTotal)
 	{
 		//The clip is also complete now
@@ -100,6 +100,8 @@ public:
 	void resetState();
 	void setFrameRate(number_t f) { frameRate=f; }
 	void setComplete();
+	// called by the ParseThread when the content has been parsed completely, "complete" is not sent before that
+	void setContentParsed();
 	void setContent(DisplayObject* c);
 	bool fillBytesData(ByteArray* data);
 };
@@ -261,8 +261,20 @@ IDrawable* TokenContainer::invalidate(SMOOTH_MODE smoothing, bool fromgraphics,
 	}
 	MATRIX matrix = owner->getMatrix();
 	bool isMask=false;
+	Rectangle* r = owner->scalingGrid.getPtr();
+	if (!r && owner->getParent())
+		r = owner->getParent()->scalingGrid.getPtr();
+	bool useNanoVG = owner->getSystemState()->getEngineData()->nvgcontext && !r;
+	number_t scalex = matrix.getScaleX();
+	number_t scaley = matrix.getScaleY();
+	if (!useNanoVG && RasterCache::isCacheable(tokens))
+	{
+		// rasterize at the scale of the bucket, so the raster can be reused for similar scales
+		scalex = RasterCache::quantizeScale(scalex);
+		scaley = RasterCache::quantizeScale(scaley);
+	}
 	MATRIX m;
-	m.scale(matrix.getScaleX(),matrix.getScaleY());
+	m.scale(scalex,scaley);
 	owner->computeBoundsForTransformedRect(bxmin,bxmax,bymin,bymax,x,y,width,height,m);
 
 	if (isnan(width) || isnan(height))
@@ -278,10 +290,6 @@ IDrawable* TokenContainer::invalidate(SMOOTH_MODE smoothing, bool fromgraphics,
 	if (owner->colorTransform)
 		ct = *owner->colorTransform.getPtr();
 	
-	Rectangle* r = owner->scalingGrid.getPtr();
-	if (!r && owner->getParent())
-		r = owner->getParent()->scalingGrid.getPtr();
-	
 	number_t regpointx = 0.0;
 	number_t regpointy = 0.0;
 	if (fromgraphics)
@@ -290,9 +298,7 @@ IDrawable* TokenContainer::invalidate(SMOOTH_MODE smoothing, bool fromgraphics,
 		regpointx=bxmin;
 		regpointy=bymin;
 	}
-	if (owner->getSystemState()->getEngineData()->nvgcontext
-		&& !r
-		)
+	if (useNanoVG)
 	{
 		renderWithNanoVG=true;
 		if (fromgraphics)
@@ -317,6 +323,7 @@ IDrawable* TokenContainer::invalidate(SMOOTH_MODE smoothing, bool fromgraphics,
 		ret->getState()->tokens.isGlyph = tokens.isGlyph;
 		ret->getState()->tokens.color = tokens.color;
 		ret->getState()->tokens.startMatrix = tokens.startMatrix;
+		ret->getState()->tokens.tessellation = tokens.tessellation;
 		ret->getState()->renderWithNanoVG = renderWithNanoVG;
 		owner->resetNeedsTextureRecalculation();
 		return ret;
@@ -329,7 +336,7 @@ IDrawable* TokenContainer::invalidate(SMOOTH_MODE smoothing, bool fromgraphics,
 	}
 	IDrawable* ret = new CairoTokenRenderer(tokens.filltokens,tokens.stroketokens,matrix
 				, x, y, ceil(width), ceil(height)
-				, matrix.getScaleX(), matrix.getScaleY()
+				, scalex, scaley
 				, isMask, owner->cacheAsBitmap
 				, scaling,owner->getConcatenatedAlpha()
 				, ct, smoothing ? SMOOTH_ANTIALIAS : SMOOTH_NONE,owner->getBlendMode(), regpointx, regpointy);
@@ -539,6 +546,7 @@ void TokenContainer::getTextureSize(TokenList& tokens, int *width, int *height)
 	if (lastindex != UINT32_MAX)
 	{
 		const FILLSTYLE* style=GeomToken(tokens[lastindex],false).fillStyle;
+		style->decodeBitmap();
 		if (style->bitmap.isNull())
 			return;
 		*width=style->bitmap->getWidth();
@@ -286,7 +286,7 @@ public:
 
 struct AVM1scriptToExecute
 {
-	const std::vector<uint8_t>* actions;
+	const AVM1ActionList* actions;
 	uint32_t startactionpos;
 	AVM1context* avm1context;
 	uint32_t event_name_id;
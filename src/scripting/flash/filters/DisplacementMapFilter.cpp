@@ -126,10 +126,57 @@ void DisplacementMapFilter::applyFilter(BitmapContainer* target, BitmapContainer
 	delete[] tmpdata;
 }
 
+// sets the mask of the color channel used for displacement in the shader
+static void getRenderChannelMask(float* args, uint32_t component)
+{
+	args[0]=component==BitmapDataChannel::RED ? 1.0 : 0.0;
+	args[1]=component==BitmapDataChannel::GREEN ? 1.0 : 0.0;
+	args[2]=component==BitmapDataChannel::BLUE ? 1.0 : 0.0;
+	args[3]=component==BitmapDataChannel::ALPHA ? 1.0 : 0.0;
+}
+
 void DisplacementMapFilter::getRenderFilterArgs(uint32_t step,float* args) const
 {
-	LOG(LOG_NOT_IMPLEMENTED,"getRenderFilterArgs not yet implemented for "<<this->toDebugString());
-	args[0]=0;
+	if (step != 0 || mapBitmap.isNull() || mapBitmap->getBitmapContainer().isNull() || mapBitmap->getBitmapContainer()->isEmpty())
+	{
+		args[0]=0;
+		return;
+	}
+	args[0]=float(FILTERSTEP_DISPLACEMENTMAP);
+	getRenderChannelMask(args+1,componentX);
+	getRenderChannelMask(args+5,componentY);
+	args[9]=scaleX;
+	args[10]=scaleY;
+	args[11]=mapPoint ? mapPoint->getX() : 0;
+	args[12]=mapPoint ? mapPoint->getY() : 0;
+	if (mode=="clamp")
+		args[13]=1;
+	else if (mode=="ignore")
+		args[13]=2;
+	else if (mode=="color")
+		args[13]=3;
+	else // "wrap"
+		args[13]=0;
+	RGBA c = RGBA(color,0);
+	args[14]=c.rf();
+	args[15]=c.gf();
+	args[16]=c.bf();
+	args[17]=alpha;
+	args[18]=mapBitmap->getWidth();
+	args[19]=mapBitmap->getHeight();
+}
+
+bool DisplacementMapFilter::getRenderFilterBitmap(std::vector<uint8_t>& data, uint32_t& width, uint32_t& height) const
+{
+	if (mapBitmap.isNull() || mapBitmap->getBitmapContainer().isNull() || mapBitmap->getBitmapContainer()->isEmpty())
+		return false;
+	_NR<BitmapContainer> map = mapBitmap->getBitmapContainer();
+	width = map->getWidth();
+	height = map->getHeight();
+	uint8_t* pixels = map->getRectangleData(RECT(0,width,0,height));
+	data.assign(pixels,pixels+width*height*4);
+	delete[] pixels;
+	return true;
 }
 
 void DisplacementMapFilter::prepareShutdown()
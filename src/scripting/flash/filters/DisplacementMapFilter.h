@@ -45,6 +45,7 @@ public:
 	void applyFilter(BitmapContainer* target, BitmapContainer* source, const RECT& sourceRect, number_t xpos, number_t ypos, number_t scalex, number_t scaley, DisplayObject* owner=nullptr) override;
 	bool compareFILTER(const FILTER& filter) const override { return false; }
 	void getRenderFilterArgs(uint32_t step,float* args) const override;
+	bool getRenderFilterBitmap(std::vector<uint8_t>& data, uint32_t& width, uint32_t& height) const override;
 	void prepareShutdown() override;
 };
 
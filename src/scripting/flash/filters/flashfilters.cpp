@@ -33,6 +33,7 @@
 #include "scripting/flash/display/BitmapData.h"
 #include "scripting/toplevel/Array.h"
 #include "backends/rendering.h"
+#include "platforms/boxblur.h"
 
 using namespace std;
 using namespace lightspark;
@@ -64,30 +65,6 @@ BitmapFilter* BitmapFilter::cloneImpl() const
 	return Class<BitmapFilter>::getInstanceS(getInstanceWorker());
 }
 
-// blur algorithm taken from haxe https://github.com/haxelime/lime/blob/develop/src/lime/_internal/graphics/StackBlur.hx
-int MUL_TABLE[] =
-{
-	1, 171, 205, 293, 57, 373, 79, 137, 241, 27, 391, 357, 41, 19, 283, 265, 497, 469, 443, 421, 25, 191, 365, 349, 335, 161, 155, 149, 9, 278, 269, 261,
-	505, 245, 475, 231, 449, 437, 213, 415, 405, 395, 193, 377, 369, 361, 353, 345, 169, 331, 325, 319, 313, 307, 301, 37, 145, 285, 281, 69, 271, 267,
-	263, 259, 509, 501, 493, 243, 479, 118, 465, 459, 113, 446, 55, 435, 429, 423, 209, 413, 51, 403, 199, 393, 97, 3, 379, 375, 371, 367, 363, 359, 355,
-	351, 347, 43, 85, 337, 333, 165, 327, 323, 5, 317, 157, 311, 77, 305, 303, 75, 297, 294, 73, 289, 287, 71, 141, 279, 277, 275, 68, 135, 67, 133, 33,
-	262, 260, 129, 511, 507, 503, 499, 495, 491, 61, 121, 481, 477, 237, 235, 467, 232, 115, 457, 227, 451, 7, 445, 221, 439, 218, 433, 215, 427, 425,
-	211, 419, 417, 207, 411, 409, 203, 202, 401, 399, 396, 197, 49, 389, 387, 385, 383, 95, 189, 47, 187, 93, 185, 23, 183, 91, 181, 45, 179, 89, 177, 11,
-	175, 87, 173, 345, 343, 341, 339, 337, 21, 167, 83, 331, 329, 327, 163, 81, 323, 321, 319, 159, 79, 315, 313, 39, 155, 309, 307, 153, 305, 303, 151,
-	75, 299, 149, 37, 295, 147, 73, 291, 145, 289, 287, 143, 285, 71, 141, 281, 35, 279, 139, 69, 275, 137, 273, 17, 271, 135, 269, 267, 133, 265, 33,
-	263, 131, 261, 130, 259, 129, 257, 1
-};
-int SHG_TABLE[] =
-{
-	0, 9, 10, 11, 9, 12, 10, 11, 12, 9, 13, 13, 10, 9, 13, 13, 14, 14, 14, 14, 10, 13, 14, 14, 14, 13, 13, 13, 9, 14, 14, 14, 15, 14, 15, 14, 15, 15, 14,
-	15, 15, 15, 14, 15, 15, 15, 15, 15, 14, 15, 15, 15, 15, 15, 15, 12, 14, 15, 15, 13, 15, 15, 15, 15, 16, 16, 16, 15, 16, 14, 16, 16, 14, 16, 13, 16,
-	16, 16, 15, 16, 13, 16, 15, 16, 14, 9, 16, 16, 16, 16, 16, 16, 16, 16, 16, 13, 14, 16, 16, 15, 16, 16, 10, 16, 15, 16, 14, 16, 16, 14, 16, 16, 14, 16,
-	16, 14, 15, 16, 16, 16, 14, 15, 14, 15, 13, 16, 16, 15, 17, 17, 17, 17, 17, 17, 14, 15, 17, 17, 16, 16, 17, 16, 15, 17, 16, 17, 11, 17, 16, 17, 16,
-	17, 16, 17, 17, 16, 17, 17, 16, 17, 17, 16, 16, 17, 17, 17, 16, 14, 17, 17, 17, 17, 15, 16, 14, 16, 15, 16, 13, 16, 15, 16, 14, 16, 15, 16, 12, 16,
-	15, 16, 17, 17, 17, 17, 17, 13, 16, 15, 17, 17, 17, 16, 15, 17, 17, 17, 16, 15, 17, 17, 14, 16, 17, 17, 16, 17, 17, 16, 15, 17, 16, 14, 17, 16, 15,
-	17, 16, 17, 17, 16, 17, 15, 16, 17, 14, 17, 16, 15, 17, 16, 17, 13, 17, 16, 17, 17, 16, 17, 14, 17, 16, 17, 16, 17, 16, 17, 9
-};
-
 void BitmapFilter::applyBlur(uint8_t* data, uint32_t width, uint32_t height, number_t blurx, number_t blury, int quality)
 {
 	int oX;
@@ -100,208 +77,8 @@ void BitmapFilter::applyBlur(uint8_t* data, uint32_t width, uint32_t height, num
 	blury*=sY;
 	int radiusX = int(round(blurx)) >> 1;
 	int radiusY = int(round(blury)) >> 1;
-	if (radiusX >= int(sizeof(MUL_TABLE)/sizeof(int)))
-		radiusX = sizeof(MUL_TABLE)/sizeof(int)-1;
-	if (radiusY >= int(sizeof(MUL_TABLE)/sizeof(int)))
-		radiusY = sizeof(MUL_TABLE)/sizeof(int)-1;
-	if (radiusX<=0 || radiusY <= 0)
-		return;
-
-	int iterations = quality;
-
-	uint8_t* px = data;
-	int x, y, i, p, yp, yi, yw;
-	int r, g, b, a, pr, pg, pb, pa;
-
-	int divx = (radiusX + radiusX + 1);
-	int divy = (radiusY + radiusY + 1);
-	int w = width;
-	int h = height;
-
-	int w1 = w - 1;
-	int h1 = h - 1;
-	int rxp1 = radiusX + 1;
-	int ryp1 = radiusY + 1;
-
-	std::vector<RGBA> ssx;
-	ssx.resize(divx);
-	std::vector<RGBA> ssy;
-	ssy.resize(divy);
-
-	int mtx = MUL_TABLE[radiusX];
-	int stx = SHG_TABLE[radiusX];
-	int mty = MUL_TABLE[radiusY];
-	int sty = SHG_TABLE[radiusY];
-
-	while (iterations > 0)
-	{
-		iterations--;
-		yw = yi = 0;
-		int ms = mtx;
-		int ss = stx;
-		y = h;
-		do
-		{
-			r = rxp1 * (pr = px[yi]);
-			g = rxp1 * (pg = px[yi + 1]);
-			b = rxp1 * (pb = px[yi + 2]);
-			a = rxp1 * (pa = px[yi + 3]);
-			auto sx = ssx.begin();
-			i = rxp1;
-			do
-			{
-				(*sx).Red = pr;
-				(*sx).Green = pg;
-				(*sx).Blue = pb;
-				(*sx).Alpha = pa;
-				sx++;
-				if (sx == ssx.end())
-					sx = ssx.begin();
-			}
-			while (--i > -1);
-			
-			for (i = 1; i < rxp1; i++)
-			{
-				p = yi + ((w1 < i ? w1 : i) << 2);
-				r += ((*sx).Red = px[p]);
-				g += ((*sx).Green = px[p + 1]);
-				b += ((*sx).Blue = px[p + 2]);
-				a += ((*sx).Alpha = px[p + 3]);
-				sx++;
-				if (sx == ssx.end())
-					sx = ssx.begin();
-			}
-			
-			auto si = ssx.begin();
-			for (x = 0; x < w; x++)
-			{
-				px[yi++] = uint32_t(r * ms) >> ss;
-				px[yi++] = uint32_t(g * ms) >> ss;
-				px[yi++] = uint32_t(b * ms) >> ss;
-				px[yi++] = uint32_t(a * ms) >> ss;
-				p = x + radiusX + 1;
-				p = (yw + (p < w1 ? p : w1)) << 2;
-				r -= (*si).Red;
-				r += ((*si).Red = px[p]);
-				g -= (*si).Green;
-				g += ((*si).Green = px[p + 1]);
-				b -= (*si).Blue;
-				b += ((*si).Blue = px[p + 2]);
-				a -= (*si).Alpha;
-				a += ((*si).Alpha = px[p + 3]);
-				si++;
-				if (si == ssx.end())
-					si = ssx.begin();
-			}
-			yw += w;
-		}
-		while (--y > 0);
-		
-		ms = mty;
-		ss = sty;
-		for (x = 0; x < w; x++)
-		{
-			yi = x << 2;
-			r = ryp1 * (pr = px[yi]);
-			g = ryp1 * (pg = px[yi + 1]);
-			b = ryp1 * (pb = px[yi + 2]);
-			a = ryp1 * (pa = px[yi + 3]);
-			auto sy = ssy.begin();
-			for (i = 0; i< ryp1; i++)
-			{
-				(*sy).Red = pr;
-				(*sy).Green = pg;
-				(*sy).Blue = pb;
-				(*sy).Alpha = pa;
-				sy++;
-				if (sy == ssy.end())
-					sy = ssy.begin();
-			}
-			yp = w;
-			for (i = 1; i < (radiusY + 1); i++)
-			{
-				yi = (yp + x) << 2;
-				r += ((*sy).Red = px[yi]);
-				g += ((*sy).Green = px[yi + 1]);
-				b += ((*sy).Blue = px[yi + 2]);
-				a += ((*sy).Alpha = px[yi + 3]);
-				sy++;
-				if (sy == ssy.end())
-					sy = ssy.begin();
-				if (i < h1)
-				{
-					yp += w;
-				}
-			}
-			yi = x;
-			auto si = ssy.begin();
-			
-			if (iterations > 0)
-			{
-				for (y = 0; y<h; y++)
-				{
-					p = yi << 2;
-					pa = uint32_t(a * ms) >> ss;
-					px[p + 3] = pa;
-					if (pa > 0)
-					{
-						px[p] = (uint32_t(r * ms) >> ss);
-						px[p + 1] = (uint32_t(g * ms) >> ss);
-						px[p + 2] = (uint32_t(b * ms) >> ss);
-					}
-					else
-					{
-						px[p] = px[p + 1] = px[p + 2] = 0;
-					}
-					p = y + ryp1;
-					p = (x + ((p < h1 ? p : h1) * w)) << 2;
-					r -= (*si).Red;
-					r += ((*si).Red = px[p]);
-					g -= (*si).Green;
-					g += ((*si).Green = px[p + 1]);
-					b -= (*si).Blue;
-					b += ((*si).Blue = px[p + 2]);
-					a -= (*si).Alpha;
-					a += ((*si).Alpha = px[p + 3]);
-					si++;
-					if (si == ssy.end())
-						si = ssy.begin();
-					yi += w;
-				}
-			}
-			else
-			{
-				for (y = 0; y < h; y++)
-				{
-					p = yi << 2;
-					px[p + 3] = pa = uint32_t(a * ms) >> ss;
-					if (pa > 0)
-					{
-						pr = (uint32_t(r * ms) >> ss);
-						pg = (uint32_t(g * ms) >> ss);
-						pb = (uint32_t(b * ms) >> ss);
-						px[p] = pr > 255 ? 255 : pr;
-						px[p + 1] = pg > 255 ? 255 : pg;
-						px[p + 2] = pb > 255 ? 255 : pb;
-					}
-					else
-					{
-						px[p] = px[p + 1] = px[p + 2] = 0;
-					}
-					p = y + ryp1;
-					p = (x + ((p < h1 ? p : h1) * w)) << 2;
-					r -= (*si).Red - ((*si).Red = px[p]);
-					g -= (*si).Green - ((*si).Green = px[p + 1]);
-					b -= (*si).Blue - ((*si).Blue = px[p + 2]);
-					a -= (*si).Alpha - ((*si).Alpha = px[p + 3]);
-					si++;
-					if (si == ssy.end())
-						si = ssy.begin();
-					yi += w;
-				}
-			}
-		}
-	}
+	// boxBlur clamps the radii to BOXBLUR_MAXRADIUS
+	boxBlur(data,width,height,radiusX,radiusY,quality);
 }
 
 uint32_t dropShadowPixel(uint32_t dstpixel, uint8_t tmpalpha, number_t strength, number_t alpha, uint32_t color, bool inner, bool knockout)
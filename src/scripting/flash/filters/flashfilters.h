@@ -22,10 +22,11 @@
 
 #include "compat.h"
 #include "asobject.h"
+#include <vector>
 
 namespace lightspark
 {
-enum FILTERSTEPS { FILTERSTEP_BLUR_HORIZONTAL=1,FILTERSTEP_BLUR_VERTICAL=2, FILTERSTEP_DROPSHADOW=3, FILTERSTEP_GRADIENT_GLOW=4, FILTERSTEP_BEVEL=5, FILTERSTEP_COLORMATRIX=6, FILTERSTEP_CONVOLUTION=7 };
+enum FILTERSTEPS { FILTERSTEP_BLUR_HORIZONTAL=1,FILTERSTEP_BLUR_VERTICAL=2, FILTERSTEP_DROPSHADOW=3, FILTERSTEP_GRADIENT_GLOW=4, FILTERSTEP_BEVEL=5, FILTERSTEP_COLORMATRIX=6, FILTERSTEP_CONVOLUTION=7, FILTERSTEP_DISPLACEMENTMAP=8 };
 class BitmapFilter: public ASObject
 {
 private:
@@ -52,6 +53,8 @@ public:
 	virtual void getRenderFilterArgs(uint32_t step, float* args) const;
 	// gradientcolors is array of 256*4 floats (RGBA values)
 	virtual void getRenderFilterGradientColors(float* gradientcolors) const;
+	// copies the BGRA pixels of an additional bitmap needed by the filter shader, returns false if there is none
+	virtual bool getRenderFilterBitmap(std::vector<uint8_t>& data, uint32_t& width, uint32_t& height) const { return false; }
 };
 
 class ShaderFilter: public BitmapFilter
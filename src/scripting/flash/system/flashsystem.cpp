@@ -371,6 +371,7 @@ ApplicationDomain::ApplicationDomain(ASWorker* wrk, Class_base* c, _NR<Applicati
 {
 	defaultDomainMemory->setLength(MIN_DOMAIN_MEMORY_LIMIT);
 	currentDomainMemory=defaultDomainMemory.getPtr();
+	currentDomainMemory->usedAsDomainMemory=true;
 }
 
 void ApplicationDomain::sinit(Class_base* c)
@@ -1051,6 +1052,9 @@ void ApplicationDomain::checkDomainMemory()
 		domainMemory->setLength(MIN_DOMAIN_MEMORY_LIMIT);
 	}
 	currentDomainMemory=domainMemory.getPtr();
+	currentDomainMemory->usedAsDomainMemory=true;
+	// running methods (on any worker) have cached the buffer of the previous domain memory, let them resolve it again
+	getSystemState()->invalidateDomainMemory();
 }
 
 LoaderContext::LoaderContext(ASWorker* wrk, Class_base* c):
@@ -1329,6 +1333,7 @@ ASWorker::ASWorker(SystemState* s):
 	limits.script_timeout = 20;
 	stacktrace = new stacktrace_entry[limits.max_recursion];
 	last_garbagecollection = compat_msectiming();
+	gcRunPending = false;
 	// start and end of gc list point to this to ensure that every added object gets a valid pointer set as its next/prev pointers
 	gcNext=this;
 	gcPrev=this;
@@ -1349,6 +1354,7 @@ ASWorker::ASWorker(Class_base* c):
 	stacktrace = new stacktrace_entry[limits.max_recursion];
 	loader = _MR(Class<Loader>::getInstanceS(this));
 	last_garbagecollection = compat_msectiming();
+	gcRunPending = false;
 	// start and end of gc list point to this to ensure that every added object gets a valid pointer set as its next/prev pointers
 	gcNext=this;
 	gcPrev=this;
@@ -1368,6 +1374,7 @@ ASWorker::ASWorker(ASWorker* wrk, Class_base* c):
 	stacktrace = new stacktrace_entry[limits.max_recursion];
 	loader = _MR(Class<Loader>::getInstanceS(this));
 	last_garbagecollection = compat_msectiming();
+	gcRunPending = false;
 	// start and end of gc list point to this to ensure that every added object gets a valid pointer set as its next/prev pointers
 	gcNext=this;
 	gcPrev=this;
@@ -1615,6 +1622,8 @@ void ASWorker::execute()
 		}
 	}
 	delete sbuf;
+	// the thread may be reused by the thread pool, so the memory cached for this worker is released here
+	sizeclass_release_thread_cache();
 }
 
 void ASWorker::jobFence()
@@ -1718,15 +1727,29 @@ void ASWorker::removeObjectFromGarbageCollector(ASObject* o)
 	o->gcNext=nullptr;
 	o->gcPrev=nullptr;
 }
+// interval between garbage collection runs in milliseconds
+#define GC_INTERVAL 10000
+// time in microseconds a not forced call of processGarbageCollection may spend on checking objects
+// if it is used up, the remaining objects are checked in the next call
+// the budget is only checked between the objects taken from the gc list: the cyclic reference check of a single
+// object walks its whole member graph without yielding, so a pause can exceed the budget by the time of one such walk
+#define GC_TIME_BUDGET 4000
 void ASWorker::processGarbageCollection(bool force)
 {
+	if (inGarbageCollection)
+		return;
 	uint64_t currtime = compat_msectiming();
 	int64_t diff =  currtime-last_garbagecollection;
-	if (!force && diff < 10000) // ony execute garbagecollection every 10 seconds
+	if (!force && !gcRunPending && diff < GC_INTERVAL) // ony execute garbagecollection every 10 seconds
 		return;
-	last_garbagecollection = currtime;
-	if (this->stage)
-		this->stage->cleanupDeadHiddenObjects();
+	uint64_t starttime = compat_usectiming();
+	if (!gcRunPending)
+	{
+		last_garbagecollection = currtime;
+		if (this->stage)
+			this->stage->cleanupDeadHiddenObjects();
+	}
+	gcRunPending=false;
 	inGarbageCollection=true;
 	bool hasEntries=this->gcNext && this->gcNext != this;
 	// use two loops to make sure objects added during inner loop are handled _after_ the inner loop is complete
@@ -1736,12 +1759,21 @@ void ASWorker::processGarbageCollection(bool force)
 		hasEntries=false;
 		while (ogc && ogc != this)
 		{
+			if (!force && compat_usectiming()-starttime > GC_TIME_BUDGET)
+			{
+				// the objects not yet checked stay in the list for the next call
+				gcRunPending=true;
+				hasEntries=false;
+				break;
+			}
 			ASObject* ogcnext = ogc->gcNext;
 			if (!ogc->deletedingarbagecollection)
 			{
 				this->removeObjectFromGarbageCollector(ogc);
 				ogc->markedforgarbagecollection = false;
-				if (ogc->handleGarbageCollection())
+				bool deleted = ogc->handleGarbageCollection(gcstate);
+				gcStats.objectsscanned += gcstate.startobj == ogc ? gcstate.checkedobjects.size() : 1;
+				if (deleted)
 				{
 					this->addObjectToGarbageCollector(ogc);
 					hasEntries=true;
@@ -1750,6 +1782,7 @@ void ASWorker::processGarbageCollection(bool force)
 			ogc = ogcnext;
 		}
 	}
+	gcstate.reset(nullptr);
 	inGarbageCollection=false;
 	// delete all objects that were destructed during gc
 	ASObject* ogc = this->gcNext;
@@ -1763,9 +1796,18 @@ void ASWorker::processGarbageCollection(bool force)
 			ogc->resetRefCount();
 			ogc->setConstant(false);
 			ogc->decRef();
+			gcStats.objectsfreed++;
 		}
 		ogc = ogcnext;
 	}
+	if (!gcRunPending)
+		gcStats.runs++;
+	gcStats.lastpause = compat_usectiming()-starttime;
+	gcStats.totalpause += gcStats.lastpause;
+	if (gcStats.lastpause > gcStats.maxpause)
+		gcStats.maxpause = gcStats.lastpause;
+	LOG(LOG_TRACE,"garbage collection: "<<gcStats.lastpause<<"us, "<<(gcRunPending ? "interrupted" : "complete")
+		<<", total scanned "<<gcStats.objectsscanned<<", freed "<<gcStats.objectsfreed<<", max pause "<<gcStats.maxpause<<"us");
 	if (force && this->gcNext && this->gcNext != this)
 		processGarbageCollection(true);
 }
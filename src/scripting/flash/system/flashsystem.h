@@ -177,39 +177,42 @@ public:
 	ASPROPERTY_GETTER_SETTER(_NR<ByteArray>, domainMemory);
 	ASPROPERTY_GETTER(_NR<ApplicationDomain>, parentDomain);
 	static void throwRangeError();
+	/* The alchemy opcode helpers get the raw domain memory from call_context::getDomainMemory(),
+	 * so they don't have to go through the ApplicationDomain and the ByteArray on every access.
+	 * It is fetched after the operands are converted, as the conversion may call into AS code that changes the domain memory */
 	template<class T>
-	T readFromDomainMemory(uint32_t addr)
+	static FORCE_INLINE T readFromDomainMemory(call_context* th, uint32_t addr)
 	{
-		if(currentDomainMemory->getLength() < (addr+sizeof(T)))
+		const domainmemoryview& dm = th->getDomainMemory();
+		if(dm.length < (addr+sizeof(T)))
 		{
 			throwRangeError();
 			return T(0);
 		}
-		uint8_t* buf=currentDomainMemory->getBufferNoCheck();
-		return *reinterpret_cast<T*>(buf+addr);
+		return *reinterpret_cast<T*>(dm.base+addr);
 	}
 	template<class T>
-	void writeToDomainMemory(uint32_t addr, T val)
+	static FORCE_INLINE void writeToDomainMemory(call_context* th, uint32_t addr, T val)
 	{
-		if(currentDomainMemory->getLength() < (addr+sizeof(T)))
+		const domainmemoryview& dm = th->getDomainMemory();
+		if(dm.length < (addr+sizeof(T)))
 		{
 			throwRangeError();
 			return;
 		}
-		uint8_t* buf=currentDomainMemory->getBufferNoCheck();
-		*reinterpret_cast<T*>(buf+addr)=val;
+		*reinterpret_cast<T*>(dm.base+addr)=val;
 	}
 	template<class T>
-	static void loadIntN(ApplicationDomain* appDomain,call_context* th)
+	static void loadIntN(call_context* th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		uint32_t addr=asAtomHandler::toUInt(*arg1);
-		T ret=appDomain->readFromDomainMemory<T>(addr);
+		T ret=readFromDomainMemory<T>(th,addr);
 		ASATOM_DECREF_POINTER(arg1);
 		RUNTIME_STACK_PUSH(th,asAtomHandler::fromInt(ret));
 	}
 	template<class T>
-	static void storeIntN(ApplicationDomain* appDomain,call_context* th)
+	static void storeIntN(call_context* th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		RUNTIME_STACK_POP_CREATE(th,arg2);
@@ -217,68 +220,68 @@ public:
 		ASATOM_DECREF_POINTER(arg1);
 		int32_t val=asAtomHandler::toInt(*arg2);
 		ASATOM_DECREF_POINTER(arg2);
-		appDomain->writeToDomainMemory<T>(addr, val);
+		writeToDomainMemory<T>(th, addr, val);
 	}
 	template<class T>
-	static FORCE_INLINE void loadIntN(ApplicationDomain* appDomain,asAtom& ret, asAtom& arg1)
+	static FORCE_INLINE void loadIntN(call_context* th,asAtom& ret, asAtom& arg1)
 	{
 		uint32_t addr=asAtomHandler::toUInt(arg1);
-		ByteArray* dm = appDomain->currentDomainMemory;
-		if(dm->getLength() < (addr+sizeof(T)))
+		const domainmemoryview& dm = th->getDomainMemory();
+		if(dm.length < (addr+sizeof(T)))
 		{
 			throwRangeError();
 			return;
 		}
-		ret = asAtomHandler::fromInt(*reinterpret_cast<T*>(dm->getBufferNoCheck()+addr));
+		ret = asAtomHandler::fromInt(*reinterpret_cast<T*>(dm.base+addr));
 	}
 	template<class T>
-	static FORCE_INLINE void storeIntN(ApplicationDomain* appDomain, asAtom& arg1, asAtom& arg2)
+	static FORCE_INLINE void storeIntN(call_context* th, asAtom& arg1, asAtom& arg2)
 	{
 		uint32_t addr=asAtomHandler::toUInt(arg1);
 		int32_t val=asAtomHandler::toInt(arg2);
-		ByteArray* dm = appDomain->currentDomainMemory;
-		if(dm->getLength() < (addr+sizeof(T)))
+		const domainmemoryview& dm = th->getDomainMemory();
+		if(dm.length < (addr+sizeof(T)))
 		{
 			throwRangeError();
 			return;
 		}
-		*reinterpret_cast<T*>(dm->getBufferNoCheck()+addr)=val;
+		*reinterpret_cast<T*>(dm.base+addr)=val;
 	}
 	
-	static FORCE_INLINE void loadFloat(ApplicationDomain* appDomain,call_context *th)
+	static FORCE_INLINE void loadFloat(call_context *th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		uint32_t addr=asAtomHandler::toUInt(*arg1);
-		number_t ret=appDomain->readFromDomainMemory<float>(addr);
+		number_t ret=readFromDomainMemory<float>(th,addr);
 		ASATOM_DECREF_POINTER(arg1);
-		RUNTIME_STACK_PUSH(th,asAtomHandler::fromNumber(appDomain->getInstanceWorker(),ret,false));
+		RUNTIME_STACK_PUSH(th,asAtomHandler::fromNumber(th->worker,ret,false));
 	}
-	static FORCE_INLINE void loadFloat(ApplicationDomain* appDomain,asAtom& ret, asAtom& arg1)
+	static FORCE_INLINE void loadFloat(call_context* th,asAtom& ret, asAtom& arg1)
 	{
 		uint32_t addr=asAtomHandler::toUInt(arg1);
-		number_t res=appDomain->readFromDomainMemory<float>(addr);
+		number_t res=readFromDomainMemory<float>(th,addr);
 		asAtom oldret = ret;
-		if (asAtomHandler::replaceNumber(ret,appDomain->getInstanceWorker(),res))
+		if (asAtomHandler::replaceNumber(ret,th->worker,res))
 			ASATOM_DECREF(oldret);
 	}
-	static FORCE_INLINE void loadDouble(ApplicationDomain* appDomain,call_context *th)
+	static FORCE_INLINE void loadDouble(call_context *th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		uint32_t addr=asAtomHandler::toUInt(*arg1);
-		number_t res=appDomain->readFromDomainMemory<double>(addr);
+		number_t res=readFromDomainMemory<double>(th,addr);
 		ASATOM_DECREF_POINTER(arg1);
-		RUNTIME_STACK_PUSH(th,asAtomHandler::fromNumber(appDomain->getInstanceWorker(),res,false));
+		RUNTIME_STACK_PUSH(th,asAtomHandler::fromNumber(th->worker,res,false));
 	}
-	static FORCE_INLINE void loadDouble(ApplicationDomain* appDomain,asAtom& ret, asAtom& arg1)
+	static FORCE_INLINE void loadDouble(call_context* th,asAtom& ret, asAtom& arg1)
 	{
 		uint32_t addr=asAtomHandler::toUInt(arg1);
-		number_t res=appDomain->readFromDomainMemory<double>(addr);
+		number_t res=readFromDomainMemory<double>(th,addr);
 		asAtom oldret = ret;
-		if (asAtomHandler::replaceNumber(ret,appDomain->getInstanceWorker(),res))
+		if (asAtomHandler::replaceNumber(ret,th->worker,res))
 			ASATOM_DECREF(oldret);
 	}
 
-	static FORCE_INLINE void storeFloat(ApplicationDomain* appDomain,call_context *th)
+	static FORCE_INLINE void storeFloat(call_context *th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		RUNTIME_STACK_POP_CREATE(th,arg2);
@@ -286,16 +289,16 @@ public:
 		ASATOM_DECREF_POINTER(arg1);
 		float val=(float)asAtomHandler::toNumber(*arg2);
 		ASATOM_DECREF_POINTER(arg2);
-		appDomain->writeToDomainMemory<float>(addr, val);
+		writeToDomainMemory<float>(th, addr, val);
 	}
-	static FORCE_INLINE void storeFloat(ApplicationDomain* appDomain, asAtom& arg1, asAtom& arg2)
+	static FORCE_INLINE void storeFloat(call_context* th, asAtom& arg1, asAtom& arg2)
 	{
 		number_t addr=asAtomHandler::toNumber(arg1);
 		float val=(float)asAtomHandler::toNumber(arg2);
-		appDomain->writeToDomainMemory<float>(addr, val);
+		writeToDomainMemory<float>(th, addr, val);
 	}
 
-	static FORCE_INLINE void storeDouble(ApplicationDomain* appDomain,call_context *th)
+	static FORCE_INLINE void storeDouble(call_context *th)
 	{
 		RUNTIME_STACK_POP_CREATE(th,arg1);
 		RUNTIME_STACK_POP_CREATE(th,arg2);
@@ -303,13 +306,13 @@ public:
 		ASATOM_DECREF_POINTER(arg1);
 		double val=asAtomHandler::toNumber(*arg2);
 		ASATOM_DECREF_POINTER(arg2);
-		appDomain->writeToDomainMemory<double>(addr, val);
+		writeToDomainMemory<double>(th, addr, val);
 	}
-	static FORCE_INLINE void storeDouble(ApplicationDomain* appDomain, asAtom& arg1, asAtom& arg2)
+	static FORCE_INLINE void storeDouble(call_context* th, asAtom& arg1, asAtom& arg2)
 	{
 		number_t addr=asAtomHandler::toNumber(arg1);
 		double val=asAtomHandler::toNumber(arg2);
-		appDomain->writeToDomainMemory<double>(addr, val);
+		writeToDomainMemory<double>(th, addr, val);
 	}
 	void checkDomainMemory();
 };
@@ -373,6 +376,19 @@ public:
 class WorkerDomain;
 class ParseThread;
 class Prototype;
+// statistics of the garbage collection of cyclic references of a worker
+struct gcstatistics
+{
+	uint64_t runs; // number of completed garbage collection runs
+	uint64_t objectsscanned; // number of objects visited while counting cyclic references
+	uint64_t objectsfreed;
+	// durations of the calls to ASWorker::processGarbageCollection in microseconds
+	// a pause is bounded by GC_TIME_BUDGET plus the cyclic reference check of one object, which is not interrupted
+	uint64_t lastpause;
+	uint64_t maxpause;
+	uint64_t totalpause;
+	gcstatistics():runs(0),objectsscanned(0),objectsfreed(0),lastpause(0),maxpause(0),totalpause(0) {}
+};
 class ASWorker: public EventDispatcher, public IThreadJob
 {
 friend class WorkerDomain;
@@ -395,6 +411,11 @@ private:
 	map<const Class_base*,_R<Prototype>> protoypeMap;
 	std::set<ASObject*> constantrefs;
 	uint64_t last_garbagecollection;
+	// state shared by all start objects of the garbage collection
+	garbagecollectorstate gcstate;
+	// indicates that the last garbage collection run was interrupted because its time budget was used up
+	bool gcRunPending;
+	gcstatistics gcStats;
 	std::vector<ABCContext*> contexts;
 public:
 	Stage* stage; // every worker has its own stage. In case of the primordial worker this points to the stage of the SystemState.
@@ -439,6 +460,7 @@ public:
 			--cur_recursion; //decrement current recursion depth
 	}
 	std::vector<AVM1context*> AVM1callStack;
+	AVM1StackArena AVM1operandStack;
 	uint8_t AVM1getSwfVersion() const
 	{
 		return AVM1callStack.empty() ? UINT8_MAX : AVM1callStack.back()->swfversion;
@@ -473,6 +495,7 @@ public:
 	void removeObjectFromGarbageCollector(ASObject* o);
 	void processGarbageCollection(bool force);
 	FORCE_INLINE bool isInGarbageCollection() const { return inGarbageCollection; }
+	const gcstatistics& getGCStatistics() const { return gcStats; }
 	inline bool inFinalization() const { return inFinalize; }
 	void registerConstantRef(ASObject* obj);
 	
@@ -45,7 +45,7 @@ using namespace lightspark;
 #define BA_MAX_SIZE 0x40000000
 
 ByteArray::ByteArray(ASWorker* wrk, Class_base* c, uint8_t* b, uint32_t l):ASObject(wrk,c,T_OBJECT,SUBTYPE_BYTEARRAY),littleEndian(false),objectEncoding(OBJECT_ENCODING::AMF3),currentObjectEncoding(OBJECT_ENCODING::AMF3),
-	position(0),bytes(b),real_len(l),len(l),shareable(false)
+	position(0),bytes(b),real_len(l),len(l),usedAsDomainMemory(false),shareable(false)
 {
 #ifdef MEMORY_USAGE_PROFILING
 	c->memoryAccount->addBytes(l);
@@ -78,6 +78,8 @@ bool ByteArray::destruct()
 	position = 0;
 	real_len = 0;
 	len = 0;
+	bufferChanged();
+	usedAsDomainMemory = false;
 	shareable = false;
 	littleEndian = false;
 	return ASObject::destruct();
@@ -174,6 +176,7 @@ uint8_t* ByteArray::getBufferIntern(unsigned int size, bool enableResize)
 #ifdef MEMORY_USAGE_PROFILING
 		getClass()->memoryAccount->addBytes(len);
 #endif
+		bufferChanged();
 	}
 	else if(enableResize==false)
 	{
@@ -199,14 +202,21 @@ uint8_t* ByteArray::getBufferIntern(unsigned int size, bool enableResize)
 			memset(bytes+prevLen,0,real_len-prevLen);
 		len=size;
 		bytes=bytes2;
+		bufferChanged();
 	}
 	else if(len<size)
 	{
 		len=size;
+		bufferChanged();
 	}
 	return bytes;
 }
 
+void ByteArray::invalidateDomainMemory()
+{
+	getSystemState()->invalidateDomainMemory();
+}
+
 ASFUNCTIONBODY_ATOM(ByteArray,_constructor)
 {
 }
@@ -313,6 +323,7 @@ void ByteArray::setLength(uint32_t newLen)
 		real_len = newLen;
 	}
 	len = newLen;
+	bufferChanged();
 	if (position > len)
 		position = (len > 0 ? len-1 : 0);
 }
@@ -1307,6 +1318,7 @@ void ByteArray::acquireBuffer(uint8_t* buf, int bufLen)
 	bytes=buf;
 	real_len=bufLen;
 	len=bufLen;
+	bufferChanged();
 #ifdef MEMORY_USAGE_PROFILING
 	getClass()->memoryAccount->addBytes(real_len);
 #endif
@@ -1546,6 +1558,7 @@ void ByteArray::uncompress_zlib(bool raw)
 	delete[] bytes;
 	bytes = bytes2;
 	memcpy(bytes, &buf[0], len);
+	bufferChanged();
 	position=0;
 }
 void ByteArray::compress_lzma()
@@ -1722,6 +1735,7 @@ ASFUNCTIONBODY_ATOM(ByteArray,clear)
 	th->bytes = nullptr;
 	th->len=0;
 	th->real_len=0;
+	th->bufferChanged();
 	th->position=0;
 	th->unlock();
 }
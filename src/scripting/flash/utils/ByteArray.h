@@ -43,6 +43,15 @@ protected:
 	uint8_t* bytes;
 	uint32_t real_len;
 	uint32_t len;
+	// set by ApplicationDomain once this is used as domain memory, changes of bytes or len then
+	// have to invalidate the domain memory cached by running methods (see call_context::getDomainMemory)
+	bool usedAsDomainMemory;
+	FORCE_INLINE void bufferChanged()
+	{
+		if (USUALLY_FALSE(usedAsDomainMemory))
+			invalidateDomainMemory();
+	}
+	void invalidateDomainMemory();
 	void compress_zlib(bool raw);
 	void uncompress_zlib(bool raw);
 	void compress_lzma();
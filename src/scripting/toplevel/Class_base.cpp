@@ -211,9 +211,11 @@ Type* Type::getTypeFromMultiname(multiname* mn, ABCContext* context, bool opport
 	return typeObject ? typeObject->as<Type>() : nullptr;
 }
 
+static ATOMIC_INT32(nextClassUniqueID);
+
 Class_base::Class_base(const QName& name, uint32_t _classID, MemoryAccount* m):ASObject(getSys()->worker,Class_object::getClass(getSys()),T_CLASS),protected_ns(getSys(),"",NAMESPACE),constructor(nullptr),
 	qualifiedClassnameID(UINT32_MAX),global(nullptr),
-	context(nullptr),class_name(name),memoryAccount(m),length(1),class_index(-1),isFinal(false),isSealed(false),isInterface(false),isReusable(false),use_protected(false),classID(_classID)
+	context(nullptr),class_name(name),memoryAccount(m),length(1),class_index(-1),isFinal(false),isSealed(false),isInterface(false),isReusable(false),use_protected(false),classID(_classID),uniqueID(ATOMIC_INCREMENT(nextClassUniqueID))
 {
 	setSystemState(getSys());
 	setRefConstant();
@@ -221,7 +223,7 @@ Class_base::Class_base(const QName& name, uint32_t _classID, MemoryAccount* m):A
 
 Class_base::Class_base(const Class_object* c):ASObject((MemoryAccount*)nullptr),protected_ns(getSys(),BUILTIN_STRINGS::EMPTY,NAMESPACE),constructor(nullptr),
 	qualifiedClassnameID(UINT32_MAX),global(nullptr),
-	context(nullptr),class_name(BUILTIN_STRINGS::STRING_CLASS,BUILTIN_STRINGS::EMPTY),memoryAccount(nullptr),length(1),class_index(-1),isFinal(false),isSealed(false),isInterface(false),isReusable(false),use_protected(false),classID(UINT32_MAX)
+	context(nullptr),class_name(BUILTIN_STRINGS::STRING_CLASS,BUILTIN_STRINGS::EMPTY),memoryAccount(nullptr),length(1),class_index(-1),isFinal(false),isSealed(false),isInterface(false),isReusable(false),use_protected(false),classID(UINT32_MAX),uniqueID(ATOMIC_INCREMENT(nextClassUniqueID))
 {
 	type=T_CLASS;
 	//We have tested that (Class is Class == true) so the classdef is 'this'
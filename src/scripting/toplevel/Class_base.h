@@ -189,6 +189,8 @@ private:
 	bool use_protected:1;
 public:
 	uint32_t classID;
+	// unique for every Class_base ever created, so a class allocated at the address of a freed one can be told apart
+	uint32_t uniqueID;
 	void addConstructorGetter();
 	void addPrototypeGetter();
 	void addLengthGetter();
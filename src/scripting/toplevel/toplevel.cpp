@@ -131,6 +131,27 @@ void dumpFunctionCallCount(bool builtinonly = false,uint32_t mincallcount=0, uin
 	}
 }
 #endif
+// (re)allocates the buffers of the call_context of a method, their sizes change when the method is preloaded
+static void initMethodCallContext(method_info* mi)
+{
+	delete[] mi->cc.locals;
+	delete[] mi->cc.stack;
+	delete[] mi->cc.scope_stack;
+	delete[] mi->cc.scope_stack_dynamic;
+	delete[] mi->cc.localslots;
+	mi->cc.exec_pos = mi->body->preloadedcode.data();
+	mi->cc.locals = new asAtom[mi->body->getReturnValuePos()+1+mi->body->localresultcount];
+	mi->cc.stack = new asAtom[mi->body->max_stack+1];
+	mi->cc.scope_stack = new asAtom[mi->body->max_scope_depth];
+	mi->cc.scope_stack_dynamic = new bool[mi->body->max_scope_depth];
+	mi->cc.max_stackp=mi->cc.stack+mi->cc.mi->body->max_stack;
+	mi->cc.lastlocal = mi->cc.locals+mi->cc.mi->body->getReturnValuePos()+1+mi->body->localresultcount;
+	mi->cc.localslots = new asAtom*[mi->body->localconstantslots.size()+mi->body->getReturnValuePos()+1+mi->body->localresultcount];
+	for (uint32_t i = 0; i < uint32_t(mi->body->getReturnValuePos()+1+mi->body->localresultcount); i++)
+	{
+		mi->cc.localslots[i] = &mi->cc.locals[i];
+	}
+}
 /**
  * This prepares a new call_context and then executes the ABC bytecode function
  * by ABCVm::executeFunction() or through JIT.
@@ -150,26 +171,44 @@ void SyntheticFunction::call(ASWorker* wrk,asAtom& ret, asAtom& obj, asAtom *arg
 	assert(wrk == getWorker());
 	auto prev_cur_recursion = wrk->cur_recursion;
 	call_context* saved_cc = wrk->incStack(obj,this->functionname);
-	if (codeStatus != method_body_info::PRELOADED && codeStatus != method_body_info::USED)
+	if (codeStatus == method_body_info::ORIGINAL && getSystemState()->useFastInterpreter && !mi->body->notOptimizable && mi->body->hit_count < getSystemState()->tierUpThreshold)
+	{
+		// first call of the method, it is executed by the fast interpreter until it gets hot, so that code that only runs once
+		// (script initialization, one-shot constructors) doesn't have to pay for preloading
+		mi->cc.sys = getSystemState();
+		mi->cc.worker=wrk;
+		mi->cc.exceptionthrown = nullptr;
+		try
+		{
+			ABCVm::optimizeFunction(this);
+			initMethodCallContext(mi);
+		}
+		catch(ParseException& e)
+		{
+			// the optimizer doesn't handle all instructions (e.g. alchemy opcodes), such methods are preloaded right away
+			LOG(LOG_INFO,"method can't be optimized, preloading it:"<<getSystemState()->getStringFromUniqueId(functionname)<<" "<<e.what());
+			mi->body->notOptimizable=true;
+			mi->body->optimizedcode.clear();
+			mi->body->optimizedexceptions.clear();
+			mi->body->codeStatus = method_body_info::ORIGINAL;
+		}
+	}
+	if (codeStatus != method_body_info::PRELOADED && codeStatus != method_body_info::USED
+			 && (codeStatus != method_body_info::OPTIMIZED || mi->body->hit_count >= getSystemState()->tierUpThreshold || mi->body->notOptimizable))
 	{
+		if (codeStatus == method_body_info::OPTIMIZED)
+		{
+			LOG_CALL("promoting method to preloaded code:"<<getSystemState()->getStringFromUniqueId(functionname)<<" "<<mi->body->hit_count);
+			mi->body->optimizedcode.clear();
+			mi->body->optimizedexceptions.clear();
+		}
 		mi->body->codeStatus = method_body_info::PRELOADING;
 		mi->cc.sys = getSystemState();
 		mi->cc.worker=wrk;
 		mi->cc.exceptionthrown = nullptr;
 		ABCVm::preloadFunction(this,wrk);
 		mi->body->codeStatus = method_body_info::PRELOADED;
-		mi->cc.exec_pos = mi->body->preloadedcode.data();
-		mi->cc.locals = new asAtom[mi->body->getReturnValuePos()+1+mi->body->localresultcount];
-		mi->cc.stack = new asAtom[mi->body->max_stack+1];
-		mi->cc.scope_stack = new asAtom[mi->body->max_scope_depth];
-		mi->cc.scope_stack_dynamic = new bool[mi->body->max_scope_depth];
-		mi->cc.max_stackp=mi->cc.stack+mi->cc.mi->body->max_stack;
-		mi->cc.lastlocal = mi->cc.locals+mi->cc.mi->body->getReturnValuePos()+1+mi->body->localresultcount;
-		mi->cc.localslots = new asAtom*[mi->body->localconstantslots.size()+mi->body->getReturnValuePos()+1+mi->body->localresultcount];
-		for (uint32_t i = 0; i < uint32_t(mi->body->getReturnValuePos()+1+mi->body->localresultcount); i++)
-		{
-			mi->cc.localslots[i] = &mi->cc.locals[i];
-		}
+		initMethodCallContext(mi);
 	}
 	if (saved_cc && saved_cc->exceptionthrown)
 	{
@@ -223,8 +262,10 @@ void SyntheticFunction::call(ASWorker* wrk,asAtom& ret, asAtom& obj, asAtom *arg
 		val=mi->synt_method(getSystemState());
 		assert(val);
 	}
-	++mi->body->hit_count;
 #endif
+	// preloaded methods keep counting their calls, the counts are stored in the method profile
+	if(codeStatus==method_body_info::PRELOADED && mi->body->hit_count < UINT16_MAX)
+		++mi->body->hit_count;
 
 	//Prepare arguments
 	uint32_t args_len=mi->numArgs();
@@ -381,10 +422,17 @@ void SyntheticFunction::call(ASWorker* wrk,asAtom& ret, asAtom& obj, asAtom *arg
 	{
 		if(!mi->body->exceptions.empty() || (val==nullptr && getSystemState()->useInterpreter))
 		{
-			if(codeStatus == method_body_info::OPTIMIZED && getSystemState()->useFastInterpreter)
+			if(!mi->body->optimizedcode.empty())
 			{
-				//This is a mildy hot function, execute it using the fast interpreter
-				ret=asAtomHandler::fromObject(ABCVm::executeFunctionFast(this,cc,asAtomHandler::toObject(obj,wrk)));
+				//This function is not hot yet, execute it using the fast interpreter
+				//Switch the codeStatus to USED, so that recursive calls use their own call_context and the method is not preloaded while being used
+				const method_body_info::CODE_STATUS oldCodeStatus = codeStatus;
+				mi->body->codeStatus = method_body_info::USED;
+				if (mi->body->hit_count < UINT16_MAX)
+					++mi->body->hit_count;
+				ASObject* res = ABCVm::executeFunctionFast(this,cc,asAtomHandler::toObject(obj,wrk));
+				cc->locals[mi->body->getReturnValuePos()] = res ? asAtomHandler::fromObject(res) : asAtomHandler::invalidAtom;
+				mi->body->codeStatus = oldCodeStatus;
 			}
 			else
 			{
@@ -435,9 +483,11 @@ void SyntheticFunction::call(ASWorker* wrk,asAtom& ret, asAtom& obj, asAtom *arg
 			bool no_handler = true;
 			LOG_CALL("got an " << excobj->toDebugString());
 			LOG_CALL("pos=" << pos);
-			for (unsigned int i=0;i<mi->body->exceptions.size();i++)
+			//The fast interpreter uses the exception ranges of the optimized code
+			std::vector<exception_info_abc>& exceptions = mi->body->optimizedcode.empty() ? mi->body->exceptions : mi->body->optimizedexceptions;
+			for (unsigned int i=0;i<exceptions.size();i++)
 			{
-				exception_info_abc& exc=mi->body->exceptions[i];
+				exception_info_abc& exc=exceptions[i];
 				if (pos < exc.from || pos > exc.to)
 					continue;
 				bool ok = false;
@@ -52,11 +52,13 @@
 #include "backends/audio.h"
 #include "backends/config.h"
 #include "backends/rendering.h"
+#include "backends/headlessrendering.h"
 #include "backends/cachedsurface.h"
 #include "backends/image.h"
 #include "backends/extscriptobject.h"
 #include "backends/input.h"
 #include "backends/locale.h"
+#include "backends/swfcache.h"
 #include "backends/currency.h"
 #include "memory_support.h"
 #include "parsing/tags.h"
@@ -102,6 +104,10 @@ ParseThread* lightspark::getParseThread()
 	assert(pt);
 	return pt;
 }
+void lightspark::setTLSParseThread(ParseThread* pt)
+{
+	tls_set(parse_thread_tls,pt);
+}
 
 DEFINE_AND_INITIALIZE_TLS(tls_worker);
 void lightspark::setTLSWorker(ASWorker* worker)
@@ -235,12 +241,12 @@ SystemState::SystemState
 	),
 	logger(_logger),
 	terminated(0),renderRate(0),error(false),shutdown(false),firsttick(true),localstorageallowed(false),influshing(false),inMouseEvent(false),inWindowMove(false),hasExitCode(false),innerGotoCount(0),
-	renderThread(nullptr),inputThread(nullptr),engineData(nullptr),dumpedSWFPathAvailable(0),
+	renderThread(nullptr),headlessRenderer(nullptr),rasterCache(nullptr),inputThread(nullptr),engineData(nullptr),dumpedSWFPathAvailable(0),
 	vmVersion(VMNONE),childPid(0),
 	parameters(NullRef),
 	invalidateQueueHead(NullRef),invalidateQueueTail(NullRef),lastUsedStringId(0),lastUsedNamespaceId(0x7fffffff),framePhase(FramePhase::IDLE),
-	showProfilingData(false),allowFullscreen(false),flashMode(mode),swffilesize(fileSize),instanceCounter(0),avm1global(nullptr),
-	currentVm(nullptr),builtinClasses(nullptr),useInterpreter(true),useFastInterpreter(false),useJit(false),ignoreUnhandledExceptions(false),runSingleThreaded(_runSingleThreaded),exitOnError(ERROR_NONE),
+	showProfilingData(false),showDamagedRegions(false),allowFullscreen(false),flashMode(mode),swffilesize(fileSize),instanceCounter(0),eagerBitmapDecodeMemory(0),domainMemoryGeneration(0),avm1global(nullptr),
+	currentVm(nullptr),builtinClasses(nullptr),useInterpreter(true),useFastInterpreter(false),tierUpThreshold(10),headlessFrameLimit(0),headlessFastForward(false),useJit(false),ignoreUnhandledExceptions(false),runSingleThreaded(_runSingleThreaded),exitOnError(ERROR_NONE),
 	systemDomain(nullptr),worker(nullptr),workerDomain(nullptr),singleworker(true),
 	downloadManager(nullptr),extScriptObject(nullptr),scaleMode(SHOW_ALL),unaccountedMemory(nullptr),tagsMemory(nullptr),stringMemory(nullptr),textTokenMemory(nullptr),shapeTokenMemory(nullptr),morphShapeTokenMemory(nullptr),bitmapTokenMemory(nullptr),spriteTokenMemory(nullptr),
 	static_SoundMixer_bufferTime(0),
@@ -354,6 +360,7 @@ SystemState::SystemState
 	threads = std::min(size_t(NUM_THREADS), threads);
 	threadPool=new ThreadPool(this, threads);
 	downloadThreadPool=new ThreadPool(this, threads);
+	rasterCache=new RasterCache(RASTERCACHE_MEMORY_BUDGET);
 
 	if (eventLoop == nullptr || !eventLoop->timersInEventLoop())
 	{
@@ -806,6 +813,10 @@ void SystemState::destroy()
 	
 	delete renderThread;
 	renderThread=nullptr;
+	delete headlessRenderer;
+	headlessRenderer=nullptr;
+	delete rasterCache;
+	rasterCache=nullptr;
 	delete inputThread;
 	inputThread=nullptr;
 	if (engineData != nullptr)
@@ -1003,7 +1014,13 @@ void SystemState::delayedCreation(SystemState* sys)
 			//This just signals the 'initalized' semaphore
 			sys->renderThread->forceInitialization();
 		}
-		LOG(LOG_INFO,"Rendering is disabled by configuration");
+		if (!sys->headlessOutputDirectory.empty())
+		{
+			sys->headlessRenderer = new HeadlessRenderer(sys,sys->headlessOutputDirectory,sys->headlessFrameLimit,sys->headlessFastForward,reqWidth,reqHeight);
+			LOG(LOG_INFO,"Rendering headless to " << sys->headlessOutputDirectory);
+		}
+		else
+			LOG(LOG_INFO,"Rendering is disabled by configuration");
 	}
 
 	if(sys->getRenderThread() && sys->renderRate)
@@ -1282,7 +1299,8 @@ void SystemState::setRenderRate(float rate)
 	{
 		renderRate=rate;
 		startRenderTicks();
-		if (this->mainClip && this->mainClip->isConstructed())
+		// when fast forwarding headless the frames are not ticked at the frame rate
+		if (this->mainClip && this->mainClip->isConstructed() && !headlessFastForward)
 		{
 			removeJob(this);
 			addFrameTick(this);
@@ -1317,6 +1335,12 @@ void SystemState::addFrameTick(uint32_t tickTime, ITickJob* job)
 
 void SystemState::addFrameTick(ITickJob* job)
 {
+	if (job == this && headlessFastForward)
+	{
+		// only the first frame is scheduled here, every following frame is scheduled by HeadlessRenderer::renderFrame()
+		addWait(0,job);
+		return;
+	}
 	// TODO: Use LSTimers in `TimerThread`.
 	if (timerThread != nullptr)
 		timerThread->addTick(1000/mainClip->applicationDomain->getFrameRate(),job);
@@ -1432,7 +1456,8 @@ void SystemState::flushInvalidationQueue()
 				if (EngineData::enablerendering && (drawobj->getNeedsTextureRecalculation() || !d->isCachedSurfaceUsable(drawobj.getPtr())))
 				{
 					drawjobLock.lock();
-					AsyncDrawJob* j = new AsyncDrawJob(d,drawobj);
+					AsyncDrawJob* j = new AsyncDrawJob(d,drawobj,true);
+					j->priority=getDrawJobPriority(drawobj.getPtr());
 					if (!drawobj->getTextureRecalculationSkippable())
 					{
 						for (auto it = drawJobsPending.begin(); it != drawJobsPending.end(); it++)
@@ -1460,6 +1485,8 @@ void SystemState::flushInvalidationQueue()
 					addJob(j);
 					drawjobLock.unlock();
 				}
+				else if (headlessRenderer != nullptr)
+					headlessRenderer->refreshSurface(d,drawobj);
 				else if (renderThread != nullptr)
 					renderThread->addRefreshableSurface(d,drawobj);
 				if (renderThread != nullptr && renderThread->isStarted())
@@ -1477,6 +1504,31 @@ void SystemState::flushInvalidationQueue()
 	invalidateQueueHead=NullRef;
 	invalidateQueueTail=NullRef;
 }
+uint32_t SystemState::getDrawJobPriority(DisplayObject* o)
+{
+	// objects that are visible on screen are rasterized first, so they are ready for the next frame
+	if (!o->isOnStage() || !o->isVisible())
+		return o->isMask() ? DRAWJOB_PRIORITY_MASK : DRAWJOB_PRIORITY_OFFSCREEN;
+	number_t bxmin,bxmax,bymin,bymax;
+	if (!o->boundsRectWithoutChildren(bxmin,bxmax,bymin,bymax,false))
+		return DRAWJOB_PRIORITY_OFFSCREEN;
+	// map all four corners to stage coordinates, the matrix may contain a rotation
+	MATRIX m = o->getConcatenatedMatrix(true,false);
+	number_t xmin=INFINITY,xmax=-INFINITY,ymin=INFINITY,ymax=-INFINITY;
+	const number_t corners[4][2] = {{bxmin,bymin},{bxmax,bymin},{bxmin,bymax},{bxmax,bymax}};
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		number_t x,y;
+		m.multiply2D(corners[i][0],corners[i][1],x,y);
+		xmin=dmin(xmin,x);
+		xmax=dmax(xmax,x);
+		ymin=dmin(ymin,y);
+		ymax=dmax(ymax,y);
+	}
+	if (xmax < 0 || ymax < 0 || xmin > stage->internalGetWidth() || ymin > stage->internalGetHeight())
+		return DRAWJOB_PRIORITY_OFFSCREEN;
+	return DRAWJOB_PRIORITY_VISIBLE;
+}
 void SystemState::AsyncDrawJobCompleted(AsyncDrawJob *j)
 {
 	drawjobLock.lock();
@@ -1620,7 +1672,7 @@ void ThreadProfile::plot(uint32_t maxTime, cairo_t *cr)
 ParseThread::ParseThread(istream& in, _R<ApplicationDomain> appDomain, _R<SecurityDomain> secDomain, Loader *_loader, tiny_string srcurl)
   : version(0),applicationDomain(appDomain),securityDomain(secDomain),
     f(in),uncompressingFilter(nullptr),backend(nullptr),bytearraybuf(nullptr),loader(_loader),
-    parsedObject(NullRef),url(srcurl),fileType(FT_UNKNOWN)
+    parsedObject(NullRef),url(srcurl),fileType(FT_UNKNOWN),contentPublished(false)
 {
 	f.exceptions ( istream::eofbit | istream::failbit | istream::badbit );
 }
@@ -1628,7 +1680,7 @@ ParseThread::ParseThread(istream& in, _R<ApplicationDomain> appDomain, _R<Securi
 ParseThread::ParseThread(std::istream& in, RootMovieClip *root)
   : version(0),applicationDomain(NullRef),securityDomain(NullRef), //The domains are not needed since the system state create them itself
     f(in),uncompressingFilter(nullptr),backend(nullptr),bytearraybuf(nullptr),loader(nullptr),
-    parsedObject(NullRef),url(),fileType(FT_UNKNOWN)
+    parsedObject(NullRef),url(),fileType(FT_UNKNOWN),contentPublished(false)
 {
 	f.exceptions ( istream::eofbit | istream::failbit | istream::badbit );
 	setRootMovie(root);
@@ -1688,7 +1740,26 @@ void ParseThread::parseSWFHeader(RootMovieClip *root, UI8 ver)
 	{
 		//The file is compressed, create a filtering streambuf
 		backend=f.rdbuf();
-		if(fileType==FT_COMPRESSED_SWF)
+		// a mapped local file may have been decompressed on a previous launch
+		MappedFileReader* mappedReader = SWFCache::isEnabled() ? dynamic_cast<MappedFileReader*>(backend) : nullptr;
+		_NR<MappedFile> cached;
+		if (mappedReader && mappedReader->isWholeFile() && mappedReader->pubseekoff(0, ios_base::cur, ios_base::in)==8)
+		{
+			std::string path = SWFCache::getEntryPath(mappedReader->getFile().getPtr());
+			cached = SWFCache::lookup(mappedReader->getFile(),path);
+			if (cached.isNull())
+				SWFCache::store(root->getSystemState(),mappedReader->getFile(),fileType,path);
+			else
+				SWFCache::verify(root->getSystemState(),mappedReader->getFile(),path);
+		}
+		if(!cached.isNull())
+		{
+			LOG(LOG_INFO, "cached compressed SWF file: Version " << (int)version);
+			// the entry starts with the header, so the stream positions are the same as with the uncompressing filter
+			uncompressingFilter = new MappedFileReader(cached);
+			uncompressingFilter->pubseekpos(8, ios_base::in);
+		}
+		else if(fileType==FT_COMPRESSED_SWF)
 		{
 			LOG(LOG_INFO, "zlib compressed SWF file: Version " << (int)version);
 			uncompressingFilter = new zlib_filter(backend);
@@ -1854,7 +1925,9 @@ void ParseThread::parseSWF(UI8 ver)
 			}
 		}
 
-		TagFactory factory(f);
+		// shapes and sounds are constructed in the ThreadPool while the file is read
+		ParseTagPipeline pipeline(this,root);
+		TagFactory factory(f,root->getSystemState()->runSingleThreaded ? nullptr : &pipeline);
 		Tag* tag=factory.readTag(root);
 
 		if (root->applicationDomain->version >= 8)
@@ -1905,6 +1978,7 @@ void ParseThread::parseSWF(UI8 ver)
 			{
 				case END_TAG:
 				{
+					pipeline.collect(true);
 					// The whole frame has been parsed, now execute all queued tags,
 					// in the order in which they appeared in the file.
 					while(!queuedTags.empty())
@@ -1929,6 +2003,9 @@ void ParseThread::parseSWF(UI8 ver)
 				case DICT_TAG:
 				{
 					DictionaryTag* d=static_cast<DictionaryTag*>(tag);
+					// a redefined id has to be added to the dictionary after the previous definition
+					if (pipeline.isPending(d->getId()))
+						pipeline.collect(true);
 					root->applicationDomain->addToDictionary(d);
 					break;
 				}
@@ -1958,6 +2035,13 @@ void ParseThread::parseSWF(UI8 ver)
 					}
 
 					root->commitFrame(true);
+					if (contentPublished)
+					{
+						// bind the classes of this frame
+						getVm(root->getSystemState())->addEvent(NullRef, _MR(new (root->getSystemState()->unaccountedMemory) FlushEventBufferEvent(false,true)));
+					}
+					else if (loader && root != root->getSystemState()->mainClip && root->getFramesLoaded()==1)
+						publishContent(root);
 					empty=true;
 					delete tag;
 					break;
@@ -2035,7 +2119,10 @@ void ParseThread::parseSWF(UI8 ver)
 				}
 			}// end switch
 			if(root->getSystemState()->shouldTerminate() || threadAborting)
+			{
+				abortLoading(root);
 				break;
+			}
 
 			if (!done)
 				tag=factory.readTag(root);
@@ -2044,6 +2131,7 @@ void ParseThread::parseSWF(UI8 ver)
 	catch(std::exception& e)
 	{
 		root->parsingFailed();
+		abortLoading(root);
 		throw;
 	}
 	if (lasttagtype != END_TAG || root->loaderInfo->getBytesLoaded() != root->loaderInfo->getBytesTotal())
@@ -2054,6 +2142,9 @@ void ParseThread::parseSWF(UI8 ver)
 		// We just set bytesLoaded "manually" to ensure the "complete" event is dispatched
 		root->loaderInfo->setBytesLoaded(root->loaderInfo->getBytesTotal());
 	}
+	// no more frames will be parsed, "complete" is held back until now
+	RELEASE_WRITE(root->finishedLoading,true);
+	root->loaderInfo->setContentParsed();
 	root->markSoundFinished();
 	LOG(LOG_TRACE,"End of parsing");
 }
@@ -2155,6 +2246,25 @@ void ParseThread::parseExtensions(RootMovieClip* root)
 	}
 }
 
+/* Sets the clip as content of the loader as soon as its first frame is available,
+ * the remaining frames are parsed while the content is already running */
+void ParseThread::publishContent(RootMovieClip* root)
+{
+	contentPublished=true;
+	root->AVM1setLevel(loader->AVM1getLevel());
+	root->incRef();
+	loader->incRef();
+	getVm(root->getSystemState())->addBufferEvent(NullRef,_MR(new (root->getSystemState()->unaccountedMemory) SetLoaderContentEvent(_MR(root), _MR(loader))));
+	getVm(root->getSystemState())->addEvent(NullRef, _MR(new (root->getSystemState()->unaccountedMemory) FlushEventBufferEvent(false,true)));
+}
+
+void ParseThread::abortLoading(RootMovieClip* root)
+{
+	// a published clip must not wait for frames that will never be parsed
+	if (contentPublished)
+		RELEASE_WRITE(root->finishedLoading,true);
+}
+
 void ParseThread::parseBitmap()
 {
 	LoaderInfo* li=loader->getContentLoaderInfo();
@@ -59,6 +59,7 @@ class DictionaryTag;
 class DefineScalingGridTag;
 class EventLoop;
 class ExtScriptObject;
+class HeadlessRenderer;
 class InputThread;
 class IntervalManager;
 class ParseThread;
@@ -149,6 +150,8 @@ private:
 	int innerGotoCount;
 	int exitCode;
 	RenderThread* renderThread;
+	HeadlessRenderer* headlessRenderer;
+	RasterCache* rasterCache;
 	InputThread* inputThread;
 	EngineData* engineData;
 	void startRenderTicks();
@@ -264,6 +267,7 @@ public:
 
 	//Interative analysis flags
 	bool showProfilingData;
+	bool showDamagedRegions;
 	bool standalone;
 	bool allowFullscreen;
 	bool allowFullscreenInteractive;
@@ -273,6 +277,11 @@ public:
 	uint32_t swffilesize;
 	asAtom nanAtom;
 	ATOMIC_INT32(instanceCounter); // used to create unique instanceX names for AVM1
+	ATOMIC_INT32(eagerBitmapDecodeMemory); // bytes of bitmap tags decoded in advance by BitmapDecodeJobs, released when their BitmapTagPayload is destroyed
+	// incremented when the domain memory of an ApplicationDomain is reassigned or changes its buffer,
+	// call_contexts compare it to the generation of their cached domain memory buffer and length
+	ACQUIRE_RELEASE_VARIABLE(uint32_t, domainMemoryGeneration);
+	void invalidateDomainMemory() { domainMemoryGeneration.fetch_add(1,std::memory_order_release); }
 	// the global object for AVM1
 	Global* avm1global;
 	void setupAVM1();
@@ -321,6 +330,8 @@ public:
 	void tickFence() override;
 
 	RenderThread* getRenderThread() const { return renderThread; }
+	HeadlessRenderer* getHeadlessRenderer() const { return headlessRenderer; }
+	RasterCache* getRasterCache() const { return rasterCache; }
 	InputThread* getInputThread() const { return inputThread; }
 	void setParamsAndEngine(EngineData* e, bool s) DLL_PUBLIC;
 	void setDownloadedPath(const tiny_string& p) DLL_PUBLIC;
@@ -410,6 +421,17 @@ public:
 	//Flags for command line options
 	bool useInterpreter;
 	bool useFastInterpreter;
+	// number of calls after which a method is moved from the fast interpreter to the preloaded interpreter
+	uint16_t tierUpThreshold;
+	// directory for the method profiles (hit counts used to warm up the tiering) of the ABC contexts, empty if profiles are disabled
+	// the profiles only have an effect with the fast interpreter, the preloaded code is not stored
+	tiny_string abcProfileDirectory;
+	// directory the frames are written to when rendering headless, empty if headless rendering is disabled
+	tiny_string headlessOutputDirectory;
+	// number of frames to render headless before shutting down, 0 means no limit
+	uint32_t headlessFrameLimit;
+	// when rendering headless, the next frame is started as soon as the previous one is written instead of at the frame rate
+	bool headlessFastForward;
 	bool useJit;
 	bool ignoreUnhandledExceptions;
 	bool runSingleThreaded;
@@ -491,6 +513,8 @@ public:
 	void addToInvalidateQueue(_R<DisplayObject> d) override;
 	void flushInvalidationQueue();
 	void AsyncDrawJobCompleted(AsyncDrawJob* j);
+	// priority of the draw job for the DisplayObject, objects visible on screen get the highest priority
+	uint32_t getDrawJobPriority(DisplayObject* o);
 	void swapAsyncDrawJobQueue();
 
 	//Resize support
@@ -601,10 +625,13 @@ public:
 	_NR<SecurityDomain> securityDomain;
 	void getSWFByteArray(ByteArray* ba);
 	void addExtensions(std::vector<tiny_string>& ext) { extensions = ext; }
+	// true if the parsed clip has been set as content of the loader before parsing finished
+	bool hasPublishedContent() const { return contentPublished; }
 private:
 	std::vector<tiny_string> extensions;
 	std::istream& f;
-	uncompressing_filter* uncompressingFilter;
+	// the uncompressing filter, or the reader of the decompressed file from the SWFCache
+	std::streambuf* uncompressingFilter;
 	std::streambuf* backend;
 	std::streambuf* bytearraybuf;
 	Loader *loader;
@@ -612,6 +639,7 @@ private:
 	Mutex objectSpinlock;
 	tiny_string url;
 	FILE_TYPE fileType;
+	bool contentPublished;
 	void threadAbort() override;
 	void jobFence() override {}
 	void parseSWFHeader(RootMovieClip *root, UI8 ver);
@@ -619,6 +647,8 @@ private:
 	void parseBitmap();
 	void setRootMovie(RootMovieClip *root);
 	void parseExtensions(RootMovieClip* root);
+	void publishContent(RootMovieClip* root);
+	void abortLoading(RootMovieClip* root);
 };
 
 // Returns true if we're currently running in the main thread.
@@ -630,6 +660,8 @@ SystemState* getSys() DLL_PUBLIC;
 void setTLSSys(SystemState* sys) DLL_PUBLIC;
 
 ParseThread* getParseThread();
+/* Set thread-specific ParseThread to be returned by getParseThread() */
+void setTLSParseThread(ParseThread* pt);
 /* Returns the thread-specific SystemState */
 ASWorker* getWorker() DLL_PUBLIC;
 void setTLSWorker(ASWorker* worker) DLL_PUBLIC;
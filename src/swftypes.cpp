@@ -949,7 +949,11 @@ std::istream& lightspark::operator>>(std::istream& s, FILLSTYLE& v)
 					//throw ParseException("Invalid ID for bitmap");
 				}
 				else
-					v.bitmap = b->getBitmap();
+				{
+					// the bitmap is decoded when the fill is rendered
+					v.bitmapPayload = b->getPayload();
+					v.bitmap = v.bitmapPayload->bitmap;
+				}
 			}
 			catch(RunTimeException& e)
 			{
@@ -1766,7 +1770,7 @@ FILLSTYLE::FILLSTYLE(uint8_t v):Gradient(v,false),FillStyleType(SOLID_FILL),vers
 }
 
 FILLSTYLE::FILLSTYLE(const FILLSTYLE& r):Matrix(r.Matrix),
-	Gradient(r.Gradient),bitmap(r.bitmap),ShapeBounds(r.ShapeBounds),Color(r.Color),FillStyleType(r.FillStyleType),version(r.version)
+	Gradient(r.Gradient),bitmap(r.bitmap),bitmapPayload(r.bitmapPayload),ShapeBounds(r.ShapeBounds),Color(r.Color),FillStyleType(r.FillStyleType),version(r.version)
 {
 }
 
@@ -1774,11 +1778,18 @@ FILLSTYLE::~FILLSTYLE()
 {
 }
 
+void FILLSTYLE::decodeBitmap() const
+{
+	if (!bitmapPayload.isNull())
+		bitmapPayload->decode();
+}
+
 FILLSTYLE& FILLSTYLE::operator=(const FILLSTYLE& r)
 {
 	Matrix = r.Matrix;
 	Gradient = r.Gradient;
 	bitmap = r.bitmap;
+	bitmapPayload = r.bitmapPayload;
 	ShapeBounds = r.ShapeBounds;
 	Color = r.Color;
 	FillStyleType = r.FillStyleType;
@@ -26,6 +26,7 @@
 #include <map>
 #include <stack>
 #include <list>
+#include <unordered_map>
 #include <cairo.h>
 
 #include "forwards/swftypes.h"
@@ -107,7 +108,7 @@ enum VERTEXBUFFER_FORMAT { BYTES_4=0, FLOAT_1, FLOAT_2, FLOAT_3, FLOAT_4 };
 enum CLEARMASK { COLOR = 0x1, DEPTH = 0x2, STENCIL = 0x4 };
 enum TEXTUREFORMAT { BGRA, BGRA_PACKED, BGR_PACKED, COMPRESSED, COMPRESSED_ALPHA, RGBA_HALF_FLOAT,BGR };
 enum TEXTUREFORMAT_COMPRESSED { UNCOMPRESSED, DXT5, DXT1 };
-enum SAMPLEPOSITION { SAMPLEPOS_STANDARD=0,SAMPLEPOS_BLEND=1,SAMPLEPOS_FILTER=2,SAMPLEPOS_FILTER_DST=3 };
+enum SAMPLEPOSITION { SAMPLEPOS_STANDARD=0,SAMPLEPOS_BLEND=1,SAMPLEPOS_FILTER=2,SAMPLEPOS_FILTER_DST=3,SAMPLEPOS_FILTER_MAP=4 };
 
 // Enum used during early binding in abc_optimizer.cpp
 enum EARLY_BIND_STATUS { NOT_BINDED=0, CANNOT_BIND=1, BINDED };
@@ -1057,6 +1058,7 @@ enum FILL_STYLE_TYPE { SOLID_FILL=0x00, LINEAR_GRADIENT=0x10, RADIAL_GRADIENT=0x
 			CLIPPED_BITMAP=0x41, NON_SMOOTHED_REPEATING_BITMAP=0x42, NON_SMOOTHED_CLIPPED_BITMAP=0x43};
 
 class BitmapContainer;
+class BitmapTagPayload;
 
 class FILLSTYLE
 {
@@ -1069,10 +1071,14 @@ public:
 	MATRIX Matrix;
 	GRADIENT Gradient;
 	_NR<BitmapContainer> bitmap;
+	// set for bitmap fills of swf shapes, the bitmap is only decoded when the fill is used
+	_NR<BitmapTagPayload> bitmapPayload;
 	RECT ShapeBounds;
 	RGBA Color;
 	FILL_STYLE_TYPE FillStyleType;
 	uint8_t version;
+	// has to be called before the bitmap of the fill is tessellated or rendered
+	void decodeBitmap() const;
 };
 
 class MORPHFILLSTYLE:public FILLSTYLE
@@ -1540,6 +1546,90 @@ public:
 
 class AdditionalDataTag;
 class ACTIONRECORD;
+
+// value of an ActionPush record, already decoded from the action bytes
+struct AVM1PushValue
+{
+	number_t number; // types 1 (float) and 6 (double)
+	uint32_t value; // string id, register number, boolean, integer or constant pool index
+	uint8_t type;
+};
+// pre-decoded AVM1 action
+struct AVM1Action
+{
+	uint32_t pos; // byte position of the action in the action list
+	uint32_t next; // index of the following action
+	uint32_t target; // resolved jump target/end of ActionWith block (action index)
+	uint32_t data; // opcode specific operand or index into the operand tables of AVM1DecodedActions
+	uint32_t data2; // opcode specific operand or number of entries in the operand tables
+	uint8_t opcode;
+};
+struct AVM1TryBlock
+{
+	uint32_t nameID; // lowercase name of the catch variable, BUILTIN_STRINGS::EMPTY if the exception is stored in a register
+	uint32_t startpos; // byte position of the first action of the try block
+	uint32_t catchindex; // index of the first action of the catch block
+	uint32_t endindex; // index of the first action after the catch block
+	uint16_t trysize;
+	uint16_t catchsize;
+	uint16_t finallysize;
+	uint8_t reg;
+	tiny_string name;
+};
+struct AVM1FunctionDefinition
+{
+	tiny_string name;
+	std::vector<uint32_t> paramnames;
+	std::vector<uint8_t> registernumbers;
+	uint8_t flags1; // only used for ActionDefineFunction2
+	uint8_t flags2;
+	bool isDefineFunction2;
+	_NR<AVM1DecodedActions> body;
+};
+/*
+ * Compact representation of an action list, built once by ACTIONRECORD::decodeActions
+ * and used by the interpreter instead of re-reading the action bytes on every execution.
+ * Index 0 is always the end of the action list.
+ */
+class AVM1DecodedActions: public RefCountable
+{
+public:
+	static const uint32_t END_INDEX=0;
+	std::vector<AVM1Action> actions;
+	std::vector<AVM1PushValue> pushvalues;
+	std::vector<uint32_t> stringids; // constant pool entries
+	std::vector<tiny_string> strings; // string operands (urls, labels, targets)
+	std::vector<AVM1TryBlock> tryblocks;
+	std::vector<AVM1FunctionDefinition> functions;
+	std::unordered_map<uint32_t,uint32_t> positions; // byte position -> action index
+	uint32_t registercount=0; // number of registers needed to execute the actions
+	uint32_t getIndex(uint32_t pos) const
+	{
+		auto it = positions.find(pos);
+		return it == positions.end() ? END_INDEX : it->second;
+	}
+};
+// raw bytes of an action list and its decoded representation
+class AVM1ActionList
+{
+private:
+	std::vector<uint8_t> bytes;
+	mutable _NR<AVM1DecodedActions> decoded;
+public:
+	AVM1ActionList() {}
+	AVM1ActionList(_NR<AVM1DecodedActions> d):decoded(d) {}
+	void resize(size_t size, uint8_t value=0)
+	{
+		bytes.resize(size,value);
+		decoded.reset();
+	}
+	uint8_t* data() { return bytes.data(); }
+	const uint8_t* data() const { return bytes.data(); }
+	size_t size() const { return bytes.size(); }
+	bool empty() const { return bytes.empty() && decoded.isNull(); }
+	// returns the decoded actions, the action list is decoded on first use
+	AVM1DecodedActions* getDecoded(SystemState* sys, uint32_t startactionpos) const;
+};
 class CLIPACTIONRECORD
 {
 public:
@@ -1547,7 +1637,7 @@ public:
 	CLIPEVENTFLAGS EventFlags;
 	UI32_SWF ActionRecordSize;
 	UI8 KeyCode;
-	std::vector<uint8_t> actions;
+	AVM1ActionList actions;
 	bool isLast();
 	uint32_t startactionpos;
 	uint32_t dataskipbytes;
@@ -1609,13 +1699,15 @@ public:
 	}
 };
 class Activation_object;
+class AVM1Stack;
 class ACTIONRECORD
 {
 public:
-	static void PushStack(std::stack<asAtom>& stack,const asAtom& a);
-	static asAtom PopStack(std::stack<asAtom>& stack);
-	static asAtom PeekStack(std::stack<asAtom>& stack);
-	static void executeActions(DisplayObject* clip, AVM1context* context, const std::vector<uint8_t> &actionlist, uint32_t startactionpos, std::map<uint32_t, asAtom> &scopevariables, bool fromInitAction = false, asAtom *result = nullptr, asAtom* obj = nullptr, asAtom *args = nullptr, uint32_t num_args=0, const std::vector<uint32_t>& paramnames=std::vector<uint32_t>(), const std::vector<uint8_t>& paramregisternumbers=std::vector<uint8_t>(),
+	static void PushStack(AVM1Stack& stack,const asAtom& a);
+	static asAtom PopStack(AVM1Stack& stack);
+	static asAtom PeekStack(AVM1Stack& stack);
+	static AVM1DecodedActions* decodeActions(SystemState* sys, const uint8_t* data, uint32_t size, uint32_t startactionpos, AVM1DecodedActions* decoded=nullptr);
+	static void executeActions(DisplayObject* clip, AVM1context* context, const AVM1ActionList &actionlist, uint32_t startactionpos, std::map<uint32_t, asAtom> &scopevariables, bool fromInitAction = false, asAtom *result = nullptr, asAtom* obj = nullptr, asAtom *args = nullptr, uint32_t num_args=0, const std::vector<uint32_t>& paramnames=std::vector<uint32_t>(), const std::vector<uint8_t>& paramregisternumbers=std::vector<uint8_t>(),
 			bool preloadParent=false, bool preloadRoot=false, bool suppressSuper=true, bool preloadSuper=false, bool suppressArguments=false, bool preloadArguments=false, bool suppressThis=true, bool preloadThis=false, bool preloadGlobal=false, AVM1Function *caller = nullptr, AVM1Function *callee = nullptr, Activation_object *actobj=nullptr, asAtom* superobj=nullptr);
 };
 class BUTTONCONDACTION
@@ -1638,7 +1730,7 @@ public:
 	bool CondOverDownToIdle:1;
 	uint32_t CondKeyPress;
 	uint32_t startactionpos;
-	std::vector<uint8_t> actions;
+	AVM1ActionList actions;
 };
 class ASWorker;
 ASObject* abstract_i(ASWorker* wrk, int32_t i);
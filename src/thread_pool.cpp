@@ -174,7 +174,10 @@ void ThreadPool::addJob(IThreadJob* j)
 	}
 	else
 	{
-		jobs.push_back(j);
+		auto it = jobs.end();
+		while (it != jobs.begin() && (*(it-1))->priority < j->priority)
+			--it;
+		jobs.insert(it,j);
 		num_jobs.signal();
 	}
 }